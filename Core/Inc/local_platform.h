@@ -61,13 +61,24 @@ void SetTimeInterrupt(FSC_U32 microseconds);
  */
 void ClearTimeInterrupt();
 
-/* GetCurrentTime
+/* TickTimerIRQHandler
  *
  * Arguments:   None
- * Return:      Current time
- * Description: Return Timer2's current CNT value. 32-bits, 1us resolution.
+ * Return:      None
+ * Description: Extends Timer2 to the 64-bit microsecond clock on overflow.
+ *              Called from TIM2_IRQHandler ahead of the HAL handler - an
+ *              overflow the HAL handler clears is counted by
+ *              HAL_TIM_PeriodElapsedCallback.
+ */
+void TickTimerIRQHandler(void);
+
+/* DeadlineTimerIRQ
+ *
+ * Arguments:   None
+ * Return:      TRUE if the deadline compare (Timer2 channel 2) has fired
+ * Description: Clears the compare flag - the caller runs DeadlineService.
  */
-FSC_U32 platform_GetCurrentTime(void);
+FSC_BOOL DeadlineTimerIRQ(void);
 
 /* Delay
  *
@@ -77,41 +88,168 @@ FSC_U32 platform_GetCurrentTime(void);
  */
 void platform_Delay(FSC_U32 microseconds);
 
-/* EnableTSTimer
+/* Ports on the board - the board table in platform.c lists each of them */
+#ifdef FSC_HAVE_MULTIPORT
+#define BOARD_PORT_COUNT    3
+#else
+#define BOARD_PORT_COUNT    1
+#endif /* FSC_HAVE_MULTIPORT */
+
+/* platform_GetPortCount
  *
- * Arguments:   enable: True - on
- * Return:      None
- * Description: Enable or disable the timers (1,3) used for time stamps.
+ * Arguments:   None
+ * Return:      Number of TCPCs described by the board table
+ * Description: Ports 1..count are configured and scheduled at boot.
  */
-void EnableTSTimer(FSC_BOOL enable);
+FSC_U8 platform_GetPortCount(void);
 
-/* GetTimeStamp
+/* platform_GetPortConfig
  *
- * Arguments:   None
- * Return:      Current time stamp time as 0xSSSSMMMM
- *              SSSS: Seconds, MMMM: milliseconds
- * Description: Return a time stamp based on Timer1 (0.1ms) and Timer3 (sec)
+ * Arguments:   port: Port ID (1 based)
+ *              bus, i2c_addr: Receive the board's I2C bus and address
+ * Return:      FALSE if the board has no such port
+ * Description: Look up a port's TCPC in the board description.
  */
-FSC_U32 platform_GetTimeStamp(void);
+FSC_BOOL platform_GetPortConfig(FSC_U8 port, FSC_U8 *bus, FSC_U8 *i2c_addr);
+
+/* platform_GetAlertLine
+ *
+ * Arguments:   pin: GPIO pin mask passed to HAL_GPIO_EXTI_Callback
+ * Return:      ALERT line ID (see platform_get_alert_line), or 0 if none
+ * Description: Constant time pin to ALERT line mapping for the EXTI handlers.
+ */
+FSC_U8 platform_GetAlertLine(FSC_U16 pin);
+
+/* Services every pending ALERT line - called from the EXTI vectors */
+void AlertIRQHandler(void);
 
 /* platform_printf
  *
- * Arguments:   Port number (1-3)
+ * Arguments:   Port number (1 based)
  *              Character message (null or \n terminated)
  *              Optional numeric value (displayed as 4-byte hex value).
  * Return:      None
  * Description: A simplified printf function.
- *              Prints a timestamp, port number, message, and optional value
+ *              Prints a timestamp (seconds.microseconds since boot), port
+ *              number, message, and optional value
  */
 void platform_printf(FSC_U8 port, const char *msg, FSC_S32 value);
 
+/* platform_printbytes
+ *
+ * Arguments:   Port number (1 based)
+ *              Character message (null or \n terminated)
+ *              Bytes to display and their count
+ * Return:      None
+ * Description: As platform_printf, followed by the bytes as space
+ *              separated hex pairs.
+ */
+void platform_printbytes(FSC_U8 port, const char *msg,
+                         const FSC_U8 *bytes, FSC_U32 length);
+
 /* Write one character at a time to the UART */
 void WriteUART(FSC_S8 c);
 
 /* Flush the UART buffers using DMA memory transfers */
 void ProcessUART(void);
 
+/* DMA transfer complete and receive interrupt service - from the vectors */
+void UARTTxIRQHandler(void);
+void UARTRxIRQHandler(void);
+
 void platform_SetDebugPin(FSC_BOOL enable);
 
+#ifdef FSC_HAVE_LOWPOWER
+/* Tickless idle residency and wake-up statistics.
+ * Average supply current is StopTimeMs/RunTimeMs weighted by the measured
+ * STOP2 and run mode currents of the board.
+ */
+typedef struct {
+  FSC_U32 StopCount;        /* Number of STOP2 entries */
+  FSC_U32 WakeOnTimer;      /* Woken by the LPTIM deadline */
+  FSC_U32 WakeOnAlert;      /* Woken by an ALERT EXTI (or other IRQ) */
+  FSC_U32 StopTimeMs;       /* Total time spent in STOP2 */
+  FSC_U32 RunTimeMs;        /* Total time spent running */
+  FSC_U32 LastWakeLatency;  /* us from wake-up to clocks restored */
+  FSC_U32 MaxWakeLatency;   /* us, worst case */
+} LowPowerStats_t;
+
+/* EnterLowPower
+ *
+ * Arguments:   None
+ * Return:      TRUE if STOP2 was entered, FALSE if the next deadline is
+ *              too close (or the UART is still busy).
+ * Description: Tickless idle.  Programs LPTIM1 for the pending TIM2 compare
+ *              deadline (or the longest LPTIM period if none is armed),
+ *              enters STOP2 and wakes on an ALERT EXTI or LPTIM1.
+ *              On resume the system clock is restored and TIM2 and the
+ *              time stamp timers are advanced by the time spent stopped.
+ *              Call with interrupts disabled after checking that all ports
+ *              are idle - pending interrupts are serviced once re-enabled.
+ */
+FSC_BOOL EnterLowPower(void);
+
+/* Clears the LPTIM1 wake-up flags - called from LPTIM1_IRQHandler */
+void LPTimerIRQHandler(void);
+
+/* platform_GetLowPowerStats
+ *
+ * Arguments:   None
+ * Return:      Pointer to the tickless idle statistics
+ * Description: Residency and wake latency counters since boot.
+ */
+const LowPowerStats_t *platform_GetLowPowerStats(void);
+
+/* System clock modes for the clock governor */
+typedef enum {
+  ClockFull = 0,            /* HSE/PLL 48MHz, voltage range 1 (SystemClock_Config) */
+  ClockLow,                 /* MSI 4MHz, voltage range 2, HSE and PLLs off */
+  NUM_CLOCK_MODES
+} ClockMode_t;
+
+/* Clock governor statistics, by mode.
+ * Time is wall time and includes STOP2 - weight TimeMs by the board's run
+ * current in each mode, and LowPowerStats for the stopped share of it.
+ * Pass times are the scheduler passes that ran a port, i.e. the cost of a
+ * state machine transition at that clock.
+ */
+typedef struct {
+  FSC_U32 SwitchCount[NUM_CLOCK_MODES];       /* Switches into the mode */
+  FSC_U32 TimeMs[NUM_CLOCK_MODES];            /* Total time in the mode */
+  FSC_U32 LastSwitchLatency[NUM_CLOCK_MODES]; /* us to switch into it */
+  FSC_U32 MaxSwitchLatency[NUM_CLOCK_MODES];  /* us, worst case */
+  FSC_U32 PassCount[NUM_CLOCK_MODES];         /* Passes run in the mode */
+  FSC_U32 PassTime[NUM_CLOCK_MODES];          /* us, total */
+  FSC_U32 MaxPassTime[NUM_CLOCK_MODES];       /* us, longest single pass */
+} ClockStats_t;
+
+/* platform_SetClockMode
+ *
+ * Arguments:   mode: Clock mode to run in
+ * Return:      TRUE if running in the requested mode
+ * Description: Switches the system clock and voltage range, and re-derives
+ *              the clocked peripherals (TIM2 microsecond base, I2C timing,
+ *              UART baud) before anything else can run.  The microsecond
+ *              clock keeps its count across the switch.
+ *              ClockLow is refused while the UART is draining, and always
+ *              with USB HID (the USB clock needs the PLL at range 1).
+ *              Call from the main loop only.
+ */
+FSC_BOOL platform_SetClockMode(ClockMode_t mode);
+
+ClockMode_t platform_GetClockMode(void);
+
+/* Account a scheduler pass against the current clock mode */
+void platform_AccountClockPass(FSC_U32 elapsed);
+
+/* platform_GetClockStats
+ *
+ * Arguments:   None
+ * Return:      Pointer to the clock governor statistics
+ * Description: Mode residency, switch and pass latency counters since boot.
+ */
+const ClockStats_t *platform_GetClockStats(void);
+#endif /* FSC_HAVE_LOWPOWER */
+
 #endif /* FSCPM_PLATFORM_H_ */
 
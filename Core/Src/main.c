@@ -31,6 +31,7 @@
 #include "timer.h"
 #include "observer.h"
 #include "platform.h"
+#include "task.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -40,9 +41,7 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-#define I2C_ADDRESS_PORT1   0xA0
-#define I2C_ADDRESS_PORT2   0xA2
-#define I2C_ADDRESS_PORT3   0xA4
+
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -53,9 +52,7 @@
 /* Private variables ---------------------------------------------------------*/
 I2C_HandleTypeDef hi2c3;
 
-TIM_HandleTypeDef htim1;
 TIM_HandleTypeDef htim2;
-TIM_HandleTypeDef htim3;
 
 PCD_HandleTypeDef hpcd_USB_OTG_FS;
 
@@ -68,17 +65,16 @@ void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
 static void MX_I2C3_Init(void);
 static void MX_USB_OTG_FS_PCD_Init(void);
-static void MX_TIM3_Init(void);
 static void MX_TIM2_Init(void);
-static void MX_TIM1_Init(void);
 /* USER CODE BEGIN PFP */
 
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
-struct Port g_ports[FSC_NUMBER_OF_PORTS];
-volatile FSC_BOOL g_port_active[FSC_NUMBER_OF_PORTS];
+struct Port g_ports[BOARD_PORT_COUNT];
+struct PortTask g_tasks[BOARD_PORT_COUNT];
+FSC_U8 g_port_count;            /* Ports configured by the board table */
 volatile FSC_BOOL g_timer_int_active;
 FSC_S8 g_IdleIdx;
 
@@ -92,7 +88,7 @@ void WakeOnTimer() {
   g_IdleIdx = -1;
 
   /* Go through all Ports and find the shortest timer  */
-  for (j = 0; j < FSC_NUMBER_OF_PORTS; j++) {
+  for (j = 0; j < g_port_count; j++) {
     timer_value = core_get_next_timeout(&g_ports[j]);
     /* Get the shortest timer.
      * 0 - No active timer
@@ -116,6 +112,38 @@ void WakeOnTimer() {
     SetTimeInterrupt(timeout_value);
   }
 }
+
+#ifdef FSC_HAVE_LOWPOWER
+/* All ports idle with no pending alert or wake-up request? */
+FSC_BOOL PortsIdle(void) {
+  FSC_U8 j = 0;
+
+  for (j = 0; j < g_port_count; j++) {
+    if (TaskReady(&g_tasks[j]) ||
+        platform_get_device_irq_state(g_ports[j].port_id_)) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/* Clock governor - full speed while any port is attaching, negotiating,
+ * swapping or discovering; MSI at range 2 once every port has settled. */
+void ClockGovernor(void) {
+  ClockMode_t mode = ClockLow;
+  FSC_U8 j = 0;
+
+  for (j = 0; j < g_port_count; j++) {
+    if (g_tasks[j].state_ != TaskRunning || !core_is_settled(&g_ports[j])) {
+      mode = ClockFull;
+      break;
+    }
+  }
+
+  platform_SetClockMode(mode);
+}
+#endif /* FSC_HAVE_LOWPOWER */
 /* USER CODE END 0 */
 
 /**
@@ -149,68 +177,66 @@ int main(void)
   MX_GPIO_Init();
   MX_I2C3_Init();
   MX_USB_OTG_FS_PCD_Init();
-  MX_TIM3_Init();
   MX_TIM2_Init();
-  MX_TIM1_Init();
   /* USER CODE BEGIN 2 */
   FSC_U8 i = 0;
+  FSC_U8 bus = 0;
+  FSC_U8 i2c_addr = 0;
   FSC_U32 check_idle = FALSE;
+#ifdef FSC_HAVE_LOWPOWER
+  FSC_BOOL ran = FALSE;
+  FSC_U32 pass_time = 0;
+#endif /* FSC_HAVE_LOWPOWER */
 
   PlatformInitialize();
-  InitializeVars(&g_ports[0], 1, I2C_ADDRESS_PORT1);
-  g_port_active[0] = TRUE;
 
-  //FSC_BOOL r = platform_i2c_write(g_ports[0].i2c_addr_, (FSC_U8)0xA2, 1, 1);
+  /* Configure and schedule each port described by the board */
+  g_port_count = platform_GetPortCount();
+
+  for (i = 0; i < g_port_count; ++i) {
+    platform_GetPortConfig(i + 1, &bus, &i2c_addr);
+    InitializeVars(&g_ports[i], i + 1, bus, i2c_addr);
+    TaskInitialize(&g_tasks[i], &g_ports[i]);
+  }
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (1) {
-     for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
-       /* Initializing */
-       if (g_ports[i].initialized_ == FALSE) {
-         /* If we haven't been initialized yet, wait on the init interrupt */
-         if (ReadRegister(&g_ports[i], regPWRSTAT) != FALSE) {
-           if (g_ports[i].registers_.PwrStat.TCPC_INIT == 0) {
-             /* Chip is ready - initialize and continue. */
-        	 HAL_Delay(500);
-             InitializePort(&g_ports[i]);
-             platform_printf(g_ports[i].port_id_, "Port Initialized.\n", -1);
-           }
-         }
+     /* One pass for each ready port task, round robin */
+     TaskPassStart();
+#ifdef FSC_HAVE_LOWPOWER
+     ran = FALSE;
+#endif /* FSC_HAVE_LOWPOWER */
+
+     /* Find the source of any edge on a shared ALERT line */
+     TaskScanAlerts();
+
+     for (i = 0; i < g_port_count; ++i) {
+       if (!TaskReady(&g_tasks[i])) {
          continue;
        }
 
-       /* State Machine Processing */
-       if (g_port_active[i] || !g_ports[i].idle_) {
+#ifdef FSC_HAVE_LOWPOWER
+       ran = TRUE;
+#endif /* FSC_HAVE_LOWPOWER */
+
+       if (g_tasks[i].state_ == TaskRunning) {
          /* Disable interrupt to prevent conflict */
          ClearTimeInterrupt();
-
-         /* Reset for next interrupt */
-         g_port_active[i] = FALSE;
-
          platform_SetDebugPin(TRUE);
+       }
 
-         /* Process port */
-         core_state_machine(&g_ports[i]);
-
-         //g_ports[i].idle_ = FALSE;
-
-         /* Wait on the next alert/interrupt */
-         /* This also allows a final state machine run if still active. */
-         if (g_ports[i].idle_) {
-           if (platform_get_device_irq_state(g_ports[i].port_id_))
-           {
-             g_ports[i].idle_ = FALSE;
-           }
-           else
-           {
-             check_idle = TRUE;
-             platform_SetDebugPin(FALSE);
-           }
-         }
+       if (TaskRun(&g_tasks[i])) {
+         check_idle = TRUE;
+         platform_SetDebugPin(FALSE);
        }
      }
+#ifdef FSC_HAVE_LOWPOWER
+     pass_time = TaskPassEnd();
+#else
+     TaskPassEnd();
+#endif /* FSC_HAVE_LOWPOWER */
 
      if (check_idle == TRUE)
      {
@@ -220,12 +246,30 @@ int main(void)
      }
 
      /* System Policy process function to handle debug/system IO, etc. */
-     SystemPolicyProcess(g_ports);
+     SystemPolicyProcess(g_ports, g_port_count);
 
  #ifdef FSC_HAVE_UART
      /* Make sure the UART buffer gets flushed. */
      ProcessUART();
  #endif
+
+#ifdef FSC_HAVE_LOWPOWER
+     if (ran) {
+       platform_AccountClockPass(pass_time);
+     }
+
+     /* Run at the clock the ports' states call for */
+     ClockGovernor();
+
+     /* Tickless idle - stop until the next alert or timer deadline.
+      * Interrupts stay masked across the check so an alert can't slip in
+      * between; anything pending wakes the core and is serviced below. */
+     __disable_irq();
+     if (PortsIdle()) {
+       EnterLowPower();
+     }
+     __enable_irq();
+#endif /* FSC_HAVE_LOWPOWER */
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -339,53 +383,6 @@ static void MX_I2C3_Init(void)
 
 }
 
-/**
-  * @brief TIM1 Initialization Function
-  * @param None
-  * @retval None
-  */
-static void MX_TIM1_Init(void)
-{
-
-  /* USER CODE BEGIN TIM1_Init 0 */
-
-  /* USER CODE END TIM1_Init 0 */
-
-  TIM_ClockConfigTypeDef sClockSourceConfig = {0};
-  TIM_MasterConfigTypeDef sMasterConfig = {0};
-
-  /* USER CODE BEGIN TIM1_Init 1 */
-
-  /* USER CODE END TIM1_Init 1 */
-  htim1.Instance = TIM1;
-  htim1.Init.Prescaler = 4800;
-  htim1.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim1.Init.Period = 10000;
-  htim1.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
-  htim1.Init.RepetitionCounter = 0;
-  htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
-  if (HAL_TIM_Base_Init(&htim1) != HAL_OK)
-  {
-    Error_Handler();
-  }
-  sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_INTERNAL;
-  if (HAL_TIM_ConfigClockSource(&htim1, &sClockSourceConfig) != HAL_OK)
-  {
-    Error_Handler();
-  }
-  sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
-  sMasterConfig.MasterOutputTrigger2 = TIM_TRGO2_RESET;
-  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
-  if (HAL_TIMEx_MasterConfigSynchronization(&htim1, &sMasterConfig) != HAL_OK)
-  {
-    Error_Handler();
-  }
-  /* USER CODE BEGIN TIM1_Init 2 */
-
-  /* USER CODE END TIM1_Init 2 */
-
-}
-
 /**
   * @brief TIM2 Initialization Function
   * @param None
@@ -405,7 +402,7 @@ static void MX_TIM2_Init(void)
 
   /* USER CODE END TIM2_Init 1 */
   htim2.Instance = TIM2;
-  htim2.Init.Prescaler = 48;
+  htim2.Init.Prescaler = 47;
   htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
   htim2.Init.Period = 0xFFFFFFFF;
   htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
@@ -431,51 +428,6 @@ static void MX_TIM2_Init(void)
 
 }
 
-/**
-  * @brief TIM3 Initialization Function
-  * @param None
-  * @retval None
-  */
-static void MX_TIM3_Init(void)
-{
-
-  /* USER CODE BEGIN TIM3_Init 0 */
-
-  /* USER CODE END TIM3_Init 0 */
-
-  TIM_ClockConfigTypeDef sClockSourceConfig = {0};
-  TIM_MasterConfigTypeDef sMasterConfig = {0};
-
-  /* USER CODE BEGIN TIM3_Init 1 */
-
-  /* USER CODE END TIM3_Init 1 */
-  htim3.Instance = TIM3;
-  htim3.Init.Prescaler = 0;
-  htim3.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim3.Init.Period = 0;
-  htim3.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
-  htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
-  if (HAL_TIM_Base_Init(&htim3) != HAL_OK)
-  {
-    Error_Handler();
-  }
-  sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_INTERNAL;
-  if (HAL_TIM_ConfigClockSource(&htim3, &sClockSourceConfig) != HAL_OK)
-  {
-    Error_Handler();
-  }
-  sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
-  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
-  if (HAL_TIMEx_MasterConfigSynchronization(&htim3, &sMasterConfig) != HAL_OK)
-  {
-    Error_Handler();
-  }
-  /* USER CODE BEGIN TIM3_Init 2 */
-
-  /* USER CODE END TIM3_Init 2 */
-
-}
-
 /**
   * @brief USB_OTG_FS Initialization Function
   * @param None
@@ -548,7 +500,34 @@ static void MX_GPIO_Init(void)
 }
 
 /* USER CODE BEGIN 4 */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+  /* Wake the port(s) on this ALERT line */
+  FSC_U8 line = platform_GetAlertLine(GPIO_Pin);
+
+  if (line > 0) {
+    TaskAlert(line);
+  }
+}
 
+void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim)
+{
+  /* Deadline action compare, if it slipped past TIM2_IRQHandler's check */
+  if (htim->Instance == TIM2 &&
+      htim->Channel == HAL_TIM_ACTIVE_CHANNEL_2) {
+    DeadlineService();
+    return;
+  }
+
+  /* Timer deadline set by WakeOnTimer has been reached */
+  if (htim->Instance == TIM2) {
+    ClearTimeInterrupt();
+    g_timer_int_active = FALSE;
+    if (g_IdleIdx > -1) {
+      TaskWake(&g_tasks[g_IdleIdx]);
+    }
+  }
+}
 /* USER CODE END 4 */
 
 /**
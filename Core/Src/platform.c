@@ -33,9 +33,6 @@
 #include "stm32l4xx_hal_gpio.h"
 #include "stm32l4xx_hal_i2c.h"
 
-#ifdef FSC_HAVE_UART
-#include "stm32f0xx_hal_usart.h"
-#endif /* FSC_HAVE_UART */
 #include "timer.h"
 
 /* Pin selections: */
@@ -46,7 +43,7 @@
 #define PIN_USB_HID_pl      GPIO_PIN_12 /* PA_12 */
 #define PIN_USB_HID_DM      GPIO_PIN_11 /* PA_11 */
 
-#define PIN_ALERT_1         GPIO_PIN_6  /* PA_8  */
+#define PIN_ALERT_1         GPIO_PIN_6  /* PA_6  */
 #define PIN_ALERT_2         GPIO_PIN_9  /* PA_9  */
 #define PIN_ALERT_3         GPIO_PIN_10 /* PA_10 */
 
@@ -56,8 +53,87 @@
 
 #define UART_BUFFER_SIZE    1024
 
+/* Transfer timeout in ms, as given to the HAL I2C calls */
+#define I2C_TIMEOUT         0x10
+
+#ifdef FSC_HAVE_LOWPOWER
+/* LPTIM1 runs from the 32kHz LSI with no prescaler: 31.25us per tick. */
+#define LPTIM_TICKS_TO_US(t) (((t) * 125) / 4)
+#define LPTIM_US_TO_TICKS(u) (((u) * 4) / 125)
+#define LPTIM_MAX_TICKS      0xF000 /* Leave headroom to measure wake time */
+
+/* Don't bother stopping for less than this - HSE/PLL restart eats most of it */
+#define LOWPOWER_MIN_SLEEP_US   5000
+/* Wake this early so TIM2 handles the final approach to the deadline */
+#define LOWPOWER_WAKE_MARGIN_US 2000
+#endif /* FSC_HAVE_LOWPOWER */
+
+#ifdef FSC_HAVE_UART
+/* UART baud rate, re-derived from PCLK1 on every clock switch */
+#define UART_BAUD_RATE      115200
+
+/* DMA1 channel 7, request 2 is USART2_TX */
+#define UART_DMA            DMA1_Channel7
+#define UART_DMA_REQUEST    (2U << DMA_CSELR_C7S_Pos)
+#endif /* FSC_HAVE_UART */
+
+/* Board description - one entry per TCPC, in port ID order.
+ * Bus is an index into I2CBuses.  Each ALERT pin needs its own EXTI line
+ * (one GPIO bank per line) and an EXTI handler calling AlertIRQHandler.
+ * Ports may share a wire-OR ALERT pin - an edge is then resolved by a scan
+ * of the ports' ALERT registers in port ID order, so list the port with
+ * the tightest latency needs first.
+ */
+typedef struct {
+  FSC_U8 Bus;
+  FSC_U8 I2CAddr;
+  GPIO_TypeDef *AlertPort;
+  FSC_U16 AlertPin;
+} BoardPort_t;
+
+static const BoardPort_t BoardPorts[] = {
+  { 0, 0xA0, GPIOA, PIN_ALERT_1 },
+#ifdef FSC_HAVE_MULTIPORT
+  { 0, 0xA2, GPIOA, PIN_ALERT_2 },
+  { 0, 0xA4, GPIOA, PIN_ALERT_3 },
+#endif /* FSC_HAVE_MULTIPORT */
+};
+
+/* Fail the build if the table doesn't match BOARD_PORT_COUNT, or the board
+ * has more ports than the port manager */
+typedef char BoardPortCountCheck[
+    (sizeof(BoardPorts) / sizeof(BoardPorts[0]) == BOARD_PORT_COUNT &&
+     BOARD_PORT_COUNT <= FSC_NUMBER_OF_PORTS) ? 1 : -1];
+
+static I2C_TypeDef *const I2CBuses[] = { I2C3 };
+
+#ifdef FSC_HAVE_LOWPOWER
+/* 100kHz I2C timing by PCLK1 frequency, one entry per clock mode */
+typedef struct {
+  FSC_U32 Hz;
+  FSC_U32 Timing;
+} I2CTiming_t;
+
+static const I2CTiming_t I2CTimings[] = {
+  { 48000000, 0x20303E5D },     /* ClockFull - CubeMX */
+  {  4000000, 0x00420F13 },     /* ClockLow - RM0351 8MHz values, PRESC 0 */
+};
+#endif /* FSC_HAVE_LOWPOWER */
+
 /* File Variables */
 
+/* EXTI lines used by ALERT pins */
+static FSC_U32 AlertLineMask;
+
+/* Upper 32 bits of the microsecond clock - TIM2 overflow count */
+static volatile FSC_U32 TickHigh;
+
+/* A deadline is set on TIM2 channel 2 */
+static volatile FSC_BOOL DeadlineTimerArmed;
+
+/* Transfer in progress, by I2C bus */
+static volatile FSC_BOOL I2CBusBusy[sizeof(I2CBuses) / sizeof(I2CBuses[0])];
+
 #ifdef FSC_HAVE_UART
 /* UART Transmit PingPong Buffers */
 FSC_U8 *UARTXmitBuffer;
@@ -65,16 +141,65 @@ FSC_U16 UARTXmitIndex;
 FSC_U8 UARTXmitBuffer_Ping[UART_BUFFER_SIZE];
 FSC_U8 UARTXmitBuffer_Pong[UART_BUFFER_SIZE];
 FSC_BOOL UARTXmitBuffer_IsPing;
+
+/* Command line, handled by SystemPolicyProcess */
+extern FSC_U8 UARTRecBuffer[64];
+extern FSC_U8 UARTRecIndex;
+extern volatile FSC_BOOL UARTRecHaveMsg;
 #endif /* FSC_HAVE_UART */
 
 extern volatile FSC_BOOL g_timer_int_active;
 
+#ifdef FSC_HAVE_FWUP
+/* Firmware update staging area, from the linker script - an FSC_HAVE_FWUP
+ * build links with STM32L476MGYX_FLASH_FWUP.ld (or _RAM_FWUP.ld) */
+extern FSC_U8 _sstaging[];
+extern FSC_U8 _estaging[];
+
+/* Write in progress - the rest of it, programmed from the FLASH IRQ */
+static const FSC_U8 *volatile StagingData;
+static volatile FSC_U32 StagingAddr;
+static volatile FSC_U32 StagingLeft;
+static volatile FSC_BOOL StagingBusy;
+static volatile FSC_BOOL StagingError;
+static volatile FSC_BOOL StagingErasing;
+static volatile FSC_BOOL StagingStep;     /* Next step due, thread side */
+#endif /* FSC_HAVE_FWUP */
+
+#ifdef FSC_HAVE_LOWPOWER
+LowPowerStats_t LowPowerStats;
+FSC_U32 LowPowerLastResume;
+FSC_U32 LowPowerRunTimeUs;
+FSC_U32 LowPowerStopTimeUs;
+
+/* CubeMX generated clock tree setup, re-applied after STOP2 */
+extern void SystemClock_Config(void);
+
+/* Clock governor */
+static ClockMode_t ClockMode = ClockFull;
+static RCC_ClkInitTypeDef ClockConfigs[NUM_CLOCK_MODES];
+static FSC_U32 ClockLatency[NUM_CLOCK_MODES];
+static ClockStats_t ClockStats;
+static FSC_U64 ClockTimeUs[NUM_CLOCK_MODES];
+static FSC_U64 ClockModeStart;
+#endif /* FSC_HAVE_LOWPOWER */
+
 void SystemClockConfig(void);
 void InitializePeripheralClocks(void);
 void InitializeI2C(void);
 void InitializeGPIO(void);
 void InitializeTickTimer(void);
-void InitializeTSTimer(void);
+void InitializeCycleCounter(void);
+void InitializeAlertPins(void);
+
+#ifdef FSC_HAVE_LOWPOWER
+void InitializeLPTimer(void);
+void InitializeClockGovernor(void);
+#endif /* FSC_HAVE_LOWPOWER */
+
+#ifdef FSC_HAVE_FWUP
+void InitializeStaging(void);
+#endif /* FSC_HAVE_FWUP */
 
 #ifdef FSC_HAVE_UART
 void InitializeUART(void);
@@ -93,12 +218,21 @@ void PlatformInitialize(void)
   InitializePeripheralClocks();
 
   //HAL_Init();
-  HAL_InitTick(1);
+  /* Above TIM2 - the deadline interrupt's I2C write times out on the tick */
+  HAL_InitTick(0);
 
   //InitializeI2C();
   //InitializeGPIO();
   InitializeTickTimer();
-  InitializeTSTimer();
+  InitializeCycleCounter();
+  InitializeAlertPins();
+#ifdef FSC_HAVE_LOWPOWER
+  InitializeLPTimer();
+  InitializeClockGovernor();
+#endif /* FSC_HAVE_LOWPOWER */
+#ifdef FSC_HAVE_FWUP
+  InitializeStaging();
+#endif /* FSC_HAVE_FWUP */
 #ifdef FSC_HAVE_UART
   InitializeUART();
 #endif /* FSC_HAVE_UART */
@@ -125,10 +259,10 @@ void InitializePeripheralClocks(void)
 
 #ifdef FSC_HAVE_UART
   /* USART2 */
-  RCC->APB1ENR |= RCC_APB1ENR_USART2EN;
+  RCC->APB1ENR1 |= RCC_APB1ENR1_USART2EN;
 
   /* DMA1 */
-  RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+  RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
 #endif /* FSC_HAVE_UART */
 }
 
@@ -175,54 +309,244 @@ void SystemClockConfig(void)
 }
 
 
-FSC_BOOL platform_i2c_read(FSC_U8 slaveaddress, FSC_U8 regaddr,
+FSC_U8 platform_GetPortCount(void)
+{
+  return BOARD_PORT_COUNT;
+}
+
+FSC_BOOL platform_GetPortConfig(FSC_U8 port, FSC_U8 *bus, FSC_U8 *i2c_addr)
+{
+  if (port == 0 || port > BOARD_PORT_COUNT) {
+    return FALSE;
+  }
+
+  *bus = BoardPorts[port - 1].Bus;
+  *i2c_addr = BoardPorts[port - 1].I2CAddr;
+  return TRUE;
+}
+
+static IRQn_Type AlertIRQn(FSC_U32 line)
+{
+  switch (line) {
+  case 0: return EXTI0_IRQn;
+  case 1: return EXTI1_IRQn;
+  case 2: return EXTI2_IRQn;
+  case 3: return EXTI3_IRQn;
+  case 4: return EXTI4_IRQn;
+  default:
+    return (line < 10) ? EXTI9_5_IRQn : EXTI15_10_IRQn;
+  }
+}
+
+void InitializeAlertPins(void)
+{
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+  FSC_U32 line = 0;
+  FSC_U8 i = 0;
+
+  /* ALERT_N is open drain, active low, pulled up on the board */
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+
+  for (i = 0; i < BOARD_PORT_COUNT; i++) {
+    GPIO_InitStruct.Pin = BoardPorts[i].AlertPin;
+    HAL_GPIO_Init(BoardPorts[i].AlertPort, &GPIO_InitStruct);
+
+    line = POSITION_VAL(BoardPorts[i].AlertPin);
+    AlertLineMask |= BoardPorts[i].AlertPin;
+
+    HAL_NVIC_SetPriority(AlertIRQn(line), 0, 0);
+    HAL_NVIC_EnableIRQ(AlertIRQn(line));
+  }
+}
+
+/* Line IDs are the EXTI line number + 1 */
+FSC_U8 platform_GetAlertLine(FSC_U16 pin)
+{
+  return (pin & AlertLineMask) ? POSITION_VAL(pin) + 1 : 0;
+}
+
+FSC_U8 platform_get_alert_line(FSC_U8 port)
+{
+  if (port == 0 || port > BOARD_PORT_COUNT) {
+    return 0;
+  }
+
+  return POSITION_VAL(BoardPorts[port - 1].AlertPin) + 1;
+}
+
+void AlertIRQHandler(void)
+{
+  /* Dispatch every pending ALERT line sharing this vector */
+  FSC_U32 pending = EXTI->PR1 & AlertLineMask;
+  FSC_U32 pin = 0;
+
+  while (pending) {
+    pin = pending & (~pending + 1);
+    pending &= ~pin;
+    HAL_GPIO_EXTI_IRQHandler((FSC_U16)pin);
+  }
+}
+
+static FSC_U8 I2CBusIndex(FSC_U8 bus)
+{
+  return (bus < sizeof(I2CBuses) / sizeof(I2CBuses[0])) ? bus : 0;
+}
+
+FSC_BOOL platform_i2c_busy(FSC_U8 bus)
+{
+  return I2CBusBusy[I2CBusIndex(bus)];
+}
+
+FSC_BOOL platform_i2c_read(FSC_U8 bus, FSC_U8 slaveaddress, FSC_U8 regaddr,
                            FSC_U8 length, FSC_U8 *data)
 {
   I2C_HandleTypeDef i2chandle = {};
   HAL_StatusTypeDef result = HAL_OK;
 
+  FSC_BOOL busy = FALSE;
+
+  bus = I2CBusIndex(bus);
+
   /* To prevent storing a global, re-initialize the basic items here. */
-  i2chandle.Instance = I2C3;
+  i2chandle.Instance = I2CBuses[bus];
   i2chandle.State    = HAL_I2C_STATE_READY;
 
+  /* Nests when called from an interrupt that preempted a transfer */
+  busy = I2CBusBusy[bus];
+  I2CBusBusy[bus] = TRUE;
   result = HAL_I2C_Mem_Read(&i2chandle, slaveaddress,
-                            regaddr, 1, data, length, 0x10);
+                            regaddr, 1, data, length, I2C_TIMEOUT);
+  I2CBusBusy[bus] = busy;
 
   return ((result == HAL_OK) ? TRUE : FALSE);
 }
 
-FSC_BOOL platform_i2c_write(FSC_U8 slaveaddress, FSC_U8 regaddr,
+FSC_BOOL platform_i2c_write(FSC_U8 bus, FSC_U8 slaveaddress, FSC_U8 regaddr,
                             FSC_U8 length, FSC_U8 *data)
 {
   I2C_HandleTypeDef i2chandle = {};
   HAL_StatusTypeDef result = HAL_OK;
 
+  FSC_BOOL busy = FALSE;
+
+  bus = I2CBusIndex(bus);
+
   /* To prevent storing a global, re-initialize the basic items here. */
-  i2chandle.Instance = I2C3;
+  i2chandle.Instance = I2CBuses[bus];
   i2chandle.State    = HAL_I2C_STATE_READY;
 
+  /* Nests when called from an interrupt that preempted a transfer */
+  busy = I2CBusBusy[bus];
+  I2CBusBusy[bus] = TRUE;
   result = HAL_I2C_Mem_Write(&i2chandle, slaveaddress,
-                             regaddr, 1, data, length, 0x10);
+                             regaddr, 1, data, length, I2C_TIMEOUT);
+  I2CBusBusy[bus] = busy;
 
   return ((result == HAL_OK) ? TRUE : FALSE);
 }
 
+/* Wait for an ISR flag - FALSE on a NACK or timeout */
+static FSC_BOOL I2CWaitFlag(I2C_TypeDef *i2c, FSC_U32 flag, FSC_U32 start)
+{
+  while ((i2c->ISR & flag) == 0) {
+    if ((i2c->ISR & I2C_ISR_NACKF) ||
+        (HAL_GetTick() - start) > I2C_TIMEOUT) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+FSC_BOOL platform_i2c_block_read(FSC_U8 bus, FSC_U8 slaveaddress,
+                                 FSC_U8 regaddr, FSC_U8 length, FSC_U8 *data)
+{
+  I2C_TypeDef *i2c = 0;
+  FSC_U32 start = HAL_GetTick();
+  FSC_U32 sadd = slaveaddress & I2C_CR2_SADD;
+  FSC_U8 count = 0;
+  FSC_U8 byte = 0;
+  FSC_U8 i = 0;
+  FSC_BOOL result = FALSE;
+  FSC_BOOL busy = FALSE;
+
+  if (length == 0) {
+    return FALSE;
+  }
+
+  bus = I2CBusIndex(bus);
+  i2c = I2CBuses[bus];
+
+  /* Nests when called from an interrupt that preempted a transfer */
+  busy = I2CBusBusy[bus];
+  I2CBusBusy[bus] = TRUE;
+
+  /* Register address, no stop */
+  i2c->CR2 = sadd | (1U << I2C_CR2_NBYTES_Pos) | I2C_CR2_START;
+  result = I2CWaitFlag(i2c, I2C_ISR_TXIS, start);
+  if (result) {
+    i2c->TXDR = regaddr;
+    result = I2CWaitFlag(i2c, I2C_ISR_TC, start);
+  }
+
+  /* Restart for the count byte, held open (RELOAD) until it is known how
+   * many follow */
+  if (result) {
+    i2c->CR2 = sadd | I2C_CR2_RD_WRN | (1U << I2C_CR2_NBYTES_Pos) |
+               I2C_CR2_RELOAD | I2C_CR2_START;
+    result = I2CWaitFlag(i2c, I2C_ISR_RXNE, start);
+  }
+  if (result) {
+    data[0] = (FSC_U8)i2c->RXDR;
+    count = (data[0] < length) ? data[0] : length - 1;
+    result = I2CWaitFlag(i2c, I2C_ISR_TCR, start);
+  }
+
+  /* The rest in the same transfer - at least one byte, as NBYTES can't be
+   * reloaded with zero */
+  if (result) {
+    i2c->CR2 = (i2c->CR2 & ~(I2C_CR2_NBYTES | I2C_CR2_RELOAD)) |
+               ((count ? count : 1U) << I2C_CR2_NBYTES_Pos) | I2C_CR2_AUTOEND;
+  }
+  for (i = 0; result && i < (count ? count : 1); i++) {
+    result = I2CWaitFlag(i2c, I2C_ISR_RXNE, start);
+    if (result) {
+      byte = (FSC_U8)i2c->RXDR;
+      if (i < count) {
+        data[1 + i] = byte;
+      }
+    }
+  }
+  if (result) {
+    result = I2CWaitFlag(i2c, I2C_ISR_STOPF, start);
+  }
+
+  if (!result) {
+    /* End the transfer and leave the peripheral ready for the next */
+    if ((i2c->ISR & I2C_ISR_STOPF) == 0) {
+      i2c->CR2 |= I2C_CR2_STOP;
+      start = HAL_GetTick();
+      while ((i2c->ISR & I2C_ISR_STOPF) == 0 &&
+             (HAL_GetTick() - start) <= I2C_TIMEOUT) {
+      }
+    }
+    i2c->ISR |= I2C_ISR_TXE;
+  }
+  i2c->ICR = I2C_ICR_STOPCF | I2C_ICR_NACKCF;
+  i2c->CR2 = 0;
+  I2CBusBusy[bus] = busy;
+
+  return result;
+}
+
 FSC_BOOL platform_get_device_irq_state(FSC_U8 port)
 {
-  GPIO_PinState state = GPIO_PIN_RESET;
+  GPIO_PinState state = GPIO_PIN_SET;
 
-  switch(port) {
-  case 1:
-    state = HAL_GPIO_ReadPin(GPIOA, PIN_ALERT_1);
-    break;
-  case 2:
-    state = HAL_GPIO_ReadPin(GPIOA, PIN_ALERT_2);
-    break;
-  case 3:
-    state = HAL_GPIO_ReadPin(GPIOA, PIN_ALERT_3);
-    break;
-  default:
-    break;
+  if (port > 0 && port <= BOARD_PORT_COUNT) {
+    state = HAL_GPIO_ReadPin(BoardPorts[port - 1].AlertPort,
+                             BoardPorts[port - 1].AlertPin);
   }
 
   /* ALERT signals are active low, so this looks backwards! */
@@ -290,25 +614,29 @@ FSC_U16 platform_getPPSCurrent(FSC_U8 port)
 
 void InitializeTickTimer(void)
 {
-  /* Disable */
-  TIM2->CR1 = 0x00000000;
-
-  /* SystemCoreClock is 48MHz. */
-  /* Prescaler - 48 gives 1us resolution */
-  TIM2->PSC = 48;
+  /* Disable.  Only overflows raise the update interrupt, not the UG
+   * events used to reload the prescaler. */
+  TIM2->CR1 = TIM_CR1_URS;
 
-  /* Start the count at the end.  Certain registers (PSC,ARR,...) are */
-  /* "shadowed" and only get updated on a rollover or other event. */
-  TIM2->CNT = 0xFFFFFFFF;
+  /* Prescale the 48MHz SystemCoreClock down to 1us resolution */
+  TIM2->PSC = (SystemCoreClock / 1000000) - 1;
 
   /* Period/Reload - a long period give a free-running time-stamp-mode timer */
   TIM2->ARR = 0xFFFFFFFF;
 
+  /* Certain registers (PSC,ARR,...) are "shadowed" and only get updated on
+   * a rollover or other event - load them now, starting the count at 0. */
+  TIM2->EGR = TIM_EGR_UG;
+  TickHigh = 0;
+
   /* Enable! */
   EnableTickTimer(TRUE);
 
-  /* Enable and set TIM2 Interrupt */
+  /* Enable and set TIM2 Interrupt - overflows extend the clock to 64 bits,
+   * channel 2 is the deadline timer */
+  TIM2->CCR2 = 0xFFFFFFFF;
   TIM2->SR = 0;
+  TIM2->DIER |= TIM_DIER_UIE | TIM_DIER_CC2IE;
   HAL_NVIC_SetPriority(TIM2_IRQn, 1, 0);
   HAL_NVIC_EnableIRQ(TIM2_IRQn);
 }
@@ -328,18 +656,116 @@ FSC_U32 platform_current_time(void)
   return TIM2->CNT;
 }
 
+FSC_U64 platform_current_time64(void)
+{
+  FSC_U32 high = 0;
+  FSC_U32 low = 0;
+  FSC_U32 pending = 0;
+
+  /* Retry if the overflow interrupt ran in between */
+  do {
+    high = TickHigh;
+    low = TIM2->CNT;
+    pending = TIM2->SR & TIM_SR_UIF;
+  } while (high != TickHigh);
+
+  /* Overflowed, but not serviced yet (interrupts masked) */
+  if (pending && low < 0x80000000) {
+    high++;
+  }
+
+  return ((FSC_U64)high << 32) | low;
+}
+
+void TickTimerIRQHandler(void)
+{
+  if (TIM2->SR & TIM_SR_UIF) {
+    TIM2->SR = ~TIM_SR_UIF;
+    TickHigh++;
+  }
+}
+
+/* An overflow after TickTimerIRQHandler looked has its UIF cleared by
+ * HAL_TIM_IRQHandler, which calls this - whichever clears the flag counts
+ * the overflow, so none is missed or counted twice. */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+  if (htim->Instance == TIM2) {
+    TickHigh++;
+  }
+}
+
+void InitializeCycleCounter(void)
+{
+  /* DWT cycle counter - needs the trace block enabled */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+FSC_U32 platform_cycle_count(void)
+{
+  return DWT->CYCCNT;
+}
+
 void platform_delay(FSC_U32 microseconds)
 {
   FSC_U32 currentTime = TIM2->CNT;
   while((FSC_U32)(TIM2->CNT - currentTime) < microseconds);
 }
 
+/* The channel 2 interrupt stays enabled - DIER is also modified by the
+ * main loop, so only the compare value is changed from interrupt context.
+ * A stale compare match just runs DeadlineService with nothing due.
+ */
+FSC_BOOL DeadlineTimerIRQ(void)
+{
+  if (TIM2->SR & TIM_SR_CC2IF) {
+    TIM2->SR = ~TIM_SR_CC2IF;
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+void platform_set_deadline_timer(FSC_U32 microseconds)
+{
+  DeadlineTimerArmed = TRUE;
+
+  if (microseconds < 2) {
+    /* Too close to catch the compare - raise it now */
+    TIM2->EGR = TIM_EGR_CC2G;
+  }
+  else {
+    TIM2->CCR2 = TIM2->CNT + microseconds;
+  }
+}
+
+void platform_clear_deadline_timer(void)
+{
+  /* Push the compare a full period out */
+  DeadlineTimerArmed = FALSE;
+  TIM2->CCR2 = TIM2->CNT - 1;
+}
+
+void platform_enable_deadline_irq(FSC_BOOL enable)
+{
+  /* Channel 2 shares the TIM2 vector */
+  if (enable) {
+    HAL_NVIC_EnableIRQ(TIM2_IRQn);
+  }
+  else {
+    HAL_NVIC_DisableIRQ(TIM2_IRQn);
+  }
+}
+
 void SetTimeInterrupt(FSC_U32 microseconds)
 {
   /* Set the offset for the next interrupt request */
   TIM2->CCR1 = TIM2->CNT + microseconds;
-  /* Clear the previous and enable the next CC1 Interrupt */
-  TIM2->SR = 0;
+  /* Clear the previous and enable the next CC1 Interrupt.
+   * Leave UIF alone - it is a pending clock overflow. */
+  TIM2->SR = ~TIM_SR_CC1IF;
   TIM2->DIER |= TIM_DIER_CC1IE;
   g_timer_int_active = TRUE;
 }
@@ -349,54 +775,496 @@ void ClearTimeInterrupt()
   TIM2->DIER &= ~TIM_DIER_CC1IE;
 }
 
-void InitializeTSTimer(void)
+void platform_enable_timer(FSC_BOOL enable)
 {
-  /* Use Timer1 to count at 0.1ms resolution up to one second. */
-  /* Use Timer3, triggered by Timer16, to count seconds. */
+  EnableTickTimer(enable);
+}
 
-  /* SystemCoreClock is 48MHz. */
-  TIM1->PSC = 4800;               /* A prescaler of 4800 gives 0.1ms res */
-  TIM1->ARR = 10000;              /* A period of 10000 gives 1sec intervals */
-  TIM1->CR2 |= TIM_CR2_MMS_1;     /* MMS = 0b010 generates TRGO */
+FSC_U32 platform_timestamp(void)
+{
+  FSC_U64 now = platform_current_time64();
+  FSC_U32 seconds = (FSC_U32)(now / 1000000);
+  FSC_U32 us = (FSC_U32)(now - (FSC_U64)seconds * 1000000);
 
-  /* Start the count at the end.  Certain registers (PSC,ARR,...) are */
-  /* "shadowed" and only get updated on a rollover or other event. */
-  TIM1->CNT = 0xFFFFFFFF;
+  /* This packs seconds and tenths of milliseconds into one 32-bit value. */
+  return (seconds << 16) + (us / 100);
+}
 
-  /* Set Timer3 up as a slave to Timer1.  Timer3 will count in seconds. */
-  TIM3->SMCR |= TIM_SMCR_SMS_2 | TIM_SMCR_SMS_1 | TIM_SMCR_SMS_0;
-  TIM3->CNT = 0;
+#ifdef FSC_HAVE_FWUP
+void InitializeStaging(void)
+{
+  StagingBusy = FALSE;
+  StagingError = FALSE;
+  StagingStep = FALSE;
 
-  /* Enable both. */
-  TIM1->CR1 |= TIM_CR1_CEN;
-  TIM3->CR1 |= TIM_CR1_CEN;
+  /* Below the tick and ALERT interrupts - a write only has to keep going */
+  HAL_NVIC_SetPriority(FLASH_IRQn, 3, 0);
+  HAL_NVIC_EnableIRQ(FLASH_IRQn);
 }
 
-void EnableTSTimer(FSC_BOOL enable)
+static void StagingDone(FSC_BOOL error)
 {
-  if (enable) {
-    TIM1->CR1 |= TIM_CR1_CEN;
-    TIM3->CR1 |= TIM_CR1_CEN;
+  StagingError = error;
+  StagingBusy = FALSE;
+  HAL_FLASH_Lock();
+}
+
+/* Start the next step of the write - erase the page it has reached, or
+ * program the next double word.  The FLASH IRQ calls back at its end.
+ * Not from the callback itself: the HAL holds its lock until the callback
+ * returns, and closes the operation after it, so a step started there
+ * would fail with HAL_BUSY.  The callback leaves it to
+ * platform_staging_service. */
+static void StagingNext(void)
+{
+  FLASH_EraseInitTypeDef erase;
+  FSC_U64 dw = 0;
+  FSC_U8 i = 0;
+
+  if (StagingLeft == 0) {
+    StagingDone(FALSE);
+    return;
+  }
+
+  if (!StagingErasing && (StagingAddr % FLASH_PAGE_SIZE) == 0) {
+    StagingErasing = TRUE;
+    erase.TypeErase = FLASH_TYPEERASE_PAGES;
+    erase.Banks = (StagingAddr < FLASH_BASE + FLASH_BANK_SIZE) ?
+                  FLASH_BANK_1 : FLASH_BANK_2;
+    erase.Page = ((StagingAddr - FLASH_BASE) % FLASH_BANK_SIZE) /
+                 FLASH_PAGE_SIZE;
+    erase.NbPages = 1;
+    if (HAL_FLASHEx_Erase_IT(&erase) != HAL_OK) {
+      StagingDone(TRUE);
+    }
+    return;
+  }
+
+  StagingErasing = FALSE;
+  for (i = 0; i < sizeof(dw); ++i) {
+    dw |= (FSC_U64)StagingData[i] << (8 * i);
+  }
+  if (HAL_FLASH_Program_IT(FLASH_TYPEPROGRAM_DOUBLEWORD, StagingAddr, dw) !=
+      HAL_OK) {
+    StagingDone(TRUE);
+  }
+}
+
+FSC_U32 platform_staging_size(void)
+{
+  return (FSC_U32)(_estaging - _sstaging);
+}
+
+const FSC_U8 *platform_staging_data(void)
+{
+  return _sstaging;
+}
+
+FSC_BOOL platform_staging_write(FSC_U32 offset, const FSC_U8 *data,
+                                FSC_U32 length)
+{
+  if (StagingBusy || length == 0 || ((offset | length) & 0x7) ||
+      offset + length > platform_staging_size()) {
+    return FALSE;
+  }
+
+  StagingData = data;
+  StagingAddr = (FSC_U32)_sstaging + offset;
+  StagingLeft = length;
+  StagingErasing = FALSE;
+  StagingError = FALSE;
+  StagingStep = FALSE;
+  StagingBusy = TRUE;
+
+  HAL_FLASH_Unlock();
+  StagingNext();
+
+  return TRUE;
+}
+
+void platform_staging_service(void)
+{
+  if (StagingStep) {
+    StagingStep = FALSE;
+    StagingNext();
+  }
+}
+
+FSC_BOOL platform_staging_busy(void)
+{
+  return StagingBusy;
+}
+
+FSC_BOOL platform_staging_error(void)
+{
+  return StagingError;
+}
+
+/* FLASH IRQ callbacks, from HAL_FLASH_IRQHandler */
+void HAL_FLASH_EndOfOperationCallback(uint32_t ReturnValue)
+{
+  if (!StagingBusy) {
+    return;
+  }
+
+  if (!StagingErasing) {
+    StagingAddr += sizeof(FSC_U64);
+    StagingData += sizeof(FSC_U64);
+    StagingLeft -= sizeof(FSC_U64);
+  }
+  StagingStep = TRUE;
+}
+
+void HAL_FLASH_OperationErrorCallback(uint32_t ReturnValue)
+{
+  if (StagingBusy) {
+    StagingDone(TRUE);
+  }
+}
+#endif /* FSC_HAVE_FWUP */
+
+#ifdef FSC_HAVE_LOWPOWER
+void InitializeLPTimer(void)
+{
+  /* LSI keeps running in STOP2 and clocks LPTIM1 */
+  RCC->CSR |= RCC_CSR_LSION;
+  while (!(RCC->CSR & RCC_CSR_LSIRDY)) {};
+
+  RCC->CCIPR = (RCC->CCIPR & ~RCC_CCIPR_LPTIM1SEL) | RCC_CCIPR_LPTIM1SEL_0;
+  RCC->APB1ENR1 |= RCC_APB1ENR1_LPTIM1EN;
+  RCC->APB1SMENR1 |= RCC_APB1SMENR1_LPTIM1SMEN;
+
+  /* CFGR and IER may only be written while the timer is disabled */
+  LPTIM1->CR = 0;
+  LPTIM1->CFGR = 0;               /* Internal clock, no prescaler */
+  LPTIM1->IER = LPTIM_IER_CMPMIE; /* Wake on compare match */
+
+  /* LPTIM1 is EXTI line 32 - the wakeup path out of STOP2 */
+  EXTI->IMR2 |= EXTI_IMR2_IM32;
+
+  HAL_NVIC_SetPriority(LPTIM1_IRQn, 1, 0);
+  HAL_NVIC_EnableIRQ(LPTIM1_IRQn);
+
+#ifdef DEBUG
+  /* Keep the debugger attached through STOP modes */
+  HAL_DBGMCU_EnableDBGStopMode();
+#endif /* DEBUG */
+
+  LowPowerLastResume = TIM2->CNT;
+}
+
+static FSC_U32 ReadLPTimerCount(void)
+{
+  /* LPTIM1 is asynchronous - CNT is only valid when two reads agree */
+  FSC_U32 count;
+
+  do {
+    count = LPTIM1->CNT;
+  } while (count != LPTIM1->CNT);
+
+  return count;
+}
+
+void LPTimerIRQHandler(void)
+{
+  /* The wake-up itself is all we need - clear the flags */
+  LPTIM1->ICR = LPTIM_ICR_CMPMCF | LPTIM_ICR_ARRMCF;
+}
+
+FSC_BOOL EnterLowPower(void)
+{
+  FSC_U32 sleep_us = LPTIM_TICKS_TO_US(LPTIM_MAX_TICKS);
+  FSC_U32 ticks = 0;
+  FSC_U32 start = 0;
+  FSC_U32 wake_count = 0;
+  FSC_U32 resume_count = 0;
+  FSC_U32 elapsed = 0;
+
+#ifdef FSC_HAVE_UART
+  /* Let the debug output drain first */
+  if (UART_DMA->CCR & DMA_CCR_EN) {
+    return FALSE;
+  }
+#endif /* FSC_HAVE_UART */
+#ifdef FSC_HAVE_FWUP
+  /* Flash can't be programmed in STOP2 */
+  if (StagingBusy) {
+    return FALSE;
+  }
+#endif /* FSC_HAVE_FWUP */
+
+  /* The pending TIM2 compares hold the next port timer and deadline
+   * action times */
+  if (TIM2->DIER & TIM_DIER_CC1IE) {
+    if ((FSC_S32)(TIM2->CCR1 - TIM2->CNT) < LOWPOWER_MIN_SLEEP_US) {
+      return FALSE;
+    }
+    if ((TIM2->CCR1 - TIM2->CNT) - LOWPOWER_WAKE_MARGIN_US < sleep_us) {
+      sleep_us = (TIM2->CCR1 - TIM2->CNT) - LOWPOWER_WAKE_MARGIN_US;
+    }
+  }
+  if (DeadlineTimerArmed) {
+    if ((FSC_S32)(TIM2->CCR2 - TIM2->CNT) < LOWPOWER_MIN_SLEEP_US) {
+      return FALSE;
+    }
+    if ((TIM2->CCR2 - TIM2->CNT) - LOWPOWER_WAKE_MARGIN_US < sleep_us) {
+      sleep_us = (TIM2->CCR2 - TIM2->CNT) - LOWPOWER_WAKE_MARGIN_US;
+    }
+  }
+
+  ticks = LPTIM_US_TO_TICKS(sleep_us);
+
+  /* Count continuously so the wake time can be measured past the match */
+  LPTIM1->CR = LPTIM_CR_ENABLE;
+  LPTIM1->ICR = LPTIM_ICR_CMPOKCF | LPTIM_ICR_ARROKCF |
+                LPTIM_ICR_CMPMCF | LPTIM_ICR_ARRMCF;
+  LPTIM1->ARR = 0xFFFF;
+  while (!(LPTIM1->ISR & LPTIM_ISR_ARROK)) {};
+  LPTIM1->CMP = ticks;
+  while (!(LPTIM1->ISR & LPTIM_ISR_CMPOK)) {};
+  LPTIM1->CR |= LPTIM_CR_CNTSTRT;
+
+  start = TIM2->CNT;
+  LowPowerRunTimeUs += start - LowPowerLastResume;
+  LowPowerStats.RunTimeMs += LowPowerRunTimeUs / 1000;
+  LowPowerRunTimeUs %= 1000;
+
+  HAL_SuspendTick();
+  HAL_PWREx_EnterSTOP2Mode(PWR_STOPENTRY_WFI);
+
+  /* Interrupts are still masked here - nothing has been serviced yet */
+  wake_count = ReadLPTimerCount();
+  if (LPTIM1->ISR & LPTIM_ISR_CMPM) {
+    LowPowerStats.WakeOnTimer++;
   }
   else {
-    TIM1->CR1 &= ~TIM_CR1_CEN;
-    TIM3->CR1 &= ~TIM_CR1_CEN;
+    LowPowerStats.WakeOnAlert++;
+  }
+
+  /* STOP2 exits on MSI - bring back HSE/PLL (unless the governor had
+   * already dropped to MSI) and the tick */
+  if (ClockMode == ClockFull) {
+    SystemClock_Config();
+  }
+  HAL_ResumeTick();
+
+  resume_count = ReadLPTimerCount();
+  LPTIM1->CR = 0;
+
+  /* TIM2 was frozen - advance it, carrying into the upper clock word */
+  elapsed = LPTIM_TICKS_TO_US(resume_count);
+  TIM2->CNT = start + elapsed;
+  if (TIM2->CNT < start) {
+    TickHigh++;
+  }
+
+  /* A compare jumped over while stopped would otherwise never fire */
+  if ((TIM2->DIER & TIM_DIER_CC1IE) &&
+      (FSC_S32)(TIM2->CNT - TIM2->CCR1) >= 0) {
+    TIM2->EGR = TIM_EGR_CC1G;
+  }
+  if (DeadlineTimerArmed &&
+      (FSC_S32)(TIM2->CNT - TIM2->CCR2) >= 0) {
+    TIM2->EGR = TIM_EGR_CC2G;
+  }
+
+  LowPowerStats.StopCount++;
+  LowPowerStopTimeUs += LPTIM_TICKS_TO_US(wake_count);
+  LowPowerStats.StopTimeMs += LowPowerStopTimeUs / 1000;
+  LowPowerStopTimeUs %= 1000;
+  LowPowerStats.LastWakeLatency = LPTIM_TICKS_TO_US(resume_count - wake_count);
+  if (LowPowerStats.LastWakeLatency > LowPowerStats.MaxWakeLatency) {
+    LowPowerStats.MaxWakeLatency = LowPowerStats.LastWakeLatency;
   }
+  LowPowerLastResume = TIM2->CNT;
+
+  return TRUE;
 }
 
-void platform_enable_timer(FSC_BOOL enable)
+const LowPowerStats_t *platform_GetLowPowerStats(void)
 {
-  EnableTickTimer(enable);
-  EnableTSTimer(enable);
+  return &LowPowerStats;
 }
 
-FSC_U32 platform_timestamp(void)
+void InitializeClockGovernor(void)
 {
-  /* This packs seconds and tenths of milliseconds into one 32-bit value. */
-  return ((FSC_U32)(TIM3->CNT) << 16) +
-          (FSC_U32)(TIM1->CNT);
+  /* ClockFull is the tree SystemClock_Config set up.  The PLL settings stay
+   * in PLLCFGR/PLLSAI1CFGR while the PLLs are off, so only the bus clock
+   * setup is kept here. */
+  HAL_RCC_GetClockConfig(&ClockConfigs[ClockFull], &ClockLatency[ClockFull]);
+  ClockConfigs[ClockFull].ClockType = RCC_CLOCKTYPE_HCLK |
+      RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+
+  /* ClockLow runs the same dividers from MSI at its 4MHz reset range - the
+   * range STOP2 also wakes up in.  Zero wait states up to 6MHz at range 2. */
+  ClockConfigs[ClockLow] = ClockConfigs[ClockFull];
+  ClockConfigs[ClockLow].SYSCLKSource = RCC_SYSCLKSOURCE_MSI;
+  ClockLatency[ClockLow] = FLASH_LATENCY_0;
+
+  ClockMode = ClockFull;
+  ClockModeStart = platform_current_time64();
 }
 
+/* The microsecond base - keep the count, reload only the prescaler */
+static void RetimeTickTimer(void)
+{
+  FSC_U32 count = TIM2->CNT;
+
+  TIM2->PSC = (SystemCoreClock / 1000000) - 1;
+  TIM2->EGR = TIM_EGR_UG;
+  TIM2->CNT = count;
+}
+
+static void RetimeI2C(void)
+{
+  FSC_U32 pclk = HAL_RCC_GetPCLK1Freq();
+  FSC_U32 i = 0;
+  FSC_U32 bus = 0;
+
+  for (i = 0; i < sizeof(I2CTimings) / sizeof(I2CTimings[0]); i++) {
+    if (I2CTimings[i].Hz != pclk) {
+      continue;
+    }
+
+    /* TIMINGR may only be written with the peripheral disabled */
+    for (bus = 0; bus < sizeof(I2CBuses) / sizeof(I2CBuses[0]); bus++) {
+      I2CBuses[bus]->CR1 &= ~I2C_CR1_PE;
+      I2CBuses[bus]->TIMINGR = I2CTimings[i].Timing;
+      I2CBuses[bus]->CR1 |= I2C_CR1_PE;
+    }
+    break;
+  }
+}
+
+#ifdef FSC_HAVE_UART
+static void RetimeUART(void)
+{
+  FSC_U32 pclk = HAL_RCC_GetPCLK1Freq();
+
+  /* BRR may only be written with the USART disabled */
+  USART2->CR1 &= ~USART_CR1_UE;
+  USART2->BRR = (pclk + (UART_BAUD_RATE / 2)) / UART_BAUD_RATE;
+  USART2->CR1 |= USART_CR1_UE;
+}
+#endif /* FSC_HAVE_UART */
+
+/* Switch SYSCLK and re-derive everything clocked from it in one go -
+ * nothing may use the timer, I2C or UART in between. */
+static void SwitchSystemClock(ClockMode_t mode)
+{
+  FSC_U32 primask = __get_PRIMASK();
+
+  __disable_irq();
+  HAL_RCC_ClockConfig(&ClockConfigs[mode], ClockLatency[mode]);
+  RetimeTickTimer();
+  RetimeI2C();
+#ifdef FSC_HAVE_UART
+  RetimeUART();
+#endif /* FSC_HAVE_UART */
+  __set_PRIMASK(primask);
+}
+
+FSC_BOOL platform_SetClockMode(ClockMode_t mode)
+{
+  FSC_U32 start = 0;
+  FSC_U64 now = 0;
+
+  if (mode == ClockMode) {
+    return TRUE;
+  }
+
+  if (mode == ClockLow) {
+#ifdef FSC_HAVE_FWUP
+    /* Flash latency can't change under a write */
+    if (StagingBusy) {
+      return FALSE;
+    }
+#endif /* FSC_HAVE_FWUP */
+#ifdef FSC_HAVE_USBHID
+    /* USB runs from PLLSAI1, which needs range 1 */
+    return FALSE;
+#endif /* FSC_HAVE_USBHID */
+#ifdef FSC_HAVE_UART
+    /* Let the debug output drain first */
+    if (UART_DMA->CCR & DMA_CCR_EN) {
+      return FALSE;
+    }
+#endif /* FSC_HAVE_UART */
+  }
+
+  start = TIM2->CNT;
+
+  if (mode == ClockFull) {
+    /* Range 1 before the frequency goes up.  HSE and PLL start while the
+     * core keeps running on MSI. */
+    HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE1);
+
+    RCC->CR |= RCC_CR_HSEON;
+    while (!(RCC->CR & RCC_CR_HSERDY)) {};
+    RCC->CR |= RCC_CR_PLLON;
+    while (!(RCC->CR & RCC_CR_PLLRDY)) {};
+
+    SwitchSystemClock(ClockFull);
+
+    RCC->CR |= RCC_CR_PLLSAI1ON;
+    while (!(RCC->CR & RCC_CR_PLLSAI1RDY)) {};
+  }
+  else {
+    RCC->CR |= RCC_CR_MSION;
+    while (!(RCC->CR & RCC_CR_MSIRDY)) {};
+
+    SwitchSystemClock(ClockLow);
+
+    /* Nothing else runs from HSE, HSI or the PLLs */
+    RCC->CR &= ~(RCC_CR_PLLSAI1ON | RCC_CR_PLLON);
+    RCC->CR &= ~(RCC_CR_HSEON | RCC_CR_HSION);
+
+    /* Range 2 once the frequency is down */
+    HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE2);
+  }
+
+  now = platform_current_time64();
+  ClockTimeUs[ClockMode] += now - ClockModeStart;
+  ClockModeStart = now;
+  ClockMode = mode;
+
+  ClockStats.SwitchCount[mode]++;
+  ClockStats.LastSwitchLatency[mode] = TIM2->CNT - start;
+  if (ClockStats.LastSwitchLatency[mode] > ClockStats.MaxSwitchLatency[mode]) {
+    ClockStats.MaxSwitchLatency[mode] = ClockStats.LastSwitchLatency[mode];
+  }
+
+  return TRUE;
+}
+
+ClockMode_t platform_GetClockMode(void)
+{
+  return ClockMode;
+}
+
+void platform_AccountClockPass(FSC_U32 elapsed)
+{
+  ClockStats.PassCount[ClockMode]++;
+  ClockStats.PassTime[ClockMode] += elapsed;
+  if (elapsed > ClockStats.MaxPassTime[ClockMode]) {
+    ClockStats.MaxPassTime[ClockMode] = elapsed;
+  }
+}
+
+const ClockStats_t *platform_GetClockStats(void)
+{
+  FSC_U64 now = platform_current_time64();
+  FSC_U32 i = 0;
+
+  for (i = 0; i < NUM_CLOCK_MODES; i++) {
+    ClockStats.TimeMs[i] = (FSC_U32)(ClockTimeUs[i] / 1000);
+  }
+  ClockStats.TimeMs[ClockMode] += (FSC_U32)((now - ClockModeStart) / 1000);
+
+  return &ClockStats;
+}
+#endif /* FSC_HAVE_LOWPOWER */
+
 #ifdef FSC_HAVE_UART
 void InitializeUART(void)
 {
@@ -406,7 +1274,7 @@ void InitializeUART(void)
   GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;
   GPIO_InitStruct.Pull      = GPIO_NOPULL;
   GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_HIGH;
-  GPIO_InitStruct.Alternate = GPIO_AF1_USART2;
+  GPIO_InitStruct.Alternate = GPIO_AF7_USART2;
 
   GPIO_InitStruct.Pin       = PIN_DBG_USART_RX;
   HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
@@ -417,29 +1285,63 @@ void InitializeUART(void)
   /* Set the Rx/Tx enable bits and the Rx interrupt enable bit */
   USART2->CR1 |= USART_CR1_RE | USART_CR1_TE | USART_CR1_RXNEIE;
 
-  /* Set the baud rate generator value. */
-  /* Other rates -> ? */
-  /* 115200 -> 0x000001A0 */
-  USART2->BRR = 0x000001A0;
+  /* Set the baud rate generator value from the current PCLK1 */
+  USART2->BRR = (HAL_RCC_GetPCLK1Freq() + (UART_BAUD_RATE / 2)) /
+                UART_BAUD_RATE;
 
   /* Enable DMA Transmit Mode */
   USART2->CR3 |= USART_CR3_DMAT;
 
   /* Enable! */
-  USART2->CR1 += USART_CR1_UE;
+  USART2->CR1 |= USART_CR1_UE;
 
-  /* Set up DMA Ch 4 to transfer to the USART TDR register */
-  DMA1_Channel4->CCR |= DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_TCIE;
-  DMA1_Channel4->CPAR = (FSC_U32)&(USART2->TDR);
+  /* Set up DMA Ch 7 to transfer to the USART TDR register */
+  DMA1_CSELR->CSELR = (DMA1_CSELR->CSELR & ~DMA_CSELR_C7S) | UART_DMA_REQUEST;
+  UART_DMA->CCR |= DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_TCIE;
+  UART_DMA->CPAR = (FSC_U32)&(USART2->TDR);
 
-  /* Enable and set DMA Ch 4 IRQ to clear completion flag */
-  HAL_NVIC_SetPriority(DMA1_Channel4_5_6_7_IRQn, 2, 0);
-  HAL_NVIC_EnableIRQ(DMA1_Channel4_5_6_7_IRQn);
+  /* Enable and set DMA Ch 7 IRQ to clear completion flag */
+  HAL_NVIC_SetPriority(DMA1_Channel7_IRQn, 2, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel7_IRQn);
 
-  /* Enable and set UART Rec Char Match IRQ */
+  /* Enable and set UART receive IRQ */
   HAL_NVIC_SetPriority(USART2_IRQn, 3, 0);
   HAL_NVIC_EnableIRQ(USART2_IRQn);
 }
+
+void UARTTxIRQHandler(void)
+{
+  /* Transfer done - ProcessUART may start the next buffer */
+  if (DMA1->ISR & DMA_ISR_TCIF7) {
+    DMA1->IFCR = DMA_IFCR_CTCIF7;
+    UART_DMA->CCR &= ~DMA_CCR_EN;
+  }
+}
+
+void UARTRxIRQHandler(void)
+{
+  FSC_U8 c = 0;
+
+  if (USART2->ISR & USART_ISR_ORE) {
+    USART2->ICR = USART_ICR_ORECF;
+  }
+
+  if (USART2->ISR & USART_ISR_RXNE) {
+    c = (FSC_U8)USART2->RDR;
+
+    /* Characters are dropped until the last line has been handled */
+    if (UARTRecHaveMsg) {
+      return;
+    }
+
+    if (c == '\r' || c == '\n') {
+      UARTRecHaveMsg = (UARTRecIndex > 0) ? TRUE : FALSE;
+    }
+    else if (UARTRecIndex < sizeof(UARTRecBuffer) - 1) {
+      UARTRecBuffer[UARTRecIndex++] = c;
+    }
+  }
+}
 #endif /* FSC_HAVE_UART */
 
 #ifdef FSC_HAVE_UART
@@ -459,18 +1361,20 @@ void HexToAscii(FSC_U32 value, FSC_U8 bytes, FSC_U8 *data)
 }
 #endif /* FSC_HAVE_UART */
 
-void platform_printf(FSC_U8 port, const char *msg, FSC_S32 value)
-{
 #ifdef FSC_HAVE_UART
+/* Time stamp, port number and message, as platform_printf starts a line */
+static void UARTLineStart(FSC_U8 port, const char *msg)
+{
   char *str = (char *)msg;
-  FSC_U8 data[8];
+  FSC_U64 now = platform_current_time64();
+  FSC_U32 seconds = (FSC_U32)(now / 1000000);
   FSC_U32 timeval = 0;
-  FSC_U32 timestamp = platform_timestamp();
   FSC_U32 i = 0;
 
-  /* Print time stamp seconds */
-  timeval = (timestamp & 0xFFFF0000) >> 16;
-  for (i = 1000; i != 0;) {
+  /* Print time stamp seconds, at least 4 digits */
+  timeval = seconds;
+  for (i = 1000000000; i > 1000 && i > timeval; i = i / 10) {}
+  for (; i != 0;) {
     FSC_U8 digit = timeval / i;
     WriteUART(digit + 0x30);
     timeval = timeval - (digit * i);
@@ -479,9 +1383,9 @@ void platform_printf(FSC_U8 port, const char *msg, FSC_S32 value)
 
   WriteUART('.');
 
-  /* Print time stamp tenths of milliseconds */
-  timeval = timestamp & 0x0000FFFF;
-  for (i = 1000; i != 0;) {
+  /* Print time stamp microseconds */
+  timeval = (FSC_U32)(now - (FSC_U64)seconds * 1000000);
+  for (i = 100000; i != 0;) {
     FSC_U8 digit = timeval / i;
     WriteUART(digit + 0x30);
     timeval = timeval - (digit * i);
@@ -493,19 +1397,14 @@ void platform_printf(FSC_U8 port, const char *msg, FSC_S32 value)
   /* Port Number */
   WriteUART('P');
 
-  switch(port) {
-  case 1:
-    WriteUART('1');
-    break;
-  case 2:
-    WriteUART('2');
-    break;
-  case 3:
-    WriteUART('3');
-    break;
-  default:
+  if (port > 0 && port <= BOARD_PORT_COUNT) {
+    if (port >= 10) {
+      WriteUART((port / 10) + 0x30);
+    }
+    WriteUART((port % 10) + 0x30);
+  }
+  else {
     WriteUART('X');
-    break;
   }
 
   WriteUART(' ');
@@ -513,6 +1412,16 @@ void platform_printf(FSC_U8 port, const char *msg, FSC_S32 value)
   /* String */
   while (*str != '\n' && *str != '\r' && *str != 0)
     WriteUART(*str++);
+}
+#endif /* FSC_HAVE_UART */
+
+void platform_printf(FSC_U8 port, const char *msg, FSC_S32 value)
+{
+#ifdef FSC_HAVE_UART
+  FSC_U8 data[8];
+  FSC_U32 i = 0;
+
+  UARTLineStart(port, msg);
 
   /* Optional Value */
   if (value >= 0) {
@@ -531,6 +1440,28 @@ void platform_printf(FSC_U8 port, const char *msg, FSC_S32 value)
 #endif /* FSC_HAVE_UART */
 }
 
+void platform_printbytes(FSC_U8 port, const char *msg,
+                         const FSC_U8 *bytes, FSC_U32 length)
+{
+#ifdef FSC_HAVE_UART
+  FSC_U8 data[2];
+  FSC_U32 i = 0;
+
+  UARTLineStart(port, msg);
+
+  for (i = 0; i < length; ++i) {
+    WriteUART(' ');
+    /* HexToAscii prints from the top nibble down */
+    HexToAscii((FSC_U32)bytes[i] << 24, 1, data);
+    WriteUART(data[0]);
+    WriteUART(data[1]);
+  }
+
+  WriteUART('\r');
+  WriteUART('\n');
+#endif /* FSC_HAVE_UART */
+}
+
 void WriteUART(FSC_S8 c)
 {
 #ifdef FSC_HAVE_UART
@@ -546,7 +1477,7 @@ void WriteUART(FSC_S8 c)
 void ProcessUART(void)
 {
   /* Try again later if transfer already in progress */
-  if (DMA1_Channel4->CCR & DMA_CCR_EN) {
+  if (UART_DMA->CCR & DMA_CCR_EN) {
     return;
   }
 
@@ -554,26 +1485,26 @@ void ProcessUART(void)
     /* Handle the Ping/Pong buffering */
     if (UARTXmitBuffer_IsPing) {
       /* Set the memory buffer address */
-      DMA1_Channel4->CMAR = (FSC_U32)UARTXmitBuffer_Ping;
+      UART_DMA->CMAR = (FSC_U32)UARTXmitBuffer_Ping;
 
       UARTXmitBuffer = UARTXmitBuffer_Pong;
       UARTXmitBuffer_IsPing = FALSE;
     }
     else {
       /* Set the memory buffer address */
-      DMA1_Channel4->CMAR = (FSC_U32)UARTXmitBuffer_Pong;
+      UART_DMA->CMAR = (FSC_U32)UARTXmitBuffer_Pong;
 
       UARTXmitBuffer = UARTXmitBuffer_Ping;
       UARTXmitBuffer_IsPing = TRUE;
     }
 
     /* Set the transfer size */
-    DMA1_Channel4->CNDTR = UARTXmitIndex;
+    UART_DMA->CNDTR = UARTXmitIndex;
 
     UARTXmitIndex = 0;
 
     /* Enable the transfer */
-    DMA1_Channel4->CCR |= DMA_CCR_EN;
+    UART_DMA->CCR |= DMA_CCR_EN;
   }
 }
 #endif /* FSC_HAVE_UART */
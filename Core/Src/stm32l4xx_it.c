@@ -23,6 +23,8 @@
 #include "stm32l4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "local_platform.h"
+#include "deadline.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -203,7 +205,7 @@ void SysTick_Handler(void)
 void EXTI9_5_IRQHandler(void)
 {
   /* USER CODE BEGIN EXTI9_5_IRQn 0 */
-
+  AlertIRQHandler();
   /* USER CODE END EXTI9_5_IRQn 0 */
   HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_6);
   /* USER CODE BEGIN EXTI9_5_IRQn 1 */
@@ -217,7 +219,10 @@ void EXTI9_5_IRQHandler(void)
 void TIM2_IRQHandler(void)
 {
   /* USER CODE BEGIN TIM2_IRQn 0 */
-
+  TickTimerIRQHandler();
+  if (DeadlineTimerIRQ()) {
+    DeadlineService();
+  }
   /* USER CODE END TIM2_IRQn 0 */
   HAL_TIM_IRQHandler(&htim2);
   /* USER CODE BEGIN TIM2_IRQn 1 */
@@ -226,6 +231,50 @@ void TIM2_IRQHandler(void)
 }
 
 /* USER CODE BEGIN 1 */
+/**
+  * @brief This function handles EXTI line[15:10] interrupts (ALERT lines).
+  */
+void EXTI15_10_IRQHandler(void)
+{
+  AlertIRQHandler();
+}
+
+#ifdef FSC_HAVE_LOWPOWER
+/**
+  * @brief This function handles LPTIM1 global interrupt (STOP2 wake-up).
+  */
+void LPTIM1_IRQHandler(void)
+{
+  LPTimerIRQHandler();
+}
+#endif /* FSC_HAVE_LOWPOWER */
+
+#ifdef FSC_HAVE_FWUP
+/**
+  * @brief This function handles FLASH global interrupt (staging writes).
+  */
+void FLASH_IRQHandler(void)
+{
+  HAL_FLASH_IRQHandler();
+}
+#endif /* FSC_HAVE_FWUP */
 
+#ifdef FSC_HAVE_UART
+/**
+  * @brief This function handles USART2 global interrupt (debug commands).
+  */
+void USART2_IRQHandler(void)
+{
+  UARTRxIRQHandler();
+}
+
+/**
+  * @brief This function handles DMA1 channel7 global interrupt (debug output).
+  */
+void DMA1_Channel7_IRQHandler(void)
+{
+  UARTTxIRQHandler();
+}
+#endif /* FSC_HAVE_UART */
 /* USER CODE END 1 */
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
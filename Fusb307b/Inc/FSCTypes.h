@@ -22,22 +22,29 @@
     #define __PACKED
 #endif
 
-/* Number of ports supported by the port manager */
+/* Maximum number of ports supported by the port manager.
+ * The ports actually in use come from the platform's board description.
+ * Hub builds may override this (e.g. -DFSC_NUMBER_OF_PORTS=16).
+ */
+#ifndef FSC_NUMBER_OF_PORTS
 #ifdef FSC_HAVE_MULTIPORT
 #define FSC_NUMBER_OF_PORTS 3
 #else
 #define FSC_NUMBER_OF_PORTS 1
 #endif /* FSC_HAVE_MULTIPORT */
+#endif /* FSC_NUMBER_OF_PORTS */
 
 typedef enum _BOOL { FALSE = 0, TRUE } FSC_BOOL;
 
 typedef signed char         FSC_S8;
 typedef signed short int    FSC_S16;
 typedef signed long int     FSC_S32;
+typedef signed long long    FSC_S64;
 
 typedef unsigned char       FSC_U8;
 typedef unsigned short int  FSC_U16;
 typedef unsigned long int   FSC_U32;
+typedef unsigned long long  FSC_U64;
 
 
 #endif /* _FSCTYPES_H_ */
@@ -124,6 +124,10 @@
 #define PD_15_V                 300
 #define PD_20_V                 400
 
+/* PPS output range (mV) - the widest a PPS APDO can offer */
+#define PPS_MIN_MV              3300
+#define PPS_MAX_MV              21000
+
 /* PD Current values in 10mA resolution */
 #define PD_0_9_A                90
 #define PD_1_5_A                150
@@ -170,7 +174,8 @@ typedef union {
     unsigned MaxCurrent:10;         /* Max current in 10mA units */
     unsigned Voltage:10;            /* Voltage in 50mV units */
     unsigned PeakCurrent:2;         /* Peak I (divergent from Ioc ratings) */
-    unsigned Reserved:3;            /* Reserved */
+    unsigned Reserved:2;            /* Reserved */
+    unsigned UnchunkedExtMsg:1;     /* Unchunked extended messages supported */
     unsigned DataRoleSwap:1;        /* Data role swap supported */
     unsigned USBCommCapable:1;      /* USB communications capable */
     unsigned ExternallyPowered:1;   /* Externally powered */
@@ -219,7 +224,8 @@ typedef union {
   struct {
     unsigned MinMaxCurrent:10;      /* Min/Max current in 10mA units */
     unsigned OpCurrent:10;          /* Operating current in 10mA units */
-    unsigned Reserved0:4;           /* Reserved - set to zero */
+    unsigned Reserved0:3;           /* Reserved - set to zero */
+    unsigned UnchunkedExtMsg:1;     /* Unchunked extended messages supported */
     unsigned NoUSBSuspend:1;        /* Set when the sink wants to continue
                                      * the contract during USB suspend
                                      * (i.e. charging battery)
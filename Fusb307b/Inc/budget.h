@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * @file     budget.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * Defines the source power budget manager.
+ *
+ * Every source port used to advertise its VIF capabilities, cut only to
+ * what its cable can carry, whatever the other ports were drawing.  Ports
+ * sharing one supply now share a budget of BUDGET_SUPPLY_MW (or whatever
+ * BudgetSetSupply gave) between them.
+ *
+ * Each attached source port is first given its Type-C current's power
+ * (the floor - it may draw that with no contract at all).  The rest is
+ * shared by water-filling: a port wants what its contract commits it to,
+ * or everything its capabilities could give if it has no contract yet or
+ * its sink flagged a capability mismatch, and no port gets more than it
+ * wants while another still wants more.  A sink that never answered the
+ * capabilities (PE_SRC_Disabled) wants only the floor.  That share is the port's target.
+ *
+ * DPM_PrepareSrcCaps cuts the capabilities the port sends to what it may
+ * offer: its target, less anything the other ports are still committed to
+ * above theirs, so the supply isn't over-promised while the others come
+ * down.  A port is held to what it was offered only while those
+ * capabilities are out - once its sink has answered, or given up, it is
+ * held to what it draws.  Only the floor can't be held back - a port that attaches while
+ * the others have it all puts the supply over by its floor until they
+ * have come down.  The objects are cut from a copy taken before any cut
+ * (budget_caps_), so a port's capabilities grow again as the budget frees.
+ *
+ * BudgetService looks at all of the ports on each pass.  When an attach,
+ * detach or new contract changes what the ports want, the targets are
+ * worked out again and a round starts:
+ *  - A port whose contract is over its target is sent GotoMin if its sink
+ *    will give back enough that way, or new Source_Capabilities otherwise.
+ *  - A port whose sink wants more and would now be offered more than it
+ *    was, or whose sink GotoMin took down below what it would now be
+ *    offered, is sent new Source_Capabilities.
+ * The round is over when every port it touched is back in PE_SRC_Ready
+ * with nothing left queued, and the time that took is kept.  A round that
+ * takes longer than ktBudgetConverge is given up on and counted - the
+ * sink's own timers (and a hard reset) bound it by then.
+ *
+ * Needs FSC_HAVE_SRC.
+ */
+#ifndef FSCPM_BUDGET_H_
+#define FSCPM_BUDGET_H_
+
+#include "platform.h"
+#include "PDTypes.h"
+
+#ifdef FSC_HAVE_BUDGET
+
+/* Power shared by the source ports */
+#ifndef BUDGET_SUPPLY_MW
+#define BUDGET_SUPPLY_MW        (60000)
+#endif /* BUDGET_SUPPLY_MW */
+
+/* Longest a round may take */
+#define ktBudgetConverge        (1000 * kMSTimeFactor)
+
+struct BudgetStats {
+  FSC_U32 rounds_;            /* Started */
+  FSC_U32 converged_;
+  FSC_U32 timeouts_;          /* Given up on */
+  FSC_U32 goto_mins_;         /* GotoMin sent */
+  FSC_U32 readvertised_;      /* Source_Capabilities sent */
+  FSC_U32 latency_;           /* Converged rounds, total */
+  FSC_U32 max_latency_;
+};
+
+struct Port;
+
+/* Take the port's capabilities as its uncut ones, and share the budget
+ * with it from now on */
+void BudgetInit(struct Port *port);
+
+/* The port's capabilities were replaced (caps_source_) */
+void BudgetCapsChanged(struct Port *port);
+
+/* Put back the uncut capabilities before they are prepared to send */
+void BudgetRestoreCaps(struct Port *port);
+
+/* Cut the capabilities about to be sent to the port's share */
+void BudgetApply(struct Port *port);
+
+/* Start and follow rounds - called on each pass */
+void BudgetService(void);
+
+/* Power the port's contract (or Type-C current) commits it to, in mW */
+FSC_U32 BudgetUsed(struct Port *port);
+
+void BudgetSetSupply(FSC_U32 mw);
+FSC_U32 BudgetGetSupply(void);
+
+const struct BudgetStats *BudgetGetStats(void);
+void BudgetClearStats(void);
+
+#endif /* FSC_HAVE_BUDGET */
+
+#endif /* FSCPM_BUDGET_H_ */
@@ -28,9 +28,21 @@ void core_state_machine(struct Port *port);
 
 FSC_U32 core_get_next_timeout(struct Port *port);
 
+/* TRUE if the port has nothing in progress - unattached, or attached and
+ * Ready with no AMS, swap, debounce or discovery timer running. */
+FSC_BOOL core_is_settled(struct Port *port);
+
 void core_enable_typec(struct Port *port, FSC_BOOL enable);
 void core_set_advertised_current(struct Port *port, USBTypeCCurrent src_cur);
 
+/* Sink: ask for a PPS output of mv at ma, 0 mv for fixed supplies again.
+ * A sink with a contract renegotiates straight away, so this also steps a
+ * PPS output at runtime.  A PPS APDO is only taken up to
+ * sink_request_max_voltage_.  Returns FALSE if mv is outside PPS range,
+ * or ma is 0 for an output.
+ */
+FSC_BOOL core_set_sink_pps(struct Port *port, FSC_U32 mv, FSC_U32 ma);
+
 FSC_U8 core_get_rev_lower(void);
 FSC_U8 core_get_rev_middle(void);
 FSC_U8 core_get_rev_upper(void);
@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * @file     deadline.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * Defines the deadline actions.
+ *
+ * A deadline action is a single TCPC register write that has to go out when
+ * a spec timer expires, however busy the main loop is with other ports.
+ * The policy engine arms an action against a TimerObj; the platform's
+ * deadline interrupt runs it at expiry and the state machine reconciles on
+ * its next pass (DeadlineFired).
+ *
+ * The interrupt only runs an action when the port's I2C bus is free and its
+ * ALERT line is quiet.  Otherwise the port's own pass runs it (DeadlinePoll)
+ * once any pending events have been handled, so an arrived response still
+ * gets the chance to cancel it.  An action only counts as run once its write
+ * has reached the TCPC; a failed write leaves it armed for DeadlinePoll.
+ */
+#ifndef FSCPM_DEADLINE_H_
+#define FSCPM_DEADLINE_H_
+
+#include "platform.h"
+#include "timer.h"
+
+/* Retry delay when the interrupt finds the I2C bus in use */
+#define ktDeadlineBusRetry      (100)
+
+typedef enum {
+  DeadlineHardReset = 0,      /* TRANSMIT a hard reset on tSenderResponse */
+  DeadlineTransmit,           /* TRANSMIT the message staged in TX_BUF */
+  NUM_DEADLINE_ACTIONS
+} DeadlineAction;
+
+typedef enum {
+  dlIdle = 0,
+  dlArmed,                    /* Waiting on its deadline */
+  dlFired,                    /* Written, not yet reconciled */
+} DeadlineState;
+
+struct DeadlineObj {
+  volatile DeadlineState state_;
+  FSC_U32 deadline_;          /* platform_current_time() at expiry */
+  FSC_U8 data_;               /* TRANSMIT register value */
+};
+
+struct Port;
+
+/* Arm an action for the expiry of timer (already started).
+ * The expiry time is captured here - later changes to the timer don't
+ * move the deadline, use DeadlineCancel.
+ */
+void DeadlineArm(struct Port *port, DeadlineAction action,
+                 struct TimerObj *timer, FSC_U8 data);
+
+/* Disarm.  Returns TRUE if the action had not run yet. */
+FSC_BOOL DeadlineCancel(struct Port *port, DeadlineAction action);
+
+/* TRUE if armed and not yet run */
+FSC_BOOL DeadlinePending(struct Port *port, DeadlineAction action);
+
+/* Microseconds until an armed action is due, 0 if due or not armed */
+FSC_U32 DeadlineRemaining(struct Port *port, DeadlineAction action);
+
+/* Returns TRUE once if the action ran since it was armed */
+FSC_BOOL DeadlineFired(struct Port *port, DeadlineAction action);
+
+/* Reset all of a port's actions (port/protocol reset) */
+void DeadlineReset(struct Port *port);
+
+/* Main loop fallback - run any of the port's actions that are due */
+void DeadlinePoll(struct Port *port);
+
+/* Deadline interrupt handler - runs due actions, re-arms for the next */
+void DeadlineService(void);
+
+#endif /* FSCPM_DEADLINE_H_ */
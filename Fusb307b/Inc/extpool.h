@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * @file     extpool.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * Defines the extended message buffer pool.
+ *
+ * Each port used to carry its own MAX_EXT_MSG_LEN byte buffer for extended
+ * messages, although a port only needs one while an extended message is
+ * being received, handled or sent, and that is rare - a PPS status, a
+ * manufacturer info or a firmware update exchange.  The buffers now live in
+ * a pool of EXTPOOL_BUFFERS shared by all of the ports, and a port leases
+ * one (protocol_ext_buffer_ points at it, 0 when it has none) for as long as
+ * it has extended message work in hand.
+ *
+ * A lease is taken for the first chunk received and by PolicySend for an
+ * extended message to send - or before that by whatever builds the message
+ * in place, as FwupCompose does.  It is given back once the port is in a Ready
+ * state with nothing extended left to receive, handle or send (ExtPoolService,
+ * each pass), when the next chunk never comes, and on a protocol reset.
+ *
+ * When the pool is empty:
+ *  - A message to send waits in PolicySend (STAT_BUSY) and the port sleeps
+ *    until a lease is given back, when the pool wakes it.
+ *  - A received message is dropped (counted) - it has been GoodCRC'd and
+ *    can't be pushed back, so the partner's response or chunk timer covers
+ *    it as it would for any lost message.
+ *
+ * RAM: with the Debug build's features plus FSC_HAVE_EXTENDED,
+ * sizeof(struct Port) went from 2164 to 1908 bytes when the pool went in -
+ * the buffer less a pointer, 256 a port.  (Sizes from the same layout as
+ * Debug/FUSB307B.map, where g_ports is one 752 byte port before any of it.)
+ * The pool adds 260 a buffer, 4 a buffer for Owner, 4 a port for Waiting and
+ * 20 for the stats, so g_ports plus the pool is:
+ *  - 3 ports, 2 buffers: 6492 bytes down to 5724 + 560 = 6284, 208 saved.
+ *  - 1 port, 1 buffer: 2164 bytes up to 1908 + 288 = 2196, 32 more.
+ * Each port past the third saves another 252.
+ */
+#ifndef FSCPM_EXTPOOL_H_
+#define FSCPM_EXTPOOL_H_
+
+#include "platform.h"
+#include "PDTypes.h"
+
+#ifdef FSC_HAVE_EXTENDED
+
+/* Buffers shared by all ports */
+#if FSC_NUMBER_OF_PORTS > 1
+#define EXTPOOL_BUFFERS         (2)
+#else
+#define EXTPOOL_BUFFERS         (1)
+#endif
+
+struct ExtPoolStats {
+  FSC_U32 leases_;            /* Buffers handed out */
+  FSC_U32 tx_waits_;          /* Sends held back by an empty pool */
+  FSC_U32 rx_drops_;          /* Received messages dropped for it */
+  FSC_U32 in_use_;
+  FSC_U32 high_;              /* Most buffers leased at once */
+};
+
+struct Port;
+
+/* Lease a buffer into protocol_ext_buffer_, if the port has none yet.
+ * Returns FALSE if the pool is empty.
+ */
+FSC_BOOL ExtPoolLease(struct Port *port);
+
+/* As ExtPoolLease, but the port is woken when a buffer is given back */
+FSC_BOOL ExtPoolLeaseOrWait(struct Port *port);
+
+/* Give the port's buffer back (reset, detach, dropped message) */
+void ExtPoolRelease(struct Port *port);
+
+/* Give the buffer back if the port is done with it - called on each pass */
+void ExtPoolService(struct Port *port);
+
+/* Count a received message dropped for want of a buffer */
+void ExtPoolRxDropped(struct Port *port);
+
+const struct ExtPoolStats *ExtPoolGetStats(void);
+
+#endif /* FSC_HAVE_EXTENDED */
+
+#endif /* FSCPM_EXTPOOL_H_ */
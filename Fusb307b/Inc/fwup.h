@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * @file     fwup.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * Defines the PD Firmware Update (PDFU) responder and initiator.
+ *
+ * PDFU runs over Firmware_Update_Request/Response extended messages, one
+ * response to each request.  The initiator sends GET_FW_ID, PDFU_INITIATE,
+ * the image as PDFU_DATA blocks of FWUP_BLOCK_SIZE bytes and then
+ * PDFU_VALIDATE.  An image goes to, or comes from, the platform's flash
+ * staging area.
+ *
+ * The responder takes each block out of the receive buffer into one of
+ * FWUP_BUFFERS block buffers and asks for the next block straight away.
+ * FwupService programs the buffers into the staging area in the background,
+ * so a block is written while the next one is on the wire.  Only when both
+ * buffers are still full does the response ask for the block again after a
+ * WaitTime.  Each block's CRC-32 is taken as it arrives and checked against
+ * the staged copy once it is written; a mismatch fails the update.
+ *
+ * One port at a time owns the staging area.  Needs FSC_HAVE_EXTENDED, and
+ * the _FWUP linker script, which keeps flash bank 2 out of the image for it.
+ */
+#ifndef FSCPM_FWUP_H_
+#define FSCPM_FWUP_H_
+
+#include "platform.h"
+
+#ifdef FSC_HAVE_FWUP
+
+#define FWUP_PROTOCOL_VERSION   (0x01)
+#define FWUP_HEADER_SIZE        (2)       /* Version, message type */
+#define FWUP_BLOCK_SIZE         (256)     /* PDFU_DATA payload */
+#define FWUP_BUFFERS            (2)
+
+/* Response time limit, request sent to response received */
+#define ktFwupResponse          (30 * kMSTimeFactor)
+
+/* WaitTime (ms) given while the staging area is being written */
+#define FWUP_WAIT_TIME          (5)
+
+/* Request message types - a response has the request's type less bit 7 */
+#define FWUP_GET_FW_ID          (0x81)
+#define FWUP_PDFU_INITIATE      (0x82)
+#define FWUP_PDFU_DATA          (0x83)
+#define FWUP_PDFU_DATA_NR       (0x84)
+#define FWUP_PDFU_VALIDATE      (0x85)
+#define FWUP_PDFU_ABORT         (0x86)
+#define FWUP_RESPONSE_MASK      (0x7F)
+
+typedef enum {
+  FwupOK = 0x00,
+  FwupErrTarget = 0x01,       /* Not now - busy with another port */
+  FwupErrWrite = 0x03,
+  FwupErrProg = 0x06,         /* Staging area program failed */
+  FwupErrVerify = 0x07,       /* Staged block CRC mismatch */
+  FwupErrAddress = 0x08,      /* Past the end of the staging area */
+  FwupErrNotDone = 0x09,      /* VALIDATE before the whole image */
+  FwupErrUnknown = 0x0E,      /* No response */
+  FwupErrUnexpectedRequest = 0x52,
+} FwupStatus;
+
+typedef enum {
+  FwupIdle = 0,
+  FwupReceiving,              /* Responder, PDFU_INITIATE to PDFU_VALIDATE */
+  FwupSending,                /* Initiator, fwup_request_ is the next one */
+} FwupState;
+
+struct Port;
+
+/* Drop an update in progress (reset, detach) */
+void FwupAbort(struct Port *port);
+
+/* Program received blocks - called on each pass */
+void FwupService(struct Port *port);
+
+/* Responder: handle the Firmware_Update_Request in protocol_ext_buffer_.
+ * Returns TRUE with the response built over it if there is one to send.
+ */
+FSC_BOOL FwupRequest(struct Port *port);
+
+/* Initiator: send the first length bytes of the staging area.
+ * Returns FALSE if an update is in progress or length is bad.
+ */
+FSC_BOOL FwupStart(struct Port *port, FSC_U32 length);
+
+/* Initiator: TRUE if the next request is due */
+FSC_BOOL FwupPending(struct Port *port);
+
+/* Initiator: build the next request in protocol_ext_buffer_, leasing one.
+ * Returns FALSE if the pool is empty - the port is woken when it isn't.
+ */
+FSC_BOOL FwupCompose(struct Port *port);
+
+/* Initiator: handle the Firmware_Update_Response in protocol_ext_buffer_ */
+void FwupResponse(struct Port *port);
+
+/* Initiator: the request failed to go out, or went unanswered */
+void FwupNoResponse(struct Port *port);
+
+#endif /* FSC_HAVE_FWUP */
+
+#endif /* FSCPM_FWUP_H_ */
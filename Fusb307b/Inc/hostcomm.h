@@ -38,8 +38,12 @@
 #define HOSTCOM_REV_LOW             0x2
 #define HOSTCOM_REV_HIGH            0x1
 
-/* The ProcessMessage function starts the decoding of messages from the GUI */
-void ProcessMsg(FSC_U8 *inMsgBuffer, FSC_U8 *outMsgBuffer, struct Port *port);
+/* The ProcessMessage function starts the decoding of messages from the GUI.
+ * Class commands address a port by their port byte (1 based); anything
+ * else goes to the first port.
+ */
+void ProcessMsg(FSC_U8 *inMsgBuffer, FSC_U8 *outMsgBuffer,
+                struct Port *ports, FSC_U8 num_ports);
 
 #endif /* FSC_HAVE_USBHID */
 #endif /* FSCPM_HOSTCOMM_H_ */
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * @file     linkstats.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * Defines the transmit statistics and the retry policy.
+ *
+ * The TCPC reports each transmit as a success (GoodCRC), a discard (an
+ * incoming message got the line first) or a failure (no GoodCRC after
+ * RETRY_CNT retries).  For each SOP* these are counted along with the time
+ * from TRANSMIT to the result, as a histogram in LINK_BUCKET_TIME steps.
+ *
+ * The TCPC doesn't say how many retries it used, so that is estimated:
+ * each retry adds a frame and a tReceive to the time to GoodCRC.  ALERT
+ * latency is counted too, which makes the estimate an upper bound.
+ *
+ * Retries and failures raise a link's noise score and clean first-time
+ * successes lower it; discards do the same to its contention score.  The
+ * policy engine asks LinkRetries for the RETRY_CNT to use - nRetryCount for
+ * the message's revision and never more, noisy link or not, which only
+ * counts the transmits made on a noisy link - and, as a source,
+ * LinkSinkTxTime for how long to hold SinkTxNG, stretched towards tSinkTx
+ * max as collisions mount.  The scores start over with each PD connection.
+ */
+#ifndef FSCPM_LINKSTATS_H_
+#define FSCPM_LINKSTATS_H_
+
+#include "platform.h"
+#include "PDTypes.h"
+
+#define LINK_BUCKETS            (8)
+#define LINK_BUCKET_TIME        (1 * kMSTimeFactor)
+
+/* RETRY_CNT is two bits */
+#define LINK_MAX_RETRIES        (3)
+
+/* Score (of 255) at which a link counts as noisy */
+#define LINK_NOISY              (96)
+
+typedef enum {
+  LinkSuccess = 0,
+  LinkDiscarded,
+  LinkFailed,
+} LinkResult;
+
+struct LinkStats {
+  FSC_U32 attempts_;          /* TRANSMIT written */
+  FSC_U32 success_;
+  FSC_U32 discards_;
+  FSC_U32 failures_;
+  FSC_U32 retries_;           /* Estimated, see above */
+  FSC_U32 busy_time_;         /* TRANSMIT to result, total */
+  FSC_U32 goodcrc_time_[LINK_BUCKETS];
+  FSC_U32 noisy_tx_;          /* Transmits while the link was noisy */
+  FSC_U8 noise_;
+  FSC_U8 contention_;
+};
+
+struct Port;
+
+/* Zero the counters */
+void LinkClear(struct Port *port);
+
+/* New PD connection - forget what was learned about the last one */
+void LinkRestart(struct Port *port);
+
+/* TRANSMIT written (or staged) for a frame of bytes, header included.
+ * timed is FALSE if the TCPC waits for SinkTxOK first.
+ */
+void LinkTxStarted(struct Port *port, SopType sop, FSC_U8 bytes,
+                   FSC_BOOL timed);
+
+/* The TCPC's result for the transmit started last */
+void LinkTxDone(struct Port *port, LinkResult result);
+
+/* RETRY_CNT for the next transmit on sop - spec, nRetryCount, at most */
+FSC_U8 LinkRetries(struct Port *port, SopType sop, FSC_U8 spec);
+
+/* How long a source holds SinkTxNG before an AMS */
+FSC_U32 LinkSinkTxTime(struct Port *port);
+
+#endif /* FSCPM_LINKSTATS_H_ */
@@ -0,0 +1,245 @@
+/*******************************************************************************
+ * @file     pdcodec.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * Defines the PD message codec.
+ *
+ * Headers and data objects have been taken apart wherever they were needed,
+ * through the bitfield unions in PDTypes.h and the get and getBitsFor
+ * converters in vdm.c, each checking what it cared to.  The codec puts the
+ * bit layouts of the message header, extended header, PDOs and APDOs, RDOs,
+ * the VDM header and the ID Header VDO in one place:
+ *
+ *  - Accessors (PdHdr*, PdExt*, PdPdo*, PdPps*, PdRdo*, PdVdm*, PdId*) take
+ *    one field out of a raw word, in spec units (mV, mA, mW) where the spec
+ *    has them.  They are static inline shift-and-mask, so on target they
+ *    cost what a bitfield read does and need no struct to be built.
+ *  - PdDecode checks a whole message - header, extended header and object
+ *    count against its length and type, reserved PDO types, an RDO's object
+ *    position - and decodes it in the same pass into a struct PdMessage.
+ *
+ * The codec needs only platform.h and PDTypes.h - no port, no registers -
+ * so host decoders and simulators build the same pdcodec.c and read
+ * messages exactly as the firmware does (tools/pdcodec_bench.c does).
+ * A message is the two header bytes followed by its data, which is also a
+ * sniffer frame from its third byte on.
+ */
+#ifndef FSCPM_PDCODEC_H_
+#define FSCPM_PDCODEC_H_
+
+#include "platform.h"
+#include "PDTypes.h"
+
+typedef enum {
+  PdCodecOK = 0,
+  PdCodecShort,               /* Fewer bytes than the header says */
+  PdCodecRevision,            /* Reserved spec revision */
+  PdCodecObjects,             /* Wrong object count for the type */
+  PdCodecExtended,            /* Extended header doesn't fit the message */
+  PdCodecInvalid,             /* A field has a value the spec doesn't allow */
+} PdCodecStatus;
+
+typedef enum {
+  PdPdoFixed = 0,
+  PdPdoBattery,
+  PdPdoVariable,
+  PdPdoPps,
+  PdPdoReserved,              /* An APDO type other than PPS */
+} PdPdoKind;
+
+/* Fixed PDO flags, bits 29-23 of the PDO */
+#define PD_PDO_DRP              (0x40)
+#define PD_PDO_SUSPEND          (0x20)  /* Source: USB Suspend supported */
+#define PD_PDO_HIGHER_CAP       (0x20)  /* Sink: higher capability */
+#define PD_PDO_EXT_POWERED      (0x10)
+#define PD_PDO_USB_COMM         (0x08)
+#define PD_PDO_DRD              (0x04)
+#define PD_PDO_UNCHUNKED        (0x02)
+
+struct PdPdo {
+  FSC_U8 kind_;               /* PdPdoKind */
+  FSC_U8 flags_;              /* PD_PDO_*, fixed PDOs only */
+  FSC_U16 min_mv_;            /* Fixed: the voltage */
+  FSC_U16 max_mv_;
+  FSC_U16 max_ma_;            /* 0 for a battery PDO */
+  FSC_U16 max_mw_;            /* Battery PDO only */
+};
+
+struct PdRdo {
+  FSC_U8 obj_pos_;            /* 1-7 */
+  FSC_U8 flags_;              /* Bits 27-23 of the RDO */
+  FSC_U32 word_;              /* The rest depends on the PDO - PdRdo* */
+};
+
+struct PdVdmHeader {
+  FSC_U16 svid_;
+  FSC_U8 structured_;
+  FSC_U8 version_;            /* Structured only, from here on */
+  FSC_U8 obj_pos_;
+  FSC_U8 cmd_type_;
+  FSC_U8 command_;
+  FSC_U16 vendor_;            /* Unstructured only - bits 14-0 */
+};
+
+struct PdMessage {
+  sopMainHeader_t header_;
+  sopExtendedHeader_t ext_header_;  /* Extended only */
+  FSC_U8 objects_;                  /* Data objects */
+  FSC_U16 bytes_;                   /* Extended data in this message */
+  const FSC_U8 *data_;              /* Extended data, in the caller's buffer */
+  FSC_U32 raw_[7];                  /* The data objects as they came */
+  union {
+    struct PdPdo pdo_[7];           /* Source/Sink Capabilities */
+    struct PdRdo rdo_;              /* Request */
+    struct PdVdmHeader vdm_;        /* Vendor Defined, raw_[1..] the VDOs */
+    FSC_U8 bist_mode_;              /* BIST */
+  };
+};
+
+/* Message header */
+static inline FSC_U8 PdHdrType(FSC_U16 h)     { return h & 0x1F; }
+static inline FSC_U8 PdHdrRevision(FSC_U16 h) { return (h >> 6) & 0x3; }
+static inline FSC_U8 PdHdrId(FSC_U16 h)       { return (h >> 9) & 0x7; }
+static inline FSC_U8 PdHdrObjects(FSC_U16 h)  { return (h >> 12) & 0x7; }
+static inline FSC_U8 PdHdrExtended(FSC_U16 h) { return (h >> 15) & 0x1; }
+
+/* Extended message header */
+static inline FSC_U16 PdExtSize(FSC_U16 e)    { return e & 0x1FF; }
+static inline FSC_U8 PdExtRequest(FSC_U16 e)  { return (e >> 10) & 0x1; }
+static inline FSC_U8 PdExtChunk(FSC_U16 e)    { return (e >> 11) & 0xF; }
+static inline FSC_U8 PdExtChunked(FSC_U16 e)  { return (e >> 15) & 0x1; }
+
+/* Power Data Objects */
+static inline FSC_U8 PdPdoType(FSC_U32 p)     { return (p >> 30) & 0x3; }
+static inline FSC_U8 PdApdoType(FSC_U32 p)    { return (p >> 28) & 0x3; }
+static inline FSC_U8 PdPdoFlags(FSC_U32 p)    { return (p >> 23) & 0x7F; }
+
+/* Fixed: the voltage.  Variable, battery: the minimum */
+static inline FSC_U16 PdPdoMinMv(FSC_U32 p)
+{
+  return (FSC_U16)(((p >> 10) & 0x3FF) * 50);
+}
+
+/* Variable, battery */
+static inline FSC_U16 PdPdoMaxMv(FSC_U32 p)
+{
+  return (FSC_U16)(((p >> 20) & 0x3FF) * 50);
+}
+
+/* Fixed, variable */
+static inline FSC_U16 PdPdoMaxMa(FSC_U32 p)
+{
+  return (FSC_U16)((p & 0x3FF) * 10);
+}
+
+/* Battery */
+static inline FSC_U16 PdPdoMaxMw(FSC_U32 p)
+{
+  return (FSC_U16)((p & 0x3FF) * 250);
+}
+
+/* PPS APDO */
+static inline FSC_U16 PdPpsMinMv(FSC_U32 p)
+{
+  return (FSC_U16)(((p >> 8) & 0xFF) * 100);
+}
+
+static inline FSC_U16 PdPpsMaxMv(FSC_U32 p)
+{
+  return (FSC_U16)(((p >> 17) & 0xFF) * 100);
+}
+
+static inline FSC_U16 PdPpsMaxMa(FSC_U32 p)
+{
+  return (FSC_U16)((p & 0x7F) * 50);
+}
+
+/* Request Data Objects */
+static inline FSC_U8 PdRdoObjPos(FSC_U32 r)   { return (r >> 28) & 0x7; }
+static inline FSC_U8 PdRdoFlags(FSC_U32 r)    { return (r >> 23) & 0x1F; }
+
+/* Fixed, variable: operating and maximum (or minimum, with GiveBack) */
+static inline FSC_U16 PdRdoOpMa(FSC_U32 r)
+{
+  return (FSC_U16)(((r >> 10) & 0x3FF) * 10);
+}
+
+static inline FSC_U16 PdRdoMaxMa(FSC_U32 r)
+{
+  return (FSC_U16)((r & 0x3FF) * 10);
+}
+
+/* Battery */
+static inline FSC_U16 PdRdoOpMw(FSC_U32 r)
+{
+  return (FSC_U16)(((r >> 10) & 0x3FF) * 250);
+}
+
+static inline FSC_U16 PdRdoMaxMw(FSC_U32 r)
+{
+  return (FSC_U16)((r & 0x3FF) * 250);
+}
+
+/* PPS */
+static inline FSC_U16 PdRdoPpsMv(FSC_U32 r)
+{
+  return (FSC_U16)(((r >> 9) & 0x7FF) * 20);
+}
+
+static inline FSC_U16 PdRdoPpsMa(FSC_U32 r)
+{
+  return (FSC_U16)((r & 0x7F) * 50);
+}
+
+/* VDM header */
+static inline FSC_U16 PdVdmSvid(FSC_U32 v)      { return (v >> 16) & 0xFFFF; }
+static inline FSC_U8 PdVdmStructured(FSC_U32 v) { return (v >> 15) & 0x1; }
+static inline FSC_U16 PdVdmVendor(FSC_U32 v)    { return v & 0x7FFF; }
+static inline FSC_U8 PdVdmVersion(FSC_U32 v)    { return (v >> 13) & 0x3; }
+static inline FSC_U8 PdVdmObjPos(FSC_U32 v)     { return (v >> 8) & 0x7; }
+static inline FSC_U8 PdVdmCmdType(FSC_U32 v)    { return (v >> 6) & 0x3; }
+static inline FSC_U8 PdVdmCommand(FSC_U32 v)    { return v & 0x1F; }
+
+static inline FSC_U32 PdVdmStructuredHeader(FSC_U16 svid, FSC_U8 version,
+                                            FSC_U8 obj_pos, FSC_U8 cmd_type,
+                                            FSC_U8 command)
+{
+  return ((FSC_U32)svid << 16) | (1UL << 15) | ((FSC_U32)(version & 0x3) << 13) |
+         ((FSC_U32)(obj_pos & 0x7) << 8) | ((FSC_U32)(cmd_type & 0x3) << 6) |
+         (command & 0x1F);
+}
+
+/* ID Header VDO (Discover Identity ACK) */
+static inline FSC_U8 PdIdHost(FSC_U32 v)        { return (v >> 31) & 0x1; }
+static inline FSC_U8 PdIdDevice(FSC_U32 v)      { return (v >> 30) & 0x1; }
+static inline FSC_U8 PdIdProductUfp(FSC_U32 v)  { return (v >> 27) & 0x7; }
+static inline FSC_U8 PdIdModal(FSC_U32 v)       { return (v >> 26) & 0x1; }
+static inline FSC_U8 PdIdProductDfp(FSC_U32 v)  { return (v >> 23) & 0x7; }
+static inline FSC_U16 PdIdVid(FSC_U32 v)        { return v & 0xFFFF; }
+
+/* Decode one PDO into out.  Returns PdCodecInvalid for a reserved type
+ * (out->kind_ is PdPdoReserved) - the other PDOs still decode.
+ */
+PdCodecStatus PdDecodePdo(FSC_U32 pdo, struct PdPdo *out);
+
+/* Check and decode a message - the header, then length bytes of data.
+ * out is filled as far as the message checks out.
+ */
+PdCodecStatus PdDecode(const FSC_U8 *msg, FSC_U16 length,
+                       struct PdMessage *out);
+
+#endif /* FSCPM_PDCODEC_H_ */
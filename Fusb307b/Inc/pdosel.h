@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * @file     pdosel.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * Defines the sink's PDO selection engine.
+ *
+ * PolicySinkEvaluateCaps used to take the highest power fixed or variable
+ * object, with sink_request_low_power_ as the only say in it.  Now every
+ * object - fixed, variable, battery and PPS - becomes a candidate and the
+ * port's score function (pdosel_score_, PdoScoreDefault unless the
+ * platform plugs in its own) rates it against the port's goals:
+ *
+ *  - power_weight_: the power the object can give, in mW.  Alone, as by
+ *    default, this picks the highest power object, as before.
+ *  - voltage_weight_: less for each mV away from preferred_mv_.
+ *  - efficiency_weight_: the sink's own conversion efficiency at the
+ *    object's voltage, from the eff_mv_/eff_pct_ curve.
+ *  - thermal_mw_: the most the sink may dissipate.  An object is only
+ *    counted for the power the sink can take within it, at the curve's
+ *    efficiency.
+ *
+ * A PPS APDO is a candidate at sink_pps_mv_ (core_set_sink_pps), or else
+ * at preferred_mv_, and is preferred outright when the sink asked for PPS.
+ * Objects past sink_request_max_voltage_ are never candidates.
+ *
+ * Partners send the same Source_Capabilities again and again - on every
+ * Get_Source_Cap, after a soft reset, on a PPS source's re-advertisement.
+ * The choice is kept, keyed by a hash of the capabilities and of the goals
+ * and limits that went into it, in a short per-port cache.  A hit is
+ * confirmed against the stored capabilities before it is used, and
+ * answers without scoring anything.
+ */
+#ifndef FSCPM_PDOSEL_H_
+#define FSCPM_PDOSEL_H_
+
+#include "platform.h"
+#include "PDTypes.h"
+
+/* Choices kept per port */
+#define PDOSEL_CACHE_LENGTH     (2)
+
+/* Points on the efficiency curve */
+#define PDOSEL_EFF_POINTS       (4)
+
+/* Score an asked-for PPS APDO wins by */
+#define PDOSEL_PPS_PREFERENCE   (0x40000000L)
+
+struct PdoGoals {
+  FSC_U32 preferred_mv_;      /* 0 for no preference */
+  FSC_U32 thermal_mw_;        /* Most the sink may dissipate, 0 for no limit */
+  FSC_U8 power_weight_;
+  FSC_U8 voltage_weight_;
+  FSC_U8 efficiency_weight_;
+  FSC_U16 eff_mv_[PDOSEL_EFF_POINTS];  /* Rising voltages */
+  FSC_U8 eff_pct_[PDOSEL_EFF_POINTS];  /* Efficiency at each */
+};
+
+struct PdoCandidate {
+  FSC_U8 position_;           /* 1-7 */
+  FSC_U8 kind_;               /* PdPdoKind */
+  FSC_U16 mv_;                /* Voltage it would run at */
+  FSC_U16 max_mv_;            /* Highest it can go - variable, battery */
+  FSC_U16 ma_;                /* Most current, 0 for battery */
+  FSC_U32 mw_;                /* Most power */
+  FSC_U8 eff_pct_;            /* Sink's efficiency at mv_ */
+};
+
+struct PdoCacheEntry {
+  FSC_U32 key_;               /* 0 for an empty entry */
+  FSC_U32 inputs_;            /* Goals and limits hash */
+  FSC_U8 count_;
+  FSC_U32 caps_[7];
+  struct PdoCandidate choice_;
+};
+
+struct PdoSelStats {
+  FSC_U32 hits_;
+  FSC_U32 misses_;
+  FSC_U32 eval_cycles_;       /* Misses - scoring, total */
+  FSC_U32 max_eval_cycles_;
+  FSC_U32 hit_cycles_;        /* Hits - hash and check, total */
+};
+
+struct Port;
+
+typedef FSC_S32 (*PdoScoreFn)(struct Port *port,
+                              const struct PdoCandidate *candidate);
+
+/* Default goals (highest power), empty cache */
+void PdoSelInit(struct Port *port);
+
+/* New goals - the cache no longer matches */
+void PdoSelSetGoals(struct Port *port, const struct PdoGoals *goals);
+
+/* Plug in a score function, 0 for PdoScoreDefault */
+void PdoSelSetScore(struct Port *port, PdoScoreFn score);
+
+/* Score on power, voltage, efficiency and PPS as the goals say */
+FSC_S32 PdoScoreDefault(struct Port *port,
+                        const struct PdoCandidate *candidate);
+
+/* Choose from caps_received_.  Returns FALSE if no object will do. */
+FSC_BOOL PdoSelect(struct Port *port, struct PdoCandidate *choice);
+
+#endif /* FSCPM_PDOSEL_H_ */
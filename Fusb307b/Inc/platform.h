@@ -69,6 +69,8 @@ typedef enum {
 } VBUS_LVL;
 
 void platform_printf(FSC_U8 port, const char *str, FSC_S32 value);
+void platform_printbytes(FSC_U8 port, const char *str,
+                         const FSC_U8 *bytes, FSC_U32 length);
 
 void platform_setHVSwitch(FSC_BOOL enable);
 FSC_BOOL platform_getHVSwitch(void);
@@ -88,34 +90,75 @@ FSC_U16 platform_getPPSCurrent(FSC_U8 port);
  ******************************************************************************/
 FSC_BOOL platform_get_device_irq_state(FSC_U8 port);
 
+/*******************************************************************************
+ * Function:        platform_get_alert_line
+ * Input:           Port ID (1 based)
+ * Return:          ID of the port's ALERT interrupt line, 0 if none
+ * Description:     Ports returning the same ID share a wire-OR ALERT line -
+ *                  platform_get_device_irq_state then reports the line, not
+ *                  the port.
+ ******************************************************************************/
+FSC_U8 platform_get_alert_line(FSC_U8 port);
+
 /*******************************************************************************
  * Function:        platform_i2c_write
- * Input:           SlaveAddress - Slave device bus address
+ * Input:           Bus - Platform I2C bus index
+ *                  SlaveAddress - Slave device bus address
  *                  RegisterAddress - Internal register address
  *                  DataLength - Length of data to transmit
  *                  Data - Buffer of char data to transmit
  * Return:          Error state
  * Description:     Write a char buffer to the I2C peripheral.
  ******************************************************************************/
-FSC_BOOL platform_i2c_write(FSC_U8 SlaveAddress,
+FSC_BOOL platform_i2c_write(FSC_U8 Bus,
+                            FSC_U8 SlaveAddress,
                             FSC_U8 RegisterAddress,
                             FSC_U8 DataLength,
                             FSC_U8* Data);
 
 /*******************************************************************************
  * Function:        platform_i2c_read
- * Input:           SlaveAddress - Slave device bus address
+ * Input:           Bus - Platform I2C bus index
+ *                  SlaveAddress - Slave device bus address
  *                  RegisterAddress - Internal register address
  *                  DataLength - Length of data to attempt to read
  *                  Data - Buffer for received char data
  * Return:          Error state.
  * Description:     Read char data from the I2C peripheral.
  ******************************************************************************/
-FSC_BOOL platform_i2c_read( FSC_U8 SlaveAddress,
+FSC_BOOL platform_i2c_read( FSC_U8 Bus,
+                            FSC_U8 SlaveAddress,
                             FSC_U8 RegisterAddress,
                             FSC_U8 DataLength,
                             FSC_U8* Data);
 
+/*******************************************************************************
+ * Function:        platform_i2c_block_read
+ * Input:           Bus - Platform I2C bus index
+ *                  SlaveAddress - Slave device bus address
+ *                  RegisterAddress - Internal register address
+ *                  MaxLength - Size of Data
+ *                  Data - Buffer for received char data
+ * Return:          Error state.
+ * Description:     Read a counted block in one transfer - the first byte
+ *                  read gives the number of bytes that follow it.  Reads
+ *                  at most MaxLength bytes in all.
+ ******************************************************************************/
+FSC_BOOL platform_i2c_block_read(FSC_U8 Bus,
+                                 FSC_U8 SlaveAddress,
+                                 FSC_U8 RegisterAddress,
+                                 FSC_U8 MaxLength,
+                                 FSC_U8* Data);
+
+/*******************************************************************************
+ * Function:        platform_i2c_busy
+ * Input:           Bus - Platform I2C bus index
+ * Return:          TRUE if a transfer on the bus is in progress
+ * Description:     Lets interrupt context code avoid a transfer it has
+ *                  preempted.
+ ******************************************************************************/
+FSC_BOOL platform_i2c_busy(FSC_U8 Bus);
+
 /*****************************************************************************
 * Function:        platform_enable_timer
 * Input:           enable - TRUE to enable platform timer, FALSE to disable
@@ -136,19 +179,126 @@ void platform_delay(FSC_U32 microseconds);
  * Function:        platform_current_time
  * Input:           None
  * Return:          Current system time value in microseconds
- * Description:     Provide a running system clock for timer implementations
+ * Description:     Provide a running system clock for timer implementations.
+ *                  This is the low 32 bits of platform_current_time64 - it
+ *                  wraps, so only compare differences.
  ******************************************************************************/
 FSC_U32 platform_current_time(void);
 
+/******************************************************************************
+ * Function:        platform_current_time64
+ * Input:           None
+ * Return:          Microseconds since boot
+ * Description:     Monotonic 64-bit system clock.  Does not wrap.
+ ******************************************************************************/
+FSC_U64 platform_current_time64(void);
+
+/******************************************************************************
+ * Function:        platform_cycle_count
+ * Input:           None
+ * Return:          Free-running CPU cycle count
+ * Description:     Profiling counter for code placement comparisons.
+ *                  Wraps - only compare differences.
+ ******************************************************************************/
+FSC_U32 platform_cycle_count(void);
+
+/******************************************************************************
+ * Function:        platform_set_deadline_timer
+ * Input:           microseconds - Time until the interrupt, 0 for now
+ * Return:          None
+ * Description:     Arm the deadline interrupt, which calls DeadlineService.
+ *                  Independent of the port wake-up timer.
+ ******************************************************************************/
+void platform_set_deadline_timer(FSC_U32 microseconds);
+
+/******************************************************************************
+ * Function:        platform_clear_deadline_timer
+ * Input:           None
+ * Return:          None
+ * Description:     Disarm the deadline interrupt.
+ ******************************************************************************/
+void platform_clear_deadline_timer(void);
+
+/******************************************************************************
+ * Function:        platform_enable_deadline_irq
+ * Input:           enable - FALSE to hold off the deadline interrupt
+ * Return:          None
+ * Description:     Brackets main loop updates to state shared with
+ *                  DeadlineService.  Not nestable.
+ ******************************************************************************/
+void platform_enable_deadline_irq(FSC_BOOL enable);
+
 /******************************************************************************
  * Function:        platform_timestamp
  * Input:           None
  * Return:          Encoded timestamp: 0xSSSSMMMM
  * Description:     Provide a timestamp encoded into 32 bits.
  *                  MSB's are seconds, LSB's are 10ths of milliseconds.
+ *                  Derived from platform_current_time64 - this is the state
+ *                  log format and its seconds field wraps at 65536.
  ******************************************************************************/
 FSC_U32 platform_timestamp(void);
 
+#ifdef FSC_HAVE_FWUP
+/******************************************************************************
+ * Function:        platform_staging_size
+ * Input:           None
+ * Return:          Size of the firmware update staging area in bytes
+ * Description:     The staging area is a flash region set aside for an
+ *                  incoming (or outgoing) firmware image.
+ ******************************************************************************/
+FSC_U32 platform_staging_size(void);
+
+/******************************************************************************
+ * Function:        platform_staging_data
+ * Input:           None
+ * Return:          The staging area, mapped for reading
+ * Description:     Reads see a write only once platform_staging_busy is
+ *                  FALSE.
+ ******************************************************************************/
+const FSC_U8 *platform_staging_data(void);
+
+/******************************************************************************
+ * Function:        platform_staging_write
+ * Input:           offset - Byte offset into the staging area, 8 aligned
+ *                  data - Bytes to program, kept until the write is done
+ *                  length - Number of bytes, a multiple of 8
+ * Return:          FALSE if a write is in progress or the range is bad
+ * Description:     Start programming the staging area in the background.
+ *                  A flash page is erased when a write reaches its start,
+ *                  so an image is written in order from a page boundary.
+ *                  platform_staging_service moves it along.
+ ******************************************************************************/
+FSC_BOOL platform_staging_write(FSC_U32 offset, const FSC_U8 *data,
+                                FSC_U32 length);
+
+/******************************************************************************
+ * Function:        platform_staging_busy
+ * Input:           None
+ * Return:          TRUE while a write is in progress
+ * Description:     Poll for the end of a platform_staging_write.
+ ******************************************************************************/
+FSC_BOOL platform_staging_busy(void);
+
+/******************************************************************************
+ * Function:        platform_staging_service
+ * Input:           None
+ * Return:          None
+ * Description:     Start the next erase or program of a write once the last
+ *                  one has ended.  Call from thread context while
+ *                  platform_staging_busy - not from an interrupt.
+ ******************************************************************************/
+void platform_staging_service(void);
+
+/******************************************************************************
+ * Function:        platform_staging_error
+ * Input:           None
+ * Return:          TRUE if the last write failed to erase or program
+ * Description:     Valid once platform_staging_busy is FALSE.
+ ******************************************************************************/
+FSC_BOOL platform_staging_error(void);
+#endif /* FSC_HAVE_FWUP */
+
 
 #ifdef FSC_HAVE_DP
 /******************************************************************************
@@ -39,6 +39,7 @@ void PolicySourceSendCaps(struct Port *port);
 void PolicySourceDisabled(struct Port *port);
 void PolicySourceTransitionDefault(struct Port *port);
 void PolicySourceNegotiateCap(struct Port *port);
+FSC_BOOL PolicySourceStartTransition(struct Port *port);
 void PolicySourceTransitionSupply(struct Port *port);
 void PolicySourceCapabilityResponse(struct Port *port);
 void PolicySourceReady(struct Port *port);
@@ -110,6 +111,12 @@ void PolicySinkGetSourceCapExt(struct Port *port);
 void PolicyGiveManufacturerInfo(struct Port *port);
 #endif /* FSC_HAVE_EXTENDED */
 
+#ifdef FSC_HAVE_FWUP
+void PolicySendFwUpdateRequest(struct Port *port);
+void PolicySendFwUpdateResponse(struct Port *port);
+void PolicyFwUpdateResponseReceived(struct Port *port);
+#endif /* FSC_HAVE_FWUP */
+
 void UpdateCapabilitiesRx(struct Port *port, FSC_BOOL is_source_cap_update);
 
 FSC_BOOL PolicySendHardReset(struct Port *port, PolicyState_t next_state,
@@ -127,6 +134,7 @@ FSC_U8 PolicySend(struct Port *port, FSC_U8 message_type,
 void ProcessDmtBist(struct Port *port);
 void PolicyBISTCarrierMode2(struct Port *port);
 void PolicyBISTTestData(struct Port *port);
+void PolicyBISTClearStats(struct Port *port);
 void PolicyInvalidState(struct Port *port);
 void ProcessCableResetState(struct Port *port);
 
@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * @file     policy_pt.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * Defines the policy state protothreads.
+ *
+ * A policy state written as a protothread is one linear flow that suspends
+ * where it waits and resumes right there on the port's next pass, instead of
+ * a policy_subindex_ switch that re-runs its guards on every pass.  The
+ * resume point is the source line of the wait, kept in policy_pt_, which
+ * set_policy_state clears - entering a state always starts its flow at the
+ * top.
+ *
+ *   void PolicyExample(struct Port *port)
+ *   {
+ *     FSC_U8 status = STAT_BUSY;
+ *
+ *     PT_BEGIN(port);
+ *     PT_SEND(port, status, PolicySend(port, CMTAccept, 0, 0,
+ *             PE_Example, PT_SENT, SOP_TYPE_SOP, FALSE));
+ *     if (PT_LEFT(port)) {
+ *       return;
+ *     }
+ *     PT_WAIT_UNTIL(port, TimerExpired(&port->policy_state_timer_));
+ *     ...
+ *     PT_END(port);
+ *   }
+ *
+ * Rules (it is a switch underneath):
+ *  - Locals don't survive a suspension - keep state in the Port.
+ *  - No PT macro inside a nested switch, and at most one per source line.
+ *  - No bare break in the flow body, outside of a nested switch or loop.
+ *  - Every path ends by leaving the state.  Once a send or a
+ *    set_policy_state may have left it, return before suspending again.
+ */
+#ifndef FSCPM_POLICY_PT_H_
+#define FSCPM_POLICY_PT_H_
+
+#include "port.h"
+
+/* PolicySend subindex for a send that stays in the state */
+#define PT_SENT                 (1)
+
+#define PT_BEGIN(port)                                                        \
+  switch ((port)->policy_pt_) {                                               \
+    case 0:
+
+#define PT_END(port)                                                          \
+      break;                                                                  \
+    default:                                                                  \
+      set_policy_state((port), PE_ErrorRecovery);                             \
+      break;                                                                  \
+  }
+
+/* Resume here on the next pass - the code that follows re-runs each pass
+ * until it moves on to a later point or leaves the state */
+#define PT_RESUME_POINT(port)                                                 \
+    (port)->policy_pt_ = __LINE__;                                            \
+    case __LINE__:
+
+/* Suspend (idle) until cond holds */
+#define PT_WAIT_UNTIL(port, cond)                                             \
+  do {                                                                        \
+    PT_RESUME_POINT(port);                                                    \
+    if (!(cond)) {                                                            \
+      (port)->idle_ = TRUE;                                                   \
+      return;                                                                 \
+    }                                                                         \
+  } while (0)
+
+/* Run a PolicySend until it is done with the message, status gets its
+ * result.  Pass PT_SENT as the subindex when next_state is this state.
+ * Done is sent, timed out or the state changed - as with the subindex form a
+ * collision retries. */
+#define PT_SEND(port, status, send)                                           \
+  do {                                                                        \
+    (port)->policy_subindex_ = 0;                                             \
+    PT_RESUME_POINT(port);                                                    \
+    (status) = (send);                                                        \
+    if ((port)->policy_pt_ == __LINE__ &&                                     \
+        (port)->policy_subindex_ != PT_SENT) {                                \
+      return;                                                                 \
+    }                                                                         \
+  } while (0)
+
+/* TRUE once the flow's state has been left */
+#define PT_LEFT(port)           ((port)->policy_pt_ == 0)
+
+#endif /* FSCPM_POLICY_PT_H_ */
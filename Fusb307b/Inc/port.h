@@ -28,6 +28,16 @@
 #include "log.h"
 #include "registers.h"
 #include "timer.h"
+#include "deadline.h"
+#include "template.h"
+#include "queue.h"
+#include "rxfifo.h"
+#include "linkstats.h"
+#include "fwup.h"
+#include "sniffer.h"
+#include "extpool.h"
+#include "pdosel.h"
+#include "budget.h"
 
 #ifdef FSC_HAVE_VDM
 #include "vdm_types.h"
@@ -78,6 +88,7 @@
  */
 struct Port {
   FSC_U8 port_id_;                  /* Each port has an "ID", one indexed */
+  FSC_U8 i2c_bus_;                  /* Platform I2C bus index */
   FSC_U8 i2c_addr_;                 /* Assigned hardware I2C address */
   DeviceReg_t registers_;           /* Chip register object */
   FSC_BOOL idle_;                   /* If true, may give up processor */
@@ -132,7 +143,14 @@ struct Port {
   FSC_BOOL pd_enabled_;               /* PD state machine enabled state */
   ProtocolState_t protocol_state_;
   PDTxStatus_t pd_tx_status_;
-  FSC_BOOL pd_tx_flag_;
+  struct PolicyRequest queue_[QUEUE_LENGTH]; /* Outbound requests, in order */
+  FSC_U8 queue_count_;
+  FSC_U8 queue_group_;                /* Sequence in progress */
+  FSC_U8 queue_last_group_;           /* Last handed out by QueueGroup */
+  FSC_U32 queue_started_;             /* Requests taken by QueueNext */
+  FSC_U32 queue_dropped_;             /* Requests lost to a full queue */
+  FSC_U32 queue_wait_;                /* Queued to started, total us */
+  FSC_U32 queue_max_wait_;
   SopType policy_msg_tx_sop_;
   FSC_BOOL req_dr_swap_to_dfp_as_sink_;        /* Request DR swap as sink */
   FSC_BOOL req_dr_swap_To_ufp_as_src_;         /* Request DR swap as source */
@@ -154,17 +172,49 @@ struct Port {
   SopType protocol_msg_tx_sop_;
   FSC_U8 protocol_retries_;
   FSC_BOOL protocol_use_sinktx_;
-  FSC_BOOL waiting_on_hr_;               /* Flag for hard reset shortcut */
+  struct TimerObj *protocol_tx_timer_;   /* Stage next TX until expiry */
+  FSC_U32 protocol_rx_count_;            /* Frames read */
+  FSC_U32 protocol_rx_cycles_;           /* CPU cycles handling them */
+  FSC_U32 protocol_max_rx_cycles_;
+  struct RxFrame protocol_rx_fifo_[RXFIFO_LENGTH]; /* Read, not yet handled */
+  FSC_U8 protocol_rx_fifo_head_;         /* Oldest frame */
+  FSC_U8 protocol_rx_fifo_count_;        /* Waiting, and taken if so */
+  FSC_BOOL protocol_rx_fifo_taken_;      /* Head frame is being handled */
+  FSC_U8 protocol_rx_fifo_high_;         /* Most frames waiting at once */
+  FSC_U32 protocol_rx_fifo_full_;        /* RX alerts left with the TCPC */
+  struct LinkStats link_stats_[NUM_SOP_SUPPORTED];
+  SopType link_tx_sop_;                  /* Transmit awaiting its result */
+  FSC_U8 link_tx_bytes_;
+  FSC_BOOL link_tx_timed_;
+  FSC_U32 link_tx_start_;                /* TRANSMIT written (us) */
+  FSC_BOOL protocol_tx_timed_;           /* tx_decided_ is for this message */
+  FSC_U32 protocol_tx_decided_;          /* PolicySend committed to it (us) */
+  FSC_U32 protocol_tx_count_;            /* Messages handed to TRANSMIT */
+  FSC_U32 protocol_tx_latency_;          /* Decision to TRANSMIT, total us */
+  FSC_U32 protocol_max_tx_latency_;
+  struct DeadlineObj deadline_[NUM_DEADLINE_ACTIONS];
 
 #ifdef FSC_HAVE_EXTENDED
-  FSC_U8 protocol_ext_buffer_[MAX_EXT_MSG_LEN];
+  FSC_U8 *protocol_ext_buffer_;          /* Leased from the pool, or 0 */
   FSC_U16 protocol_ext_num_bytes_;
   FSC_U8 protocol_ext_chunk_number_;
   FSC_U8 protocol_ext_request_chunk_;
   FSC_U8 protocol_ext_state_active_;
   FSC_BOOL protocol_ext_send_chunk_;
   FSC_U8 protocol_ext_request_cmd_;
+  struct {
+    /* TX frame for chunks and Chunk Requests, laid out as the other -
+     * policy_tx_data_obj_ may hold a VDM that PolicyGiveVdm still retries */
+    FSC_U8 protocol_chunk_head_[4];
+    doDataObject_t protocol_chunk_obj_[7];
+  };
   FSC_BOOL protocol_chunking_supported_; /* Allow chunked messages */
+  struct TimerObj protocol_chunk_timer_; /* Running while receiving chunks */
+  FSC_U32 protocol_ext_rx_start_;        /* Chunk 0 received (us) */
+  FSC_U32 protocol_ext_rx_count_;        /* Chunked messages received */
+  FSC_U32 protocol_ext_rx_time_;         /* Chunk 0 to last chunk, total us */
+  FSC_U32 protocol_ext_rx_max_time_;
+  FSC_U32 protocol_ext_rx_timeouts_;     /* Dropped - chunk timing missed */
 #ifdef FSC_HAVE_SRC
   ExtSrcCapBlock_t policy_src_cap_ext_;
 #endif /* FSC_HAVE_SRC */
@@ -176,6 +226,7 @@ struct Port {
   /* *** PD Policy port items */
   PolicyState_t policy_state_;           /* Policy SM */
   FSC_U8 policy_subindex_;               /* Policy SM */
+  FSC_U16 policy_pt_;                    /* Protothread resume point */
   FSC_BOOL policy_is_ams_;               /* Indicates start of Source AMS */
   SinkTxState_t policy_sinktx_state_;    /* Current SinkTx state */
 
@@ -190,10 +241,31 @@ struct Port {
   FSC_BOOL renegotiate_;                 /* Signal to re-negotiate contract */
   FSC_BOOL policy_wait_on_sink_caps_;    /* Flag to req sink caps after delay */
   FSC_BOOL needs_goto_min_;              /* DPM requested goto min */
+  FSC_BOOL bist_measure_;                /* Count BIST Test Data frames */
+  FSC_U32 bist_frames_;                  /* BIST Test Data frames read */
+  FSC_U32 bist_bytes_;                   /* Their header and data bytes */
+  FSC_U32 bist_repeats_;                 /* Retried - first try not GoodCRC'd */
+  FSC_U32 bist_overflows_;               /* RX_FULL - frames not taken */
+  FSC_U32 bist_other_;                   /* Anything else received */
+  FSC_U32 bist_first_;                   /* First frame read (us) */
+  FSC_U32 bist_last_;                    /* Last frame read (us) */
+  FSC_U8 bist_last_id_;
   sopMainHeader_t policy_rx_header_;     /* Header for PD messages received */
   sopMainHeader_t policy_tx_header_;     /* Header for PD messages to send */
-  doDataObject_t policy_rx_data_obj_[7]; /* Buffer for data objects received */
-  doDataObject_t policy_tx_data_obj_[7]; /* Buffer for data objects to send */
+  /* Received frame being handled, in its RX FIFO slot (RxFifoNext): from
+   * RXBYTECNT on, count, RXSTAT and header, then the data objects */
+  FSC_U8 *protocol_rx_head_;
+  doDataObject_t *policy_rx_data_obj_;   /* Data objects rec'd */
+  struct {
+    /* Frame to transmit: [0] spare - aligns the objects - then TXBYTECNT
+     * and the header, then the data objects.  Written from TXBYTECNT in
+     * one transfer (WriteTxFrame). */
+    FSC_U8 protocol_tx_head_[4];
+    doDataObject_t policy_tx_data_obj_[7]; /* Buffer for data objs to send */
+  };
+  struct TxTemplate policy_tx_template_[NUM_TX_TEMPLATES];
+  FSC_U16 policy_tx_template_gen_;       /* Moved on by TemplateInvalidate */
+  TxTemplateId policy_tx_template_id_;   /* Template of the message sent */
   sopMainHeader_t pd_transmit_header_;   /* PD packet to send */
   sopMainHeader_t caps_header_sink_;     /* Sink caps header */
   sopMainHeader_t caps_header_source_;   /* Source caps header */
@@ -223,6 +295,17 @@ struct Port {
 
   FSC_BOOL source_is_apdo_;
   doDataObject_t stored_apdo_;
+  FSC_U32 sink_pps_mv_;                  /* PPS output wanted, 0 for none */
+  FSC_U32 sink_pps_ma_;                  /* PPS operating current */
+  FSC_U32 sink_pps_requests_;            /* PPS Requests accepted */
+  FSC_U32 sink_pps_last_;                /* Last one accepted (us) */
+  FSC_U32 sink_pps_max_interval_;        /* Longest gap between them (us) */
+  struct PdoGoals pdosel_goals_;         /* What the sink's choice aims at */
+  PdoScoreFn pdosel_score_;
+  FSC_U16 pdosel_gen_;                   /* Goals or score function changed */
+  struct PdoCacheEntry pdosel_cache_[PDOSEL_CACHE_LENGTH];
+  FSC_U8 pdosel_next_;                   /* Cache entry to replace next */
+  struct PdoSelStats pdosel_stats_;
 
   /* *** Device Policy Manager (DPM) items */
   FSC_BOOL dpm_active_;                  /* DPM initialized and active */
@@ -252,8 +335,9 @@ struct Port {
   FSC_BOOL vdm_expecting_response_;      /* True if expecting a VDM response */
   FSC_BOOL vdm_sending_data_;
   VdmDiscoveryState_t vdm_auto_state_;
-  FSC_U32 vdm_msg_length_;
-  doDataObject_t vdm_msg_obj_[7];
+  FSC_U8 vdm_auto_group_;                /* Queue group of its steps */
+  FSC_U32 vdm_msg_length_;               /* Composed in policy_tx_data_obj_ */
+  TxTemplateId vdm_tx_template_;         /* Response template, or TplNone */
   SopType vdm_msg_tx_sop_;
   FSC_BOOL vdm_cbl_present_;             /* Avoid resets if querying SOP' id */
   FSC_BOOL vdm_check_cbl_;
@@ -277,6 +361,46 @@ struct Port {
 #endif /* FSC_HAVE_VDM */
   CableResetState_t cbl_rst_state_;
 
+#ifdef FSC_HAVE_BUDGET
+  /* Share of the source power budget */
+  doDataObject_t budget_caps_[7];        /* Source caps before the cut */
+  FSC_U32 budget_target_mw_;             /* Share of the supply */
+  FSC_U32 budget_offer_mw_;              /* Share the last caps gave */
+  FSC_U32 budget_contract_;              /* Contract GotoMin took down */
+  FSC_BOOL budget_goto_min_;
+  FSC_BOOL budget_pending_;              /* Waiting on a new contract */
+#endif /* FSC_HAVE_BUDGET */
+
+#ifdef FSC_HAVE_FWUP
+  /* PD firmware update */
+  FwupState fwup_state_;
+  FwupStatus fwup_status_;               /* Of the last update */
+  FSC_U8 fwup_request_;                  /* Initiator - next one to send */
+  FSC_U16 fwup_msg_len_;                 /* Built in protocol_ext_buffer_ */
+  FSC_U8 fwup_block_[FWUP_BUFFERS][FWUP_BLOCK_SIZE]; /* Received blocks */
+  FSC_U16 fwup_block_len_[FWUP_BUFFERS];
+  FSC_U16 fwup_block_index_[FWUP_BUFFERS];
+  FSC_U32 fwup_block_crc_[FWUP_BUFFERS];
+  FSC_U8 fwup_fill_;                     /* Buffer the next block goes in */
+  FSC_U8 fwup_queued_;                   /* Buffers waiting to be written */
+  FSC_BOOL fwup_writing_;                /* Oldest one is being written */
+  FSC_U16 fwup_next_block_;              /* Block to receive or send next */
+  FSC_U32 fwup_image_len_;               /* Initiator - bytes to send */
+  struct TimerObj fwup_timer_;           /* Initiator - WaitTime */
+  FSC_U32 fwup_start_;                   /* PDFU_INITIATE done */
+  FSC_U32 fwup_bytes_;                   /* Image bytes transferred */
+  FSC_U32 fwup_time_;                    /* us, last update */
+  FSC_U32 fwup_rate_;                    /* Bytes/s, last update */
+  FSC_U32 fwup_waits_;                   /* WaitTimes given or taken */
+  FSC_U32 fwup_crc_errors_;              /* Staged blocks that didn't match */
+#endif /* FSC_HAVE_FWUP */
+
+#ifdef FSC_HAVE_SNIFFER
+  /* Passive capture instead of the state machines */
+  FSC_BOOL sniffer_;
+  FSC_U32 sniffer_alert_time_;           /* ALERT edge of this pass (us) */
+#endif /* FSC_HAVE_SNIFFER */
+
 #ifdef FSC_LOGGING
   /* Log object */
   struct Log log_;
@@ -289,7 +413,8 @@ struct Port {
 
 /* Initialize the port and hardware interface. */
 /* Note: Must be called after hardware setup is complete (including I2C coms) */
-void InitializeVars(struct Port *port, FSC_U8 id, FSC_U8 i2c_addr_);
+void InitializeVars(struct Port *port, FSC_U8 id, FSC_U8 i2c_bus,
+                    FSC_U8 i2c_addr);
 void InitializePort(struct Port *port);
 
 /* Register Update Functions */
@@ -297,10 +422,10 @@ FSC_BOOL ReadRegister(struct Port *port, enum RegAddress regaddress);
 FSC_BOOL ReadRegisters(struct Port *port, enum RegAddress regaddr, FSC_U8 cnt);
 void ReadStatusRegisters(struct Port *port);
 void ReadAllRegisters(struct Port *port);
-void ReadRxRegisters(struct Port *port, FSC_U8 numbytes);
+FSC_BOOL ReadRxFrame(struct Port *port, FSC_U8 *frame);
 void WriteRegister(struct Port *port, enum RegAddress regaddress);
 void WriteRegisters(struct Port *port, enum RegAddress regaddr, FSC_U8 cnt);
-void WriteTxRegisters(struct Port *port, FSC_U8 numbytes);
+FSC_BOOL WriteTxFrame(struct Port *port, FSC_U8 *frame, FSC_U8 numbytes);
 void ClearInterrupt(struct Port *port, enum RegAddress address, FSC_U8 mask);
 void SendCommand(struct Port *port, enum DeviceCommand cmd);
 
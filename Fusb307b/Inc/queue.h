@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * @file     queue.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * Defines the outbound request queue.
+ *
+ * Messages the port is asked to send (by the host or the DPM) used to share
+ * a single slot, pd_transmit_header_/objects_, that a new request simply
+ * overwrote.  They now wait in a short per-port queue and the Ready state
+ * starts them one AMS at a time (QueueNext loads the slot).  When an AMS
+ * ends with requests still queued the next one starts in the same pass, and
+ * a source keeps SinkTxNG asserted in between, so a run of requests costs
+ * one tSinkTx wait, not one each.
+ *
+ * Requests go highest priority first, in order within a priority.  Requests
+ * queued under the same group (QueueGroup) form a sequence - discovery and
+ * mode entry, say - that, once started, runs to its end before anything
+ * else is started, whatever its priority.
+ *
+ * Besides the host, the Ready states queue the DPM's own requests: the
+ * discovery steps (one group, each queued as the last is answered),
+ * Get_Sink_Cap, renegotiation and the PPS re-request.
+ */
+#ifndef FSCPM_QUEUE_H_
+#define FSCPM_QUEUE_H_
+
+#include "platform.h"
+#include "PDTypes.h"
+
+/* Requests per port */
+#define QUEUE_LENGTH            (4)
+
+/* Group of a request that is a sequence of its own */
+#define QUEUE_NO_GROUP          (0)
+
+typedef enum {
+  QueuePriorityHigh = 0,      /* Contract - caps, requests, resets */
+  QueuePriorityNormal,
+  QueuePriorityLow,           /* Discovery and other VDMs */
+  NUM_QUEUE_PRIORITIES
+} QueuePriority;
+
+struct PolicyRequest {
+  sopMainHeader_t header_;
+  doDataObject_t objects_[7];
+  SopType sop_;
+  FSC_U8 priority_;
+  FSC_U8 group_;
+  FSC_U32 time_;              /* platform_current_time() queued */
+};
+
+struct Port;
+
+/* Empty the queue (reset, detach) */
+void QueueFlush(struct Port *port);
+
+/* A new group for a sequence of requests */
+FSC_U8 QueueGroup(struct Port *port);
+
+/* The priority a message gets by default */
+QueuePriority QueuePriorityOf(sopMainHeader_t header);
+
+/* Queue a message to send.  objects may be 0 for a control message.
+ * Returns FALSE if the queue is full - the request is dropped.
+ */
+FSC_BOOL QueueRequest(struct Port *port, SopType sop, sopMainHeader_t header,
+                      doDataObject_t *objects, QueuePriority priority,
+                      FSC_U8 group);
+
+/* TRUE if requests are waiting */
+FSC_BOOL QueuePending(struct Port *port);
+
+/* TRUE if a request of the sequence group is waiting */
+FSC_BOOL QueueHasGroup(struct Port *port, FSC_U8 group);
+
+/* TRUE if another request would be dropped */
+FSC_BOOL QueueFull(struct Port *port);
+
+/* Take the next request into pd_transmit_header_/objects_ and
+ * policy_msg_tx_sop_.  Returns FALSE if there is none.
+ */
+FSC_BOOL QueueNext(struct Port *port);
+
+#endif /* FSCPM_QUEUE_H_ */
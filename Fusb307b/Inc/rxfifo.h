@@ -0,0 +1,75 @@
+/*******************************************************************************
+ * @file     rxfifo.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * Defines the received message FIFO.
+ *
+ * The FUSB307B holds one received message, and won't GoodCRC the next one
+ * until RXSTAT is cleared.  A partner that sends back to back - a DP
+ * Attention then a Status, or a VDM that interrupts one in progress - used
+ * to be caught by waiting 3ms after each VDM and reading ALERTL again.
+ *
+ * Now each RX alert moves the frame into a short per-port FIFO and clears
+ * RXSTAT straight away, so the TCPC is ready for the next message.  The
+ * protocol layer hands the frames to the policy engine one at a time, in
+ * order, once it has taken the one before (protocol_msg_rx_ is clear).
+ * The policy engine reads the frame where it lies - protocol_rx_head_ and
+ * policy_rx_data_obj_ point into its slot, which stays taken until the next
+ * frame is handed over.
+ *
+ * If the FIFO is full RXSTAT is left set - the TCPC doesn't GoodCRC and the
+ * partner retries - rather than a frame being dropped.
+ */
+#ifndef FSCPM_RXFIFO_H_
+#define FSCPM_RXFIFO_H_
+
+#include "platform.h"
+#include "registers.h"
+
+/* Frames per port - one of them the frame being handled */
+#define RXFIFO_LENGTH           (5)
+
+/* RXBYTECNT, RXSTAT, the header and the data */
+#define RXFIFO_FRAME_SIZE       (4 + COMM_BUFFER_LENGTH)
+
+struct RxFrame {
+  union {
+    FSC_U8 frame_[RXFIFO_FRAME_SIZE];
+    FSC_U32 align_;             /* The data objects at frame_ + 4 */
+  };
+};
+
+struct Port;
+
+/* Empty the FIFO (reset, detach) */
+void RxFifoFlush(struct Port *port);
+
+/* On an RX alert: read the frame into the FIFO and clear RXSTAT.
+ * Returns FALSE if there was nothing to read or no room for it.
+ */
+FSC_BOOL RxFifoDrain(struct Port *port);
+
+/* TRUE if frames are waiting, besides the one being handled */
+FSC_BOOL RxFifoPending(struct Port *port);
+
+/* Free the frame being handled and point protocol_rx_head_ and
+ * policy_rx_data_obj_ at the oldest waiting one.
+ * Returns FALSE if there is none.
+ */
+FSC_BOOL RxFifoNext(struct Port *port);
+
+#endif /* FSCPM_RXFIFO_H_ */
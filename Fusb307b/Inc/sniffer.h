@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * @file     sniffer.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * Defines the PD sniffer.
+ *
+ * A port in sniffer mode has no Type-C or PD state machine.  It presents
+ * Open on both CC pins, never writes TRANSMIT and answers nothing, and has
+ * RXDETECT take every SOP*, Hard Reset and Cable Reset on the chosen CC.
+ * Each frame is read into a capture ring stamped with the ALERT edge that
+ * reported it, and RXSTAT is cleared at once so the TCPC is ready for the
+ * next one.  The host drains the ring over hostcomm.
+ *
+ * The TCPC still sends GoodCRC for what it receives - TCPCI has no way to
+ * stop it - so on a live link the sniffer's GoodCRC races the real
+ * receiver's.  Tap the link so the sniffer's CC transmitter isn't heard,
+ * or capture from a partner that talks to nothing else.
+ *
+ * A full ring drops the new frame (counted) rather than hold RXSTAT, which
+ * would only lose the frames behind it on the wire instead.  One port at a
+ * time owns the ring.
+ */
+#ifndef FSCPM_SNIFFER_H_
+#define FSCPM_SNIFFER_H_
+
+#include "platform.h"
+#include "rxfifo.h"
+
+#ifdef FSC_HAVE_SNIFFER
+
+/* Frames held for the host */
+#define SNIFFER_RING_LENGTH     (32)
+
+/* RXSTAT.RX_SOP of a Hard Reset record - 5 to 7 are unused */
+#define SNIFFER_HARD_RESET      (0x07)
+
+struct SnifferFrame {
+  FSC_U32 time_;              /* ALERT edge (us) */
+  FSC_U8 frame_[RXFIFO_FRAME_SIZE]; /* From RXBYTECNT, as ReadRxFrame */
+};
+
+struct SnifferStats {
+  FSC_U32 captured_;          /* Frames into the ring */
+  FSC_U32 bytes_;             /* Their header and data bytes */
+  FSC_U32 dropped_;           /* Frames lost to a full ring */
+  FSC_U32 high_;              /* Most frames waiting at once */
+  FSC_U32 start_;             /* Capture started (us) */
+};
+
+struct Port;
+
+/* Take the port out of service and capture on cc (CC1 or CC2).
+ * Returns FALSE if another port is capturing or cc is bad.
+ */
+FSC_BOOL SnifferStart(struct Port *port, FSC_U8 cc);
+
+/* Back to normal service - the port goes Unattached */
+void SnifferStop(struct Port *port);
+
+/* Capture whatever the TCPC has - the port's pass in sniffer mode */
+void SnifferService(struct Port *port);
+
+/* Take the oldest frame.  Returns FALSE if there is none. */
+FSC_BOOL SnifferNext(struct SnifferFrame *frame);
+
+/* Oldest frame's size as sent to the host, 0 if none */
+FSC_U8 SnifferNextSize(void);
+
+const struct SnifferStats *SnifferGetStats(void);
+
+#endif /* FSC_HAVE_SNIFFER */
+
+#endif /* FSCPM_SNIFFER_H_ */
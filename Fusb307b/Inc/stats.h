@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * @file     stats.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * Defines the run-time statistics report.
+ *
+ * The modules keep their own counters, in the port or, for those shared by
+ * all of the ports, in the module.  StatsReport writes out one class of them
+ * at a time as little-endian words.  The debug UART's "<port> st <class>
+ * [request bytes]" command prints them as a line of hex bytes; the USB host
+ * interface's user class command (the class ID is the command ID) does the
+ * same where that is built.  A class may take a request first - to clear its
+ * counters, or change a setting - and then reports.
+ */
+#ifndef FSCPM_STATS_H_
+#define FSCPM_STATS_H_
+
+#include "platform.h"
+
+/* Room a report may need */
+#define STATS_MAX_REPORT        (60)
+
+/* Class IDs - 0 and 1 are the host interface's own */
+#define STATS_LOWPOWER          (2)     /* Tickless idle */
+#define STATS_TASK              (3)     /* Per-port task CPU time */
+#define STATS_PASS              (4)     /* Scheduler pass cost */
+#define STATS_CLOCK             (5)     /* Clock governor */
+#define STATS_PROTOCOL          (6)     /* Protocol layer cost */
+#define STATS_TEMPLATE          (7)     /* Response templates */
+#define STATS_QUEUE             (8)     /* Outbound request queue */
+#define STATS_FWUP              (9)     /* PD firmware update */
+#define STATS_LINK              (10)    /* Transmit statistics */
+#define STATS_SNIFFER           (11)    /* PD sniffer */
+#define STATS_BIST              (12)    /* BIST Test Data reception */
+#define STATS_CODEC             (13)    /* PD codec cost */
+#define STATS_PPS               (14)    /* PPS sink */
+#define STATS_PDOSEL            (15)    /* PDO selection */
+#define STATS_BUDGET            (16)    /* Source power budget */
+
+typedef enum {
+  StatsOK = 0,
+  StatsFailed,                /* The class refused the request */
+  StatsNoClass,               /* Not a class in this build */
+} StatsStatus;
+
+struct Port;
+
+/* StatsReport
+ *
+ * Runs req, the request for class id, on port and then writes the class's
+ * report to buf.  len is the room in buf, at least STATS_MAX_REPORT.
+ */
+StatsStatus StatsReport(struct Port *port, FSC_U8 id, const FSC_U8 *req,
+                        FSC_U8 *buf, FSC_U8 len);
+
+#endif /* FSCPM_STATS_H_ */
@@ -24,8 +24,10 @@
 #include "platform.h"
 #include "port.h"
 
-/* Called from the while(1) loop, process events as needed */
-void SystemPolicyProcess(struct Port *ports);
+/* Called from the while(1) loop, process events as needed.
+ * ports is the port table, num_ports the number of configured ports.
+ */
+void SystemPolicyProcess(struct Port *ports, FSC_U8 num_ports);
 
 #endif /* FSCPM_SYSTEMPOLICY_H_ */
 
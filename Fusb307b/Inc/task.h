@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * @file     task.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * Defines a cooperative task per port.
+ *
+ * Each port's state machine runs as its own task.  A task is made ready by
+ * its ALERT line or by its next timer deadline (TaskWake, ISR safe) and the
+ * main loop gives every ready task one pass in turn.  No task blocks - the
+ * TCPC power-up wait is a timer, not a delay - so a slow port costs the
+ * others at most one state machine pass.
+ *
+ * All task code runs in the main loop context.  The shared services (I2C
+ * bus, observers, hostcomm, logging) are only used from there, so they are
+ * serialized by the scheduler itself; interrupt handlers touch nothing but
+ * the ready_ and alert_ flags.
+ *
+ * Ports may share a wire-OR ALERT line.  An edge on a shared line only
+ * marks its ports as candidates; TaskScanAlerts then reads the ALERTL/H
+ * pair of one candidate at a time (a single I2C transfer each), in port ID
+ * order, and wakes the first with an unmasked alert.  Only running ports
+ * take part - each line is scanned from its first running port, noted as
+ * tasks start, so a TCPC that never came up doesn't hide the others.  Ports found quiet
+ * are cached as such and scanned last on the next edge.  Should the line
+ * stay asserted once no port on it has work in hand - a second port
+ * asserted behind the first, without an edge of its own - the scan runs
+ * again.
+ */
+#ifndef FSCPM_TASK_H_
+#define FSCPM_TASK_H_
+
+#include "port.h"
+#include "timer.h"
+
+/* TCPC settle time after TCPC_INIT clears, before the port is configured */
+#define ktTaskStartup           (500 * kMSTimeFactor)
+
+typedef enum {
+  TaskWaitInit = 0,           /* Polling PWRSTAT for TCPC_INIT to clear */
+  TaskStartup,                /* Waiting out ktTaskStartup */
+  TaskRunning,                /* Port initialized, state machine active */
+} TaskState;
+
+struct PortTask {
+  struct Port *port_;
+  TaskState state_;
+  volatile FSC_BOOL ready_;     /* Set by ALERT and timer interrupts */
+  struct TimerObj start_timer_;
+
+  /* CPU time accounting, platform_current_time() resolution */
+  FSC_U32 run_count_;           /* State machine passes */
+  FSC_U32 run_time_;            /* Total time in the state machine */
+  FSC_U32 max_run_time_;        /* Longest single pass */
+
+  /* The same in CPU cycles - independent of the clock mode, so builds
+   * with and without the RAM hot set (.ramfunc) compare directly */
+  FSC_U32 run_cycles_;
+  FSC_U32 max_run_cycles_;
+
+  /* ALERT line handling */
+  FSC_U8 alert_line_;           /* platform_get_alert_line */
+  FSC_BOOL alert_shared_;       /* Other ports on the same line */
+  volatile FSC_BOOL alert_pending_; /* Shared line edge, source unknown */
+  FSC_BOOL alert_quiet_;        /* Last scan found no alert */
+  volatile FSC_BOOL alert_timed_;   /* alert_time_ awaits service */
+  volatile FSC_U32 alert_time_; /* Edge time */
+
+  /* Edge to service accounting, platform_current_time() resolution */
+  FSC_U32 alert_count_;         /* Edges serviced */
+  FSC_U32 alert_latency_;       /* Total edge to state machine pass time */
+  FSC_U32 max_alert_latency_;   /* Longest single edge to pass time */
+  FSC_U32 alert_reads_;         /* ALERT reads by shared line scans */
+};
+
+/* Main loop pass accounting - the cost of scanning every configured port */
+struct TaskPassStats {
+  FSC_U32 num_tasks_;           /* Tasks bound by TaskInitialize */
+  FSC_U32 pass_count_;          /* Scheduler passes */
+  FSC_U32 pass_time_;           /* Total time over all passes */
+  FSC_U32 max_pass_time_;       /* Longest single pass */
+  FSC_U32 pass_cycles_;         /* Total CPU cycles over all passes */
+  FSC_U32 max_pass_cycles_;     /* Most CPU cycles in a single pass */
+};
+
+/* Bind a task to its (already InitializeVars'd) port */
+void TaskInitialize(struct PortTask *task, struct Port *port);
+
+/* Mark the task ready for its next pass.  Safe from interrupt context. */
+void TaskWake(struct PortTask *task);
+
+/* ALERT edge on a line - wakes its port, or marks the ports sharing it for
+ * TaskScanAlerts.  Safe from interrupt context. */
+void TaskAlert(FSC_U8 line);
+
+/* Identify and wake the source of shared ALERT line edges.
+ * Call from the main loop ahead of each scheduler pass. */
+void TaskScanAlerts(void);
+
+/* TRUE if the task wants a pass - initializing, woken or not yet idle */
+FSC_BOOL TaskReady(struct PortTask *task);
+
+/* Give the task one pass.
+ * Returns TRUE when the port has gone idle and is waiting on an event - the
+ * caller should then re-arm the timer wake-up.
+ */
+FSC_BOOL TaskRun(struct PortTask *task);
+
+/* Look up the task bound to a port ID, or 0 if none */
+struct PortTask *TaskGet(FSC_U8 port_id);
+
+/* Bracket one scheduler pass over the task table.
+ * TaskPassEnd returns the time the pass took. */
+void TaskPassStart(void);
+FSC_U32 TaskPassEnd(void);
+
+const struct TaskPassStats *TaskGetPassStats(void);
+
+#endif /* FSCPM_TASK_H_ */
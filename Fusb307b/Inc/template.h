@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * @file     template.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * Defines the response templates.
+ *
+ * The replies the port sends most, and under the tightest response timers,
+ * come out the same every time for a given set of caps, roles and spec
+ * revision.  PolicySend keeps each one, encoded, in the port's template for
+ * it the first time it goes out (TemplateStore) and after that loads it
+ * straight into the transmit frame (TemplateLoad) - MessageID is still
+ * filled in by the protocol layer when the frame is written.
+ *
+ * A template is only good for the key it was built under: the port's power
+ * and data roles, the SOP spec revision and the template generation.  Any
+ * change to what goes into a template - caps, SVIDs, modes, identity - has
+ * to call TemplateInvalidate, which moves the generation on.
+ *
+ * Templates are SOP only.  The Discover responses are the UFP ACKs; the
+ * VDM block asks for one with vdm_tx_template_ (SendVdmFrame).
+ */
+#ifndef FSCPM_TEMPLATE_H_
+#define FSCPM_TEMPLATE_H_
+
+#include "platform.h"
+#include "PDTypes.h"
+
+typedef enum {
+  TplAccept = 0,
+  TplReject,
+  TplWait,
+  TplNotSupported,
+  TplPS_RDY,
+  TplSinkCaps,                /* From caps_sink_ */
+  TplSourceCaps,              /* From caps_source_ */
+  TplDiscoverIdentity,        /* Discover Identity ACK */
+  TplDiscoverSvids,           /* Discover SVIDs ACK */
+  TplDiscoverModes,           /* Discover Modes ACK for my_svid_ */
+  NUM_TX_TEMPLATES
+} TxTemplateId;
+
+/* Not sent from a template */
+#define TplNone                 (NUM_TX_TEMPLATES)
+
+struct TxTemplate {
+  FSC_U16 key_;               /* Built under, 0 - not built */
+  sopMainHeader_t header_;    /* MessageID left 0 */
+  doDataObject_t objects_[7];
+  FSC_U32 builds_;            /* Misses - encoded by PolicySend */
+  FSC_U32 count_;             /* Sent from the template */
+  FSC_U32 latency_;           /* Decision to TRANSMIT, total us */
+  FSC_U32 max_latency_;
+};
+
+struct Port;
+
+/* Drop all of the port's templates (statistics are kept) */
+void TemplateInvalidate(struct Port *port);
+
+/* The template for a PolicySend, TplNone if there isn't one */
+TxTemplateId TemplateFind(struct Port *port, FSC_U8 message_type,
+                          FSC_U16 num_bytes, FSC_U8 *data, SopType sop,
+                          FSC_BOOL extended);
+
+/* TRUE if the template is built for the port's current key */
+FSC_BOOL TemplateValid(struct Port *port, TxTemplateId id);
+
+/* Number of data objects in a valid template */
+FSC_U8 TemplateObjects(struct Port *port, TxTemplateId id);
+
+/* Load a valid template into policy_tx_header_/policy_tx_data_obj_.
+ * Returns FALSE (and loads nothing) if it isn't valid.
+ */
+FSC_BOOL TemplateLoad(struct Port *port, TxTemplateId id);
+
+/* Keep policy_tx_header_/policy_tx_data_obj_ as the template */
+void TemplateStore(struct Port *port, TxTemplateId id);
+
+/* Record a template's decision to TRANSMIT latency (us) */
+void TemplateTimed(struct Port *port, TxTemplateId id, FSC_U32 elapsed);
+
+#endif /* FSCPM_TEMPLATE_H_ */
@@ -66,6 +66,7 @@
 #define ktSrcTransitionSupply   (350 * kMSTimeFactor)
 #define ktSnkTransDefVbus       (150 * kMSTimeFactor)  /* 1.5s for VBus */
 #define ktSinkTx                (16 * kMSTimeFactor)
+#define ktSinkTxMax             (20 * kMSTimeFactor)
 #define ktChunkReceiverRequest  (15 * kMSTimeFactor)
 #define ktChunkReceiverResponse (15 * kMSTimeFactor)
 #define ktChunkSenderRequest    (30 * kMSTimeFactor)
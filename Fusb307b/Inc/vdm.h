@@ -53,7 +53,8 @@ void PolicyGiveVdm(struct Port *port);
 void ConvertAndProcessVdmMessage(struct Port *port);
 /*  Processes the port's current VDM command */
 void DoVdmCommand(struct Port *port);
-/*  This assumes we're already in either Source or Sink Ready states! */
+/*  Queues the next discovery step, under vdm_auto_group_.
+ *  This assumes we're already in either Source or Sink Ready states! */
 void AutoVdmDiscovery(struct Port *port);
 
 /*  Sends vdm messages */
@@ -61,6 +62,10 @@ void SendVdmMessage(struct Port *port, SopType sop, FSC_U32 *arr,
                     FSC_U32 length, PolicyState_t next_ps);
 void SendVdmMessageWithTimeout(struct Port *port, SopType sop, FSC_U32 *arr,
                     FSC_U32 length, PolicyState_t n_pe);
+/*  Sends a response kept as template tpl (template.h) - or from it, with
+ *  arr 0, while it is valid */
+void SendVdmResponse(struct Port *port, SopType sop, FSC_U32 *arr,
+                     FSC_U32 length, PolicyState_t next_ps, TxTemplateId tpl);
 
 /*
  * Initiations from DPM
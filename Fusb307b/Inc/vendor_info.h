@@ -70,6 +70,8 @@
 #define Responds_To_Discov_SOP_DFP NO
 #define Attempts_Discov_SOP NO
 #define Chunking_Implemented_SOP YES
+/* Must stay NO on the FUSB307B - its TX and RX buffers take 28 data bytes,
+ * one chunk, so an unchunked extended message can't be sent or received */
 #define Unchunked_Extended_Messages_Supported NO
 #define Security_Msgs_Supported_SOP NO
 
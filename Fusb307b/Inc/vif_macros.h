@@ -29,6 +29,7 @@ extern "C" {
                       .MaxCurrent        = Src_PDO_Max_Current##idx,\
                       .Voltage           = Src_PDO_Voltage##idx,\
                       .PeakCurrent       = Src_PDO_Peak_Current##idx,\
+                      .UnchunkedExtMsg   = Unchunked_Extended_Messages_Supported,\
                       .DataRoleSwap      = DR_Swap_To_UFP_Supported,\
                       .USBCommCapable    = USB_Comms_Capable,\
                       .ExternallyPowered = Unconstrained_Power,\
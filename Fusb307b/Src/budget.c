@@ -0,0 +1,581 @@
+/*******************************************************************************
+ * @file     budget.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * budget.c
+ *
+ * Implements the source power budget manager.
+ */
+
+#include "budget.h"
+#include "port.h"
+#include "queue.h"
+
+#ifdef FSC_HAVE_BUDGET
+
+#define FNV_OFFSET              (0x811C9DC5UL)
+#define FNV_PRIME               (0x01000193UL)
+
+static struct Port *Ports[FSC_NUMBER_OF_PORTS];
+
+static FSC_U32 Supply = BUDGET_SUPPLY_MW;
+
+/* What the ports wanted when the targets were last worked out */
+static FSC_U32 Signature;
+
+static FSC_BOOL RoundActive;
+static FSC_U32 RoundStart;
+
+static struct BudgetStats Stats;
+
+static FSC_BOOL BudgetAttached(struct Port *port)
+{
+  return (port->tc_state_ == AttachedSource ||
+          (port->tc_state_ == AttachedSink &&
+           port->pd_active_ && port->policy_is_source_)) ? TRUE : FALSE;
+}
+
+/* vSafe5V at the Type-C current - USB 3 default current for default */
+static FSC_U32 BudgetTypeC(struct Port *port)
+{
+  switch (port->src_current_) {
+    case utcc3p0A:
+      return 15000;
+    case utcc1p5A:
+      return 7500;
+    default:
+      return 4500;
+  }
+}
+
+/* Most an uncut object can give, in mW */
+static FSC_U32 BudgetPdoMw(doDataObject_t pdo)
+{
+  switch (pdo.PDO.SupplyType) {
+    case pdoTypeFixed:
+      return (pdo.FPDOSupply.Voltage * 50UL) *
+             (pdo.FPDOSupply.MaxCurrent * 10UL) / 1000;
+    case pdoTypeVariable:
+      return (pdo.VPDO.MaxVoltage * 50UL) * (pdo.VPDO.MaxCurrent * 10UL) / 1000;
+    case pdoTypeBattery:
+      return pdo.BPDO.MaxPower * 250UL;
+    case pdoTypeAugmented:
+      if (pdo.APDO.APDOType == apdoTypePPS) {
+        return (pdo.PPSAPDO.MaxVoltage * 100UL) *
+               (pdo.PPSAPDO.MaxCurrent * 50UL) / 1000;
+      }
+      return 0;
+    default:
+      return 0;
+  }
+}
+
+static FSC_U32 BudgetFull(struct Port *port)
+{
+  FSC_U32 mw = 0;
+  FSC_U32 full = BudgetTypeC(port);
+  FSC_U8 i = 0;
+
+  for (i = 0; i < port->caps_header_source_.NumDataObjects; ++i) {
+    mw = BudgetPdoMw(port->budget_caps_[i]);
+    full = (mw > full) ? mw : full;
+  }
+
+  return full;
+}
+
+static FSC_BOOL BudgetHasContract(struct Port *port)
+{
+  return (port->policy_has_contract_ &&
+          port->usb_pd_contract_.FVRDO.ObjectPosition > 0 &&
+          port->usb_pd_contract_.FVRDO.ObjectPosition <=
+          port->caps_header_source_.NumDataObjects) ? TRUE : FALSE;
+}
+
+/* TRUE while the contract is the one GotoMin took down */
+static FSC_BOOL BudgetAtMin(struct Port *port)
+{
+  return (port->budget_goto_min_ &&
+          port->usb_pd_contract_.object == port->budget_contract_) ?
+         TRUE : FALSE;
+}
+
+/* Power the contract would come down to on GotoMin, 0 if it can't */
+static FSC_U32 BudgetMin(struct Port *port)
+{
+  doDataObject_t rdo = port->usb_pd_contract_;
+  doDataObject_t pdo = port->budget_caps_[rdo.FVRDO.ObjectPosition - 1];
+
+  if (port->source_is_apdo_ || !rdo.FVRDO.GiveBack) {
+    return 0;
+  }
+
+  switch (pdo.PDO.SupplyType) {
+    case pdoTypeFixed:
+      return (pdo.FPDOSupply.Voltage * 50UL) *
+             (rdo.FVRDO.MinMaxCurrent * 10UL) / 1000;
+    case pdoTypeVariable:
+      return (pdo.VPDO.MaxVoltage * 50UL) *
+             (rdo.FVRDO.MinMaxCurrent * 10UL) / 1000;
+    case pdoTypeBattery:
+      return rdo.BRDO.MinMaxPower * 250UL;
+    default:
+      return 0;
+  }
+}
+
+/* Power the contract was made for, GotoMin or not */
+static FSC_U32 BudgetContract(struct Port *port)
+{
+  doDataObject_t rdo = port->usb_pd_contract_;
+  doDataObject_t pdo;
+
+  if (port->source_is_apdo_) {
+    return (rdo.PPSRDO.OpVoltage * 20UL) * (rdo.PPSRDO.OpCurrent * 50UL) / 1000;
+  }
+
+  pdo = port->budget_caps_[rdo.FVRDO.ObjectPosition - 1];
+  switch (pdo.PDO.SupplyType) {
+    case pdoTypeFixed:
+      return (pdo.FPDOSupply.Voltage * 50UL) *
+             (rdo.FVRDO.OpCurrent * 10UL) / 1000;
+    case pdoTypeVariable:
+      /* It may run anywhere up to the maximum */
+      return (pdo.VPDO.MaxVoltage * 50UL) *
+             (rdo.FVRDO.OpCurrent * 10UL) / 1000;
+    case pdoTypeBattery:
+      return rdo.BRDO.OpPower * 250UL;
+    default:
+      return BudgetTypeC(port);
+  }
+}
+
+FSC_U32 BudgetUsed(struct Port *port)
+{
+  if (!BudgetAttached(port)) {
+    return 0;
+  }
+
+  if (!BudgetHasContract(port)) {
+    return BudgetTypeC(port);
+  }
+
+  return BudgetAtMin(port) ? BudgetMin(port) : BudgetContract(port);
+}
+
+static FSC_BOOL BudgetWantsMore(struct Port *port)
+{
+  /* The mismatch bit is in the same place in every RDO */
+  return (!BudgetHasContract(port) ||
+          port->usb_pd_contract_.FVRDO.CapabilityMismatch) ? TRUE : FALSE;
+}
+
+static FSC_U32 BudgetDemand(struct Port *port)
+{
+  if (!BudgetAttached(port)) {
+    return 0;
+  }
+
+  /* A sink that never answered the caps only gets Type-C current */
+  if (!BudgetHasContract(port) && port->policy_state_ == PE_SRC_Disabled) {
+    return BudgetTypeC(port);
+  }
+
+  /* A sink sent to its minimum still wants what it gave back */
+  return BudgetWantsMore(port) ? BudgetFull(port) : BudgetContract(port);
+}
+
+/* Work out every port's target */
+static void BudgetRebalance(void)
+{
+  struct Port *port = 0;
+  FSC_U32 want[FSC_NUMBER_OF_PORTS];
+  FSC_U32 remaining = Supply;
+  FSC_U32 floor = 0;
+  FSC_U32 share = 0;
+  FSC_U32 give = 0;
+  FSC_U8 wanting = 0;
+  FSC_U8 i = 0;
+
+  for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+    want[i] = 0;
+    port = Ports[i];
+    if (port == 0) {
+      continue;
+    }
+
+    if (!BudgetAttached(port)) {
+      port->budget_target_mw_ = 0;
+      continue;
+    }
+
+    floor = BudgetTypeC(port);
+    port->budget_target_mw_ = floor;
+    remaining = (remaining > floor) ? remaining - floor : 0;
+    want[i] = BudgetDemand(port);
+    want[i] = (want[i] > floor) ? want[i] - floor : 0;
+  }
+
+  /* Each pass satisfies a port or hands out what is left */
+  for (;;) {
+    wanting = 0;
+    for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+      wanting += (want[i] > 0) ? 1 : 0;
+    }
+
+    share = wanting ? remaining / wanting : 0;
+    if (share == 0) {
+      break;
+    }
+
+    for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+      if (want[i] == 0) {
+        continue;
+      }
+
+      give = (want[i] < share) ? want[i] : share;
+      Ports[i]->budget_target_mw_ += give;
+      want[i] -= give;
+      remaining -= give;
+    }
+  }
+}
+
+/* TRUE while the sink has caps it hasn't answered - sent and GoodCRC'd,
+ * the request not yet settled */
+static FSC_BOOL BudgetCapsOut(struct Port *port)
+{
+  switch (port->policy_state_) {
+    case PE_SRC_Send_Capabilities:
+      /* Subindex 1 - the caps went, waiting on the request */
+      return (port->policy_subindex_ > 0) ? TRUE : FALSE;
+    case PE_SRC_Negotiate_Capability:
+    case PE_SRC_Transition_Supply:
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+
+/* What a port may be holding on to, in mW */
+static FSC_U32 BudgetCommitted(struct Port *port)
+{
+  FSC_U32 used = BudgetUsed(port);
+
+  if (!BudgetAttached(port)) {
+    return 0;
+  }
+
+  /* Its sink may yet ask for anything it was offered - only while the caps
+   * are out, not for a sink that never answered them (no contract) */
+  if (BudgetCapsOut(port)) {
+    return (port->budget_offer_mw_ > used) ? port->budget_offer_mw_ : used;
+  }
+
+  return used;
+}
+
+/* What the port's next caps would give it, in mW - its target, less what
+ * the others are holding above theirs, and never under its floor */
+static FSC_U32 BudgetOfferFor(struct Port *port)
+{
+  FSC_U32 others = 0;
+  FSC_U32 offer = 0;
+  FSC_U8 i = 0;
+
+  for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+    if (Ports[i] != 0 && Ports[i] != port) {
+      others += BudgetCommitted(Ports[i]);
+    }
+  }
+
+  offer = (Supply > others) ? Supply - others : 0;
+  offer = (port->budget_target_mw_ < offer) ? port->budget_target_mw_ : offer;
+
+  return (offer > BudgetTypeC(port)) ? offer : BudgetTypeC(port);
+}
+
+static FSC_U32 BudgetSignature(void)
+{
+  FSC_U32 hash = FNV_OFFSET;
+  FSC_U32 word = 0;
+  FSC_U8 i = 0;
+
+  hash = (hash ^ Supply) * FNV_PRIME;
+  for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+    if (Ports[i] != 0) {
+      word = (BudgetDemand(Ports[i]) << 1) | BudgetAttached(Ports[i]);
+      hash = (hash ^ word) * FNV_PRIME;
+    }
+  }
+
+  return hash;
+}
+
+static FSC_BOOL BudgetSend(struct Port *port, FSC_U8 message_type)
+{
+  sopMainHeader_t header;
+
+  if (message_type == CMTGotoMin) {
+    header.word = 0;
+    header.MessageType = CMTGotoMin;
+  }
+  else {
+    header.word = port->caps_header_source_.word;
+  }
+
+  return QueueRequest(port, SOP_TYPE_SOP, header, 0, QueuePriorityHigh,
+                      QUEUE_NO_GROUP);
+}
+
+/* Bring the ports to their new targets */
+static void BudgetRound(void)
+{
+  struct Port *port = 0;
+  FSC_U32 used = 0;
+  FSC_U32 min = 0;
+  FSC_BOOL sent = FALSE;
+  FSC_U8 i = 0;
+
+  BudgetRebalance();
+
+  for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+    port = Ports[i];
+    if (port == 0 || !BudgetAttached(port) || !BudgetHasContract(port) ||
+        port->budget_pending_) {
+      continue;
+    }
+
+    used = BudgetUsed(port);
+    min = BudgetAtMin(port) ? 0 : BudgetMin(port);
+
+    if (used > port->budget_target_mw_ &&
+        min > 0 && min <= port->budget_target_mw_) {
+      sent = BudgetSend(port, CMTGotoMin);
+      if (sent) {
+        port->budget_goto_min_ = TRUE;
+        port->budget_contract_ = port->usb_pd_contract_.object;
+        Stats.goto_mins_++;
+      }
+    }
+    else if (used > port->budget_target_mw_ ||
+             (BudgetWantsMore(port) &&
+              BudgetOfferFor(port) > port->budget_offer_mw_) ||
+             (BudgetAtMin(port) && BudgetOfferFor(port) > used)) {
+      /* Growing only if the caps would actually give more - else a round
+       * that ends with nothing to give would start another, and so on */
+      sent = BudgetSend(port, DMTSourceCapabilities);
+      Stats.readvertised_ += sent ? 1 : 0;
+    }
+    else {
+      continue;
+    }
+
+    if (!sent) {
+      /* Queue full - try again next pass */
+      Signature = 0;
+      continue;
+    }
+
+    port->budget_pending_ = TRUE;
+    if (!RoundActive) {
+      RoundActive = TRUE;
+      RoundStart = platform_current_time();
+      Stats.rounds_++;
+    }
+  }
+}
+
+/* Clear the ports that have their new contract, and end the round */
+static void BudgetFollow(void)
+{
+  struct Port *port = 0;
+  FSC_U32 elapsed = platform_current_time() - RoundStart;
+  FSC_BOOL pending = FALSE;
+  FSC_U8 i = 0;
+
+  for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+    port = Ports[i];
+    if (port == 0 || !port->budget_pending_) {
+      continue;
+    }
+
+    if (!BudgetAttached(port) ||
+        (port->policy_state_ == PE_SRC_Ready && !QueuePending(port))) {
+      port->budget_pending_ = FALSE;
+      /* It was passed over while pending - look at it again */
+      Signature = 0;
+    }
+    else if (elapsed > ktBudgetConverge) {
+      port->budget_pending_ = FALSE;
+    }
+    else {
+      pending = TRUE;
+    }
+  }
+
+  if (pending) {
+    return;
+  }
+
+  RoundActive = FALSE;
+  if (elapsed > ktBudgetConverge) {
+    Stats.timeouts_++;
+    return;
+  }
+
+  Stats.converged_++;
+  Stats.latency_ += elapsed;
+  if (elapsed > Stats.max_latency_) {
+    Stats.max_latency_ = elapsed;
+  }
+}
+
+void BudgetInit(struct Port *port)
+{
+  if (port->port_id_ == 0 || port->port_id_ > FSC_NUMBER_OF_PORTS) {
+    return;
+  }
+
+  Ports[port->port_id_ - 1] = port;
+
+  port->budget_target_mw_ = 0;
+  port->budget_offer_mw_ = 0;
+  port->budget_contract_ = 0;
+  port->budget_goto_min_ = FALSE;
+  port->budget_pending_ = FALSE;
+  BudgetCapsChanged(port);
+}
+
+void BudgetCapsChanged(struct Port *port)
+{
+  FSC_U8 i = 0;
+
+  for (i = 0; i < 7; ++i) {
+    port->budget_caps_[i].object = port->caps_source_[i].object;
+  }
+
+  Signature = 0;
+}
+
+void BudgetRestoreCaps(struct Port *port)
+{
+  FSC_U8 i = 0;
+
+  for (i = 0; i < 7; ++i) {
+    port->caps_source_[i].object = port->budget_caps_[i].object;
+  }
+}
+
+void BudgetApply(struct Port *port)
+{
+  doDataObject_t *pdo = 0;
+  FSC_U32 offer = 0;
+  FSC_U32 max = 0;
+  FSC_U32 mv = 0;
+  FSC_U8 i = 0;
+
+  BudgetRebalance();
+
+  offer = BudgetOfferFor(port);
+  port->budget_offer_mw_ = offer;
+
+  /* A new contract follows these caps - GotoMin no longer applies */
+  port->budget_goto_min_ = FALSE;
+
+  for (i = 0; i < port->caps_header_source_.NumDataObjects; ++i) {
+    pdo = &port->caps_source_[i];
+    switch (pdo->PDO.SupplyType) {
+      case pdoTypeFixed:
+        /* 10mA units */
+        mv = pdo->FPDOSupply.Voltage * 50UL;
+        max = mv ? offer * 100 / mv : 0;
+        if (pdo->FPDOSupply.MaxCurrent > max) {
+          pdo->FPDOSupply.MaxCurrent = max;
+        }
+        break;
+      case pdoTypeVariable:
+        mv = pdo->VPDO.MaxVoltage * 50UL;
+        max = mv ? offer * 100 / mv : 0;
+        if (pdo->VPDO.MaxCurrent > max) {
+          pdo->VPDO.MaxCurrent = max;
+        }
+        break;
+      case pdoTypeBattery:
+        /* 250mW units */
+        max = offer / 250;
+        if (pdo->BPDO.MaxPower > max) {
+          pdo->BPDO.MaxPower = max;
+        }
+        break;
+      case pdoTypeAugmented:
+        if (pdo->APDO.APDOType == apdoTypePPS) {
+          /* 50mA units */
+          mv = pdo->PPSAPDO.MaxVoltage * 100UL;
+          max = mv ? offer * 20 / mv : 0;
+          if (pdo->PPSAPDO.MaxCurrent > max) {
+            pdo->PPSAPDO.MaxCurrent = max;
+          }
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void BudgetService(void)
+{
+  FSC_U32 signature = BudgetSignature();
+
+  if (signature != Signature) {
+    Signature = signature;
+    BudgetRound();
+  }
+
+  if (RoundActive) {
+    BudgetFollow();
+  }
+}
+
+void BudgetSetSupply(FSC_U32 mw)
+{
+  Supply = mw;
+}
+
+FSC_U32 BudgetGetSupply(void)
+{
+  return Supply;
+}
+
+const struct BudgetStats *BudgetGetStats(void)
+{
+  return &Stats;
+}
+
+void BudgetClearStats(void)
+{
+  Stats.rounds_ = 0;
+  Stats.converged_ = 0;
+  Stats.timeouts_ = 0;
+  Stats.goto_mins_ = 0;
+  Stats.readvertised_ = 0;
+  Stats.latency_ = 0;
+  Stats.max_latency_ = 0;
+}
+
+#endif /* FSC_HAVE_BUDGET */
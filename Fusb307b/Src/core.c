@@ -21,25 +21,14 @@
 
 void core_initialize(struct Port *port)
 {
-  InitializeVars(port, 1, 0xA0);
+  InitializeVars(port, port->port_id_, port->i2c_bus_, port->i2c_addr_);
   InitializePort(port);
   platform_printf(port->port_id_, "Port Initialized.\n", -1);
 }
 
 void core_state_machine(struct Port *port)
 {
-  FSC_U8 data = TRANSMIT_HARDRESET;
-
   if (port->tc_enabled_ == TRUE) {
-    /* Hard reset timeout shortcut.
-     * Helps prevent driver interrupt latency issues
-     */
-    if (port->waiting_on_hr_ && TimerExpired(&port->policy_state_timer_)) {
-      /* Don't disable the timer here as we expect the states might be waiting for
-       * expiration. */
-      platform_i2c_write(port->i2c_addr_, regTRANSMIT, 1, &data);
-    }
-
     /* Read status registers for ALL chip features */
     ReadStatusRegisters(port);
 
@@ -49,8 +38,39 @@ void core_state_machine(struct Port *port)
       return;
     }
 
+#ifdef FSC_HAVE_SNIFFER
+    if (port->sniffer_) {
+      /* Capture only - no state machines */
+      SnifferService(port);
+      return;
+    }
+#endif /* FSC_HAVE_SNIFFER */
+
     /* TypeC/PD state machines */
     StateMachineTypeC(port);
+
+    /* Deadline actions the interrupt left to this pass */
+    DeadlinePoll(port);
+
+#ifdef FSC_HAVE_EXTENDED
+    /* Give back an extended message buffer the port is done with */
+    ExtPoolService(port);
+#endif /* FSC_HAVE_EXTENDED */
+
+#ifdef FSC_HAVE_BUDGET
+    /* Share the supply out again if what the ports want has changed */
+    BudgetService();
+#endif /* FSC_HAVE_BUDGET */
+
+    /* A message still in the RX FIFO goes to the policy engine next pass */
+    if (port->pd_active_ && RxFifoPending(port) && !port->protocol_msg_rx_) {
+      port->idle_ = FALSE;
+    }
+
+#ifdef FSC_HAVE_FWUP
+    /* Program firmware update blocks as the staging area frees up */
+    FwupService(port);
+#endif /* FSC_HAVE_FWUP */
   }
 }
 
@@ -93,16 +113,89 @@ FSC_U32 core_get_next_timeout(struct Port *port)
   time = TimerRemaining(&port->policy_sinktx_timer_);
   if (time > 0 && time < nexttime) nexttime = time;
 
+#ifdef FSC_HAVE_EXTENDED
+  time = TimerRemaining(&port->protocol_chunk_timer_);
+  if (time > 0 && time < nexttime) nexttime = time;
+#endif /* FSC_HAVE_EXTENDED */
+
+#ifdef FSC_HAVE_FWUP
+  time = TimerRemaining(&port->fwup_timer_);
+  if (time > 0 && time < nexttime) nexttime = time;
+#endif /* FSC_HAVE_FWUP */
+
   if (nexttime == 0xFFFFFFFF) nexttime = 0;
 
   return nexttime;
 }
 
+FSC_BOOL core_is_settled(struct Port *port)
+{
+  if (!port->idle_) {
+    return FALSE;
+  }
+
+  switch (port->tc_state_) {
+    case Disabled:
+    case Unattached:
+      /* The TCPC looks for a connection on its own */
+      return TRUE;
+    case AttachedSink:
+    case AttachedSource:
+      break;
+    default:
+      /* Attach, detach or role change in progress */
+      return FALSE;
+  }
+
+  if (port->pd_active_ &&
+      port->policy_state_ != PE_SRC_Ready &&
+      port->policy_state_ != PE_SNK_Ready) {
+    return FALSE;
+  }
+
+  /* The PPS keep-alive is left out - it expires into Ready, or leaves it */
+  if (!TimerDisabled(&port->policy_state_timer_) ||
+      !TimerDisabled(&port->no_response_timer_) ||
+      !TimerDisabled(&port->swap_source_start_timer_) ||
+      !TimerDisabled(&port->pd_debounce_timer_) ||
+      !TimerDisabled(&port->cc_debounce_timer_) ||
+      !TimerDisabled(&port->policy_sinktx_timer_)) {
+    return FALSE;
+  }
+
+#ifdef FSC_HAVE_VDM
+  if (!TimerDisabled(&port->vdm_timer_)) {
+    return FALSE;
+  }
+#endif /* FSC_HAVE_VDM */
+
+  return TRUE;
+}
+
 void core_set_advertised_current(struct Port *port, USBTypeCCurrent src_cur)
 {
     UpdateSourceCurrent(port, src_cur);
 }
 
+FSC_BOOL core_set_sink_pps(struct Port *port, FSC_U32 mv, FSC_U32 ma)
+{
+  /* An output with no current would be a Request for 0mA */
+  if (mv != 0 && (mv < PPS_MIN_MV || mv > PPS_MAX_MV || ma == 0)) {
+    return FALSE;
+  }
+
+  port->sink_pps_mv_ = mv;
+  port->sink_pps_ma_ = ma;
+
+  if (port->policy_has_contract_ && !port->policy_is_source_) {
+    /* Evaluate the caps again in Ready */
+    port->renegotiate_ = TRUE;
+    port->idle_ = FALSE;
+  }
+
+  return TRUE;
+}
+
 /*
  * Call this function to get the lower 8-bits of the core revision number.
  */
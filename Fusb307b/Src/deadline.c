@@ -0,0 +1,209 @@
+/*******************************************************************************
+ * @file     deadline.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * deadline.c
+ *
+ * Implements the deadline actions.
+ */
+
+#include "deadline.h"
+#include "port.h"
+#include "task.h"
+
+/* Ports with armed actions, by port ID (1 based) */
+static struct Port *Ports[FSC_NUMBER_OF_PORTS];
+
+static FSC_BOOL DeadlineDue(struct DeadlineObj *obj, FSC_U32 now)
+{
+  return ((FSC_S32)(now - obj->deadline_) >= 0) ? TRUE : FALSE;
+}
+
+/* Every action is one TRANSMIT register write - FALSE if it didn't reach
+ * the TCPC */
+static FSC_BOOL DeadlineRun(struct Port *port, struct DeadlineObj *obj)
+{
+  return platform_i2c_write(port->i2c_bus_, port->i2c_addr_,
+                            regTRANSMIT, 1, &obj->data_);
+}
+
+void DeadlineArm(struct Port *port, DeadlineAction action,
+                 struct TimerObj *timer, FSC_U8 data)
+{
+  struct DeadlineObj *obj = &port->deadline_[action];
+
+  if (port->port_id_ == 0 || port->port_id_ > FSC_NUMBER_OF_PORTS) {
+    return;
+  }
+
+  Ports[port->port_id_ - 1] = port;
+
+  platform_enable_deadline_irq(FALSE);
+  obj->deadline_ = timer->starttime_ + timer->period_;
+  obj->data_ = data;
+  obj->state_ = dlArmed;
+  platform_enable_deadline_irq(TRUE);
+
+  /* Let the interrupt pick up the new deadline */
+  platform_set_deadline_timer(0);
+}
+
+FSC_BOOL DeadlineCancel(struct Port *port, DeadlineAction action)
+{
+  struct DeadlineObj *obj = &port->deadline_[action];
+  FSC_BOOL pending = FALSE;
+
+  platform_enable_deadline_irq(FALSE);
+  if (obj->state_ == dlArmed) {
+    obj->state_ = dlIdle;
+    pending = TRUE;
+  }
+  platform_enable_deadline_irq(TRUE);
+
+  return pending;
+}
+
+FSC_BOOL DeadlinePending(struct Port *port, DeadlineAction action)
+{
+  return (port->deadline_[action].state_ == dlArmed) ? TRUE : FALSE;
+}
+
+FSC_U32 DeadlineRemaining(struct Port *port, DeadlineAction action)
+{
+  struct DeadlineObj *obj = &port->deadline_[action];
+  FSC_U32 now = platform_current_time();
+
+  if (obj->state_ != dlArmed || DeadlineDue(obj, now)) {
+    return 0;
+  }
+
+  return obj->deadline_ - now;
+}
+
+FSC_BOOL DeadlineFired(struct Port *port, DeadlineAction action)
+{
+  struct DeadlineObj *obj = &port->deadline_[action];
+  FSC_BOOL fired = FALSE;
+
+  platform_enable_deadline_irq(FALSE);
+  if (obj->state_ == dlFired) {
+    obj->state_ = dlIdle;
+    fired = TRUE;
+  }
+  platform_enable_deadline_irq(TRUE);
+
+  return fired;
+}
+
+void DeadlineReset(struct Port *port)
+{
+  FSC_U8 i = 0;
+
+  platform_enable_deadline_irq(FALSE);
+  for (i = 0; i < NUM_DEADLINE_ACTIONS; ++i) {
+    port->deadline_[i].state_ = dlIdle;
+  }
+  platform_enable_deadline_irq(TRUE);
+}
+
+void DeadlinePoll(struct Port *port)
+{
+  struct DeadlineObj *obj = 0;
+  FSC_U32 now = platform_current_time();
+  FSC_BOOL run = FALSE;
+  FSC_U8 i = 0;
+
+  for (i = 0; i < NUM_DEADLINE_ACTIONS; ++i) {
+    obj = &port->deadline_[i];
+
+    /* Claim it so the interrupt can't run it too */
+    platform_enable_deadline_irq(FALSE);
+    run = (obj->state_ == dlArmed && DeadlineDue(obj, now)) ?
+          TRUE : FALSE;
+    if (run) {
+      obj->state_ = dlFired;
+    }
+    platform_enable_deadline_irq(TRUE);
+
+    /* Left armed to try again on the next pass if the write failed */
+    if (run && !DeadlineRun(port, obj)) {
+      platform_enable_deadline_irq(FALSE);
+      obj->state_ = dlArmed;
+      platform_enable_deadline_irq(TRUE);
+      port->idle_ = FALSE;
+    }
+  }
+}
+
+void DeadlineService(void)
+{
+  struct Port *port = 0;
+  struct DeadlineObj *obj = 0;
+  FSC_U32 now = platform_current_time();
+  FSC_U32 next = ~0U;
+  FSC_U8 i = 0;
+  FSC_U8 j = 0;
+
+  for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+    port = Ports[i];
+    if (port == 0) {
+      continue;
+    }
+
+    for (j = 0; j < NUM_DEADLINE_ACTIONS; ++j) {
+      obj = &port->deadline_[j];
+      if (obj->state_ != dlArmed) {
+        continue;
+      }
+
+      if (!DeadlineDue(obj, now)) {
+        if (obj->deadline_ - now < next) {
+          next = obj->deadline_ - now;
+        }
+      }
+      else if (platform_get_device_irq_state(port->port_id_)) {
+        /* Events pending - the port's pass decides (DeadlinePoll).
+         * On a shared ALERT line they may be another port's, so make
+         * sure this one gets a pass. */
+        if (TaskGet(port->port_id_)) {
+          TaskWake(TaskGet(port->port_id_));
+        }
+      }
+      else if (platform_i2c_busy(port->i2c_bus_)) {
+        /* Interrupted a transfer - try again shortly */
+        if (ktDeadlineBusRetry < next) {
+          next = ktDeadlineBusRetry;
+        }
+      }
+      else if (DeadlineRun(port, obj)) {
+        obj->state_ = dlFired;
+      }
+      else if (TaskGet(port->port_id_)) {
+        /* Still armed - the port's pass tries again (DeadlinePoll) rather
+         * than this interrupt */
+        TaskWake(TaskGet(port->port_id_));
+      }
+    }
+  }
+
+  if (next < ~0U) {
+    platform_set_deadline_timer(next);
+  }
+  else {
+    platform_clear_deadline_timer();
+  }
+}
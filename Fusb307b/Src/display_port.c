@@ -60,6 +60,7 @@ void DP_Initialize(struct Port *port)
   }
 
   platform_dp_enable_pins(FALSE, 0);
+  TemplateInvalidate(port);
 }
 
 void DP_RequestPartnerStatus(struct Port *port)
@@ -139,6 +140,9 @@ void DP_SetPortMode(struct Port *port, DisplayPortMode_t conn)
   default:
     break;
   }
+
+  /* DpCap is the Discover Modes response */
+  TemplateInvalidate(port);
 }
 
 static FSC_BOOL DP_SelectPinAssignment(struct Port *port)
@@ -61,6 +61,12 @@ void DPM_PrepareSrcCaps(struct Port *port)
 {
   FSC_U8 i;
 
+#ifdef FSC_HAVE_BUDGET
+  /* Start from the uncut caps, so a cut doesn't outlive the cable or the
+   * budget share it was made for */
+  BudgetRestoreCaps(port);
+#endif /* FSC_HAVE_BUDGET */
+
   for (i = 0; i < port->caps_header_source_.NumDataObjects; ++i) {
     /* 3A or 5A adjustments to FPDO objects only */
     if (port->caps_source_[i].PDO.SupplyType == pdoTypeFixed)
@@ -87,7 +93,12 @@ void DPM_PrepareSrcCaps(struct Port *port)
     }
   }
 
+#ifdef FSC_HAVE_BUDGET
+  BudgetApply(port);
+#endif /* FSC_HAVE_BUDGET */
+
   port->dpm_src_caps_ready_ = TRUE;
+  TemplateInvalidate(port);
 }
 
 FSC_BOOL DPM_EvaluateRequest(struct Port *port)
@@ -0,0 +1,163 @@
+/*******************************************************************************
+ * @file     extpool.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * extpool.c
+ *
+ * Implements the extended message buffer pool.
+ */
+
+#include "extpool.h"
+#include "port.h"
+
+#ifdef FSC_HAVE_EXTENDED
+
+static FSC_U8 Buffers[EXTPOOL_BUFFERS][MAX_EXT_MSG_LEN];
+static struct Port *Owner[EXTPOOL_BUFFERS];
+
+/* Ports waiting in PolicySend for a buffer */
+static struct Port *Waiting[FSC_NUMBER_OF_PORTS];
+
+static struct ExtPoolStats Stats;
+
+static void ExtPoolWait(struct Port *port)
+{
+  FSC_U8 i = 0;
+
+  for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+    if (Waiting[i] == port) {
+      return;
+    }
+  }
+
+  for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+    if (Waiting[i] == 0) {
+      Waiting[i] = port;
+      return;
+    }
+  }
+}
+
+FSC_BOOL ExtPoolLease(struct Port *port)
+{
+  FSC_U8 i = 0;
+
+  if (port->protocol_ext_buffer_ != 0) {
+    return TRUE;
+  }
+
+  for (i = 0; i < EXTPOOL_BUFFERS; ++i) {
+    if (Owner[i] == 0) {
+      Owner[i] = port;
+      port->protocol_ext_buffer_ = Buffers[i];
+
+      Stats.leases_++;
+      Stats.in_use_++;
+      if (Stats.in_use_ > Stats.high_) {
+        Stats.high_ = Stats.in_use_;
+      }
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+FSC_BOOL ExtPoolLeaseOrWait(struct Port *port)
+{
+  if (ExtPoolLease(port)) {
+    return TRUE;
+  }
+
+  Stats.tx_waits_++;
+  ExtPoolWait(port);
+  return FALSE;
+}
+
+void ExtPoolRelease(struct Port *port)
+{
+  FSC_U8 i = 0;
+
+  for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+    if (Waiting[i] == port) {
+      Waiting[i] = 0;
+    }
+  }
+
+  if (port->protocol_ext_buffer_ == 0) {
+    return;
+  }
+
+  for (i = 0; i < EXTPOOL_BUFFERS; ++i) {
+    if (Owner[i] == port) {
+      Owner[i] = 0;
+      Stats.in_use_--;
+    }
+  }
+  port->protocol_ext_buffer_ = 0;
+
+  /* Wake up the ports waiting for it - the first to run gets it */
+  for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+    if (Waiting[i] != 0) {
+      Waiting[i]->idle_ = FALSE;
+      Waiting[i] = 0;
+    }
+  }
+}
+
+void ExtPoolService(struct Port *port)
+{
+  if (port->protocol_ext_buffer_ == 0) {
+    return;
+  }
+
+  /* Receiving or sending chunks, or the message not yet handled */
+  if (port->protocol_ext_state_active_ || port->protocol_msg_rx_) {
+    return;
+  }
+
+  switch (port->pd_tx_status_) {
+    case txPending:
+    case txSend:
+    case txBusy:
+    case txWait:
+      return;
+    default:
+      break;
+  }
+
+  /* Anything else still to do with it happens before going back to Ready */
+  if (port->policy_state_ != PE_SRC_Ready &&
+      port->policy_state_ != PE_SNK_Ready) {
+    return;
+  }
+
+  ExtPoolRelease(port);
+}
+
+void ExtPoolRxDropped(struct Port *port)
+{
+  Stats.rx_drops_++;
+  platform_printf(port->port_id_, "Ext Pool Empty - Rx Dropped\n", -1);
+}
+
+const struct ExtPoolStats *ExtPoolGetStats(void)
+{
+  return &Stats;
+}
+
+#endif /* FSC_HAVE_EXTENDED */
@@ -0,0 +1,470 @@
+/*******************************************************************************
+ * @file     fwup.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * fwup.c
+ *
+ * Implements the PD Firmware Update responder and initiator.
+ */
+
+#include "fwup.h"
+#include "extpool.h"
+#include "port.h"
+#include "vendor_info.h"
+#include "version.h"
+
+#ifdef FSC_HAVE_FWUP
+
+/* The port using the staging area, 0 if none */
+static struct Port *FwupOwner = 0;
+
+/* CRC-32 (IEEE 802.3) */
+static FSC_U32 FwupCrc(const FSC_U8 *data, FSC_U32 length)
+{
+  FSC_U32 crc = 0xFFFFFFFF;
+  FSC_U8 bit = 0;
+
+  while (length--) {
+    crc ^= *data++;
+    for (bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 0x1) ? 0xEDB88320 : 0);
+    }
+  }
+
+  return ~crc;
+}
+
+/* Buffer holding the oldest block not yet written */
+static FSC_U8 FwupOldest(struct Port *port)
+{
+  return (port->fwup_fill_ + FWUP_BUFFERS - port->fwup_queued_) %
+         FWUP_BUFFERS;
+}
+
+static void FwupClaim(struct Port *port, FwupState state)
+{
+  FwupOwner = port;
+  port->fwup_state_ = state;
+  port->fwup_status_ = FwupOK;
+  port->fwup_fill_ = 0;
+  port->fwup_queued_ = 0;
+  port->fwup_writing_ = FALSE;
+  port->fwup_next_block_ = 0;
+  port->fwup_bytes_ = 0;
+  port->fwup_waits_ = 0;
+  port->fwup_start_ = platform_current_time();
+}
+
+static void FwupFinish(struct Port *port, FwupStatus status)
+{
+  port->fwup_status_ = status;
+  port->fwup_state_ = FwupIdle;
+
+  /* Blocks not yet written are dropped */
+  port->fwup_queued_ = 0;
+  port->fwup_writing_ = FALSE;
+  TimerDisable(&port->fwup_timer_);
+
+  if (status == FwupOK) {
+    port->fwup_time_ = platform_current_time() - port->fwup_start_;
+    port->fwup_rate_ = (port->fwup_time_ == 0) ? 0 :
+        (FSC_U32)(((FSC_U64)port->fwup_bytes_ * 1000000) / port->fwup_time_);
+  }
+
+  if (FwupOwner == port) {
+    FwupOwner = 0;
+  }
+}
+
+/* Start a message in protocol_ext_buffer_ */
+static void FwupHeader(struct Port *port, FSC_U8 type)
+{
+  port->protocol_ext_buffer_[0] = FWUP_PROTOCOL_VERSION;
+  port->protocol_ext_buffer_[1] = type;
+  port->fwup_msg_len_ = FWUP_HEADER_SIZE;
+}
+
+/* Add a little endian field to protocol_ext_buffer_ */
+static void FwupPut(struct Port *port, FSC_U32 value, FSC_U8 bytes)
+{
+  while (bytes--) {
+    port->protocol_ext_buffer_[port->fwup_msg_len_++] = value & 0xFF;
+    value >>= 8;
+  }
+}
+
+void FwupAbort(struct Port *port)
+{
+  if (port->fwup_state_ != FwupIdle) {
+    FwupFinish(port, FwupErrUnknown);
+  }
+}
+
+void FwupService(struct Port *port)
+{
+  FSC_U8 b = 0;
+
+  if (port->fwup_queued_ == 0) {
+    return;
+  }
+
+  /* Keep the passes coming, and the part out of STOP2, until it's written */
+  port->idle_ = FALSE;
+
+  platform_staging_service();
+  if (platform_staging_busy()) {
+    return;
+  }
+
+  b = FwupOldest(port);
+  if (port->fwup_writing_) {
+    port->fwup_writing_ = FALSE;
+    port->fwup_queued_--;
+
+    if (platform_staging_error()) {
+      FwupFinish(port, FwupErrProg);
+      return;
+    }
+
+    if (FwupCrc(platform_staging_data() +
+                (FSC_U32)port->fwup_block_index_[b] * FWUP_BLOCK_SIZE,
+                port->fwup_block_len_[b]) != port->fwup_block_crc_[b]) {
+      port->fwup_crc_errors_++;
+      FwupFinish(port, FwupErrVerify);
+      return;
+    }
+
+    if (port->fwup_queued_ == 0) {
+      return;
+    }
+    b = FwupOldest(port);
+  }
+
+  /* Staging writes are in double words - the pad is 0xFF */
+  if (platform_staging_write(
+          (FSC_U32)port->fwup_block_index_[b] * FWUP_BLOCK_SIZE,
+          port->fwup_block_[b], (port->fwup_block_len_[b] + 7) & ~0x7)) {
+    port->fwup_writing_ = TRUE;
+  }
+}
+
+/* Responder: PDFU_DATA(_NR) - keep the block if it's the one wanted.
+ * The response goes over the request, so it's all read before the first put.
+ */
+static void FwupData(struct Port *port, const FSC_U8 *req, FSC_U16 len)
+{
+  FwupStatus status = FwupOK;
+  FSC_U8 wait = 0;
+  FSC_U16 index = 0;
+  FSC_U16 size = 0;
+  FSC_U16 i = 0;
+  FSC_U8 b = 0;
+
+  if (port->fwup_state_ != FwupReceiving) {
+    /* An update that failed says why */
+    status = (port->fwup_status_ != FwupOK) ? port->fwup_status_ :
+             FwupErrUnexpectedRequest;
+  }
+  else if (len < FWUP_HEADER_SIZE + 2) {
+    status = FwupErrUnexpectedRequest;
+  }
+  else {
+    index = req[2] | (req[3] << 8);
+    size = len - FWUP_HEADER_SIZE - 2;
+
+    if (index != port->fwup_next_block_) {
+      /* Not the block asked for - ask again */
+    }
+    else if ((FSC_U32)index * FWUP_BLOCK_SIZE != port->fwup_bytes_ ||
+             port->fwup_bytes_ + size > platform_staging_size()) {
+      /* After a short block, or past the end */
+      FwupFinish(port, FwupErrAddress);
+      status = FwupErrAddress;
+    }
+    else if (port->fwup_queued_ == FWUP_BUFFERS) {
+      /* Both buffers still to be written */
+      wait = FWUP_WAIT_TIME;
+      port->fwup_waits_++;
+    }
+    else {
+      b = port->fwup_fill_;
+      for (i = 0; i < size; ++i) {
+        port->fwup_block_[b][i] = req[FWUP_HEADER_SIZE + 2 + i];
+      }
+      for (; i < ((size + 7) & ~0x7); ++i) {
+        port->fwup_block_[b][i] = 0xFF;
+      }
+      port->fwup_block_len_[b] = size;
+      port->fwup_block_index_[b] = index;
+      port->fwup_block_crc_[b] = FwupCrc(port->fwup_block_[b], size);
+
+      port->fwup_fill_ = (b + 1) % FWUP_BUFFERS;
+      port->fwup_queued_++;
+      port->fwup_next_block_++;
+      port->fwup_bytes_ += size;
+    }
+  }
+
+  FwupPut(port, status, 1);
+  FwupPut(port, wait, 1);
+  FwupPut(port, 0, 1);                  /* NumDataNR */
+  FwupPut(port, port->fwup_next_block_, 2);
+}
+
+/* Responder: PDFU_VALIDATE - done once every block is written and checked */
+static void FwupValidate(struct Port *port)
+{
+  FwupStatus status = FwupOK;
+  FSC_U8 wait = 0;
+
+  if (port->fwup_state_ != FwupReceiving) {
+    status = (port->fwup_status_ != FwupOK) ? port->fwup_status_ :
+             FwupErrUnexpectedRequest;
+  }
+  else if (port->fwup_bytes_ == 0) {
+    FwupFinish(port, FwupErrNotDone);
+    status = FwupErrNotDone;
+  }
+  else if (port->fwup_queued_ > 0) {
+    wait = FWUP_WAIT_TIME;
+    port->fwup_waits_++;
+  }
+  else {
+    FwupFinish(port, FwupOK);
+  }
+
+  FwupPut(port, status, 1);
+  FwupPut(port, wait, 1);
+  FwupPut(port, 0, 1);                  /* Flags */
+}
+
+FSC_BOOL FwupRequest(struct Port *port)
+{
+  const FSC_U8 *req = port->protocol_ext_buffer_;
+  FSC_U16 len = port->protocol_ext_num_bytes_;
+  FSC_U8 type = 0;
+
+  if (len < FWUP_HEADER_SIZE || req[0] != FWUP_PROTOCOL_VERSION) {
+    return FALSE;
+  }
+
+  /* The response is built over the request */
+  type = req[1];
+  FwupHeader(port, type & FWUP_RESPONSE_MASK);
+
+  switch (type) {
+    case FWUP_GET_FW_ID:
+      FwupPut(port, FwupOK, 1);
+      FwupPut(port, Manufacturer_Info_VID_Port, 2);
+      FwupPut(port, Manufacturer_Info_PID_Port, 2);
+      FwupPut(port, 0, 1);              /* HW version */
+      FwupPut(port, 0, 1);              /* Silicon version */
+      FwupPut(port, FSC_TYPEC_CORE_FW_REV_UPPER, 2);
+      FwupPut(port, FSC_TYPEC_CORE_FW_REV_MIDDLE, 2);
+      FwupPut(port, FSC_TYPEC_CORE_FW_REV_LOWER, 2);
+      FwupPut(port, 0, 2);
+      FwupPut(port, 0, 1);              /* Image bank */
+      FwupPut(port, 0, 4);              /* Flags */
+      return TRUE;
+    case FWUP_PDFU_INITIATE:
+      if (FwupOwner != 0 && FwupOwner != port) {
+        FwupPut(port, FwupErrTarget, 1);
+      }
+      else {
+        FwupClaim(port, FwupReceiving);
+        FwupPut(port, FwupOK, 1);
+      }
+      FwupPut(port, 0, 1);              /* WaitTime */
+      FwupPut(port, platform_staging_size(), 3);
+      return TRUE;
+    case FWUP_PDFU_DATA:
+      FwupData(port, req, len);
+      return TRUE;
+    case FWUP_PDFU_DATA_NR:
+      FwupData(port, req, len);
+      return FALSE;
+    case FWUP_PDFU_VALIDATE:
+      FwupValidate(port);
+      return TRUE;
+    case FWUP_PDFU_ABORT:
+      FwupAbort(port);
+      return FALSE;
+    default:
+      FwupPut(port, FwupErrUnexpectedRequest, 1);
+      return TRUE;
+  }
+}
+
+/* Initiator: the next PDFU_DATA, or PDFU_VALIDATE after the last block */
+static void FwupNextData(struct Port *port)
+{
+  port->fwup_request_ =
+      ((FSC_U32)port->fwup_next_block_ * FWUP_BLOCK_SIZE >=
+       port->fwup_image_len_) ? FWUP_PDFU_VALIDATE : FWUP_PDFU_DATA;
+}
+
+/* Initiator: PDFU_DATA with block fwup_next_block_ of the staging area */
+static void FwupPutData(struct Port *port)
+{
+  const FSC_U8 *image = platform_staging_data();
+  FSC_U32 offset = (FSC_U32)port->fwup_next_block_ * FWUP_BLOCK_SIZE;
+  FSC_U16 size = 0;
+  FSC_U16 i = 0;
+
+  size = (port->fwup_image_len_ - offset > FWUP_BLOCK_SIZE) ?
+         FWUP_BLOCK_SIZE : (FSC_U16)(port->fwup_image_len_ - offset);
+
+  FwupPut(port, port->fwup_next_block_, 2);
+  for (i = 0; i < size; ++i) {
+    port->protocol_ext_buffer_[port->fwup_msg_len_++] = image[offset + i];
+  }
+}
+
+FSC_BOOL FwupStart(struct Port *port, FSC_U32 length)
+{
+  if (FwupOwner != 0 || port->fwup_state_ != FwupIdle ||
+      length == 0 || length > platform_staging_size() ||
+      length > (FSC_U32)0xFFFF * FWUP_BLOCK_SIZE) {
+    return FALSE;
+  }
+
+  FwupClaim(port, FwupSending);
+  port->fwup_image_len_ = length;
+  TimerDisable(&port->fwup_timer_);
+
+  port->fwup_request_ = FWUP_GET_FW_ID;
+
+  /* Wake up the port if idle */
+  port->idle_ = FALSE;
+
+  return TRUE;
+}
+
+FSC_BOOL FwupPending(struct Port *port)
+{
+  if (port->fwup_state_ != FwupSending) {
+    return FALSE;
+  }
+
+  /* Held off by a WaitTime */
+  if (!TimerDisabled(&port->fwup_timer_)) {
+    if (!TimerExpired(&port->fwup_timer_)) {
+      return FALSE;
+    }
+    TimerDisable(&port->fwup_timer_);
+  }
+
+  return TRUE;
+}
+
+FSC_BOOL FwupCompose(struct Port *port)
+{
+  /* Built as it goes out, as the buffer is only leased until Ready */
+  if (!ExtPoolLeaseOrWait(port)) {
+    return FALSE;
+  }
+
+  FwupHeader(port, port->fwup_request_);
+
+  switch (port->fwup_request_) {
+    case FWUP_PDFU_INITIATE:
+      FwupPut(port, 0, 8);              /* FW version of the image */
+      break;
+    case FWUP_PDFU_DATA:
+      FwupPutData(port);
+      break;
+    default:
+      break;
+  }
+
+  return TRUE;
+}
+
+void FwupResponse(struct Port *port)
+{
+  const FSC_U8 *rsp = port->protocol_ext_buffer_;
+  FSC_U16 len = port->protocol_ext_num_bytes_;
+  FSC_U8 request = port->fwup_request_;
+  FSC_U8 wait = 0;
+  FSC_U16 next = 0;
+
+  if (port->fwup_state_ != FwupSending) {
+    return;
+  }
+
+  if (len < FWUP_HEADER_SIZE + 2 || rsp[0] != FWUP_PROTOCOL_VERSION ||
+      rsp[1] != (request & FWUP_RESPONSE_MASK)) {
+    FwupFinish(port, FwupErrUnexpectedRequest);
+    return;
+  }
+
+  if (rsp[2] != FwupOK) {
+    FwupFinish(port, (FwupStatus)rsp[2]);
+    return;
+  }
+
+  /* WaitTime, where the response has one */
+  if (request != FWUP_GET_FW_ID) {
+    wait = rsp[3];
+  }
+  if (wait > 0) {
+    port->fwup_waits_++;
+    TimerStart(&port->fwup_timer_, wait * kMSTimeFactor);
+  }
+
+  switch (request) {
+    case FWUP_GET_FW_ID:
+      port->fwup_request_ = FWUP_PDFU_INITIATE;
+      break;
+    case FWUP_PDFU_INITIATE:
+      if (wait == 0) {
+        port->fwup_start_ = platform_current_time();
+        FwupNextData(port);
+      }
+      break;
+    case FWUP_PDFU_DATA:
+      if (len < FWUP_HEADER_SIZE + 5) {
+        FwupFinish(port, FwupErrUnexpectedRequest);
+        break;
+      }
+      /* The responder says which block it wants next */
+      next = rsp[5] | (rsp[6] << 8);
+      if (next == port->fwup_next_block_ + 1) {
+        port->fwup_bytes_ += port->fwup_msg_len_ - FWUP_HEADER_SIZE - 2;
+      }
+      port->fwup_next_block_ = next;
+      FwupNextData(port);
+      break;
+    case FWUP_PDFU_VALIDATE:
+      if (wait == 0) {
+        FwupFinish(port, FwupOK);
+      }
+      break;
+    default:
+      FwupFinish(port, FwupErrUnexpectedRequest);
+      break;
+  }
+}
+
+void FwupNoResponse(struct Port *port)
+{
+  if (port->fwup_state_ == FwupSending) {
+    FwupFinish(port, FwupErrUnknown);
+  }
+}
+
+#endif /* FSC_HAVE_FWUP */
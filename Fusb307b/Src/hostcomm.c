@@ -26,6 +26,7 @@
 #include "stm32f0xx_hal.h"
 #include "stm32f0xx_hal_i2c.h"
 #include "dpm.h"
+#include "stats.h"
 
 #ifdef FSC_HAVE_VDM
 #include "vdm.h"
@@ -189,13 +190,15 @@ static void WriteSourceCapabilities(FSC_U8 *data, struct Port *port)
             }
         }
 
+#ifdef FSC_HAVE_BUDGET
+        BudgetCapsChanged(port);
+#endif /* FSC_HAVE_BUDGET */
+
         if (port->policy_is_source_)
         {
-            port->pd_transmit_header_.word = port->caps_header_source_.word;
-            port->pd_tx_flag_ = TRUE;
+            QueueRequest(port, SOP_TYPE_SOP, port->caps_header_source_, 0,
+                         QueuePriorityHigh, QUEUE_NO_GROUP);
             port->source_caps_updated_ = TRUE;
-            /* Wake up the port if idle */
-            port->idle_ = FALSE;
         }
     }
 }
@@ -230,29 +233,30 @@ static void WriteSinkCapabilities(FSC_U8 *data, struct Port *port)
 }
 #endif
 
-static void SendUSBPDMessage(FSC_U8 *data, struct Port *port)
+static void SendUSBPDMessage(FSC_U8 *data, struct Port *port, FSC_U8 group)
 {
     FSC_U32 i = 0, j = 0;
+    SopType sop = SOP_TYPE_SOP;
+    sopMainHeader_t header = { 0 };
+    doDataObject_t objects[7];
 
     /* First byte is sop */
-    port->policy_msg_tx_sop_ = *data++;
+    sop = (SopType)*data++;
 
     /* 2 header bytes */
-    port->pd_transmit_header_.byte[0] = *data++;
-    port->pd_transmit_header_.byte[1] = *data++;
+    header.byte[0] = *data++;
+    header.byte[1] = *data++;
 
     /* Data objects */
-    for (i = 0; i < port->pd_transmit_header_.NumDataObjects; ++i)
+    for (i = 0; i < header.NumDataObjects; ++i)
     {
         for (j = 0; j < 4; ++j)
         {
-            port->pd_transmit_objects_[i].byte[j] = *data++;
+            objects[i].byte[j] = *data++;
         }
     }
 
-    port->pd_tx_flag_ = TRUE;
-    /* Wake up the port if idle */
-    port->idle_ = FALSE;
+    QueueRequest(port, sop, header, objects, QueuePriorityOf(header), group);
 }
 
 #ifdef FSC_HAVE_VDM
@@ -410,6 +414,9 @@ static FSC_BOOL ProcessTCWrite(FSC_U8 *subCmds, struct Port *port)
                 port->port_type_ = pCmd->val;
                 port->caps_source_[0].FPDOSupply.DualRolePower =
                     (port->port_type_ == USBTypeC_DRP) ? TRUE : FALSE;
+#ifdef FSC_HAVE_BUDGET
+                BudgetCapsChanged(port);
+#endif /* FSC_HAVE_BUDGET */
                 setUnattached = TRUE;
             }
             break;
@@ -463,6 +470,9 @@ static FSC_BOOL ProcessTCWrite(FSC_U8 *subCmds, struct Port *port)
     }
 
 end_of_cmd:
+  /* Caps may have changed */
+  TemplateInvalidate(port);
+
   /** set unattached if command requires for transition */
   if (setUnattached) {
       SetStateUnattached(port);
@@ -734,6 +744,7 @@ static FSC_BOOL ProcessPDWrite(FSC_U8 *subCmds, struct Port *port)
 
     FSC_BOOL setUnattached = FALSE;
     struct pd_buf *pCmd = (struct pd_buf*) subCmds;
+    FSC_U8 group = QUEUE_NO_GROUP;
     FSC_U32 i;
     FSC_S32 len;
 
@@ -802,7 +813,12 @@ static FSC_BOOL ProcessPDWrite(FSC_U8 *subCmds, struct Port *port)
             break;
 #endif ///< FSC_HAVE SNK
         case PD_MSG_WRITE:
-            SendUSBPDMessage(&pCmd->val+1, port);
+            /* The messages of one command go out as a sequence */
+            if (group == QUEUE_NO_GROUP)
+            {
+                group = QueueGroup(port);
+            }
+            SendUSBPDMessage(&pCmd->val+1, port, group);
             pCmd = (struct pd_buf*)((FSC_U8*)pCmd + pCmd->val);
             break;
 #ifdef FSC_HAVE_VDM
@@ -834,6 +850,9 @@ static FSC_BOOL ProcessPDWrite(FSC_U8 *subCmds, struct Port *port)
     }
 
 end_of_cmd:
+    /* Caps, SVIDs or modes may have changed */
+    TemplateInvalidate(port);
+
     /** set unattached if command requires for transition */
     if (setUnattached)
     {
@@ -918,6 +937,8 @@ static FSC_BOOL ProcessDPWrite(FSC_U8 *subCmds, struct Port *port)
     }
 
 end_of_cmd:
+    /* DP capabilities may have changed */
+    TemplateInvalidate(port);
     return TRUE;
 }
 
@@ -1015,7 +1036,21 @@ static void ProcessUserClassCmd(HostCmd_t *inCmd, HostCmd_t *outMsg, struct Port
         outMsg->userClass.cmd.rsp.error = HCMD_STATUS_SUCCESS;
         break;
     default:
-        outMsg->userClass.cmd.rsp.error = HCMD_STATUS_NOT_IMPLEMENTED;
+        switch (StatsReport(port, inCmd->userClass.cmd.req.id,
+                            inCmd->userClass.cmd.req.payload,
+                            outMsg->userClass.cmd.rsp.payload,
+                            sizeof(outMsg->userClass.cmd.rsp.payload)))
+        {
+        case StatsOK:
+            outMsg->userClass.cmd.rsp.error = HCMD_STATUS_SUCCESS;
+            break;
+        case StatsFailed:
+            outMsg->userClass.cmd.rsp.error = HCMD_STATUS_FAILED;
+            break;
+        default:
+            outMsg->userClass.cmd.rsp.error = HCMD_STATUS_NOT_IMPLEMENTED;
+            break;
+        }
         break;
     }
 }
@@ -1081,10 +1116,30 @@ static void ProcessReadI2CFCSDevice(HostCmd_t* inCmd, HostCmd_t* outMsg,
     }
 }
 
-void ProcessMsg(FSC_U8 *inMsgBuffer, FSC_U8 *outMsgBuffer, struct Port *port)
+void ProcessMsg(FSC_U8 *inMsgBuffer, FSC_U8 *outMsgBuffer,
+                struct Port *ports, FSC_U8 num_ports)
 {
     HostCmd_t *inCmd = (HostCmd_t*) inMsgBuffer;
     HostCmd_t *outMsg = (HostCmd_t*) outMsgBuffer;
+    struct Port *port = &ports[0];
+
+    /* The class commands carry the port number in the same byte - the
+     * others are for the first port */
+    switch (inCmd->request.opcode)
+    {
+    case HCMD_USER_CLASS:
+    case HCMD_TYPEC_CLASS:
+    case HCMD_PD_CLASS:
+    case HCMD_DP_CLASS:
+        if (inCmd->userClass.cmd.req.port > 0 &&
+            inCmd->userClass.cmd.req.port <= num_ports)
+        {
+            port = &ports[inCmd->userClass.cmd.req.port - 1];
+        }
+        break;
+    default:
+        break;
+    }
 
     HCOM_MEM_FILL(outMsg, 0, sizeof(HostCmd_t));
 
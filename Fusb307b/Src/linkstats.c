@@ -0,0 +1,180 @@
+/*******************************************************************************
+ * @file     linkstats.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * linkstats.c
+ *
+ * Implements the transmit statistics and the retry policy.
+ */
+
+#include "linkstats.h"
+#include "port.h"
+
+/* Bits on the wire for a frame of n bytes - preamble, SOP*, 4b5b coded
+ * bytes and CRC, EOP - and the time at 300kbps */
+#define LINK_FRAME_BITS(n)      (64 + 20 + ((n) + 4) * 10 + 5)
+#define LINK_FRAME_TIME(n)      \
+    ((FSC_U32)LINK_FRAME_BITS(n) * 10 * kMSTimeFactor / 3000)
+
+/* GoodCRC frame and tTransmit after the message */
+#define LINK_GOODCRC_TIME       (LINK_FRAME_TIME(2) + 195 * kMSTimeFactor / 1000)
+
+/* tReceive - how long the TCPC waits for a GoodCRC before a retry */
+#define LINK_RECEIVE_TIME       (1100 * kMSTimeFactor / 1000)
+
+/* Move a score a step towards 255, or decay it */
+static FSC_U8 LinkRaise(FSC_U8 score, FSC_U8 shift)
+{
+  return score + ((255 - score) >> shift);
+}
+
+static FSC_U8 LinkDecay(FSC_U8 score)
+{
+  return (score >= 16) ? score - (score >> 4) : (score ? score - 1 : 0);
+}
+
+void LinkClear(struct Port *port)
+{
+  FSC_U8 i = 0;
+  FSC_U8 b = 0;
+  struct LinkStats *link = 0;
+
+  for (i = 0; i < NUM_SOP_SUPPORTED; ++i) {
+    link = &port->link_stats_[i];
+    link->attempts_ = 0;
+    link->success_ = 0;
+    link->discards_ = 0;
+    link->failures_ = 0;
+    link->retries_ = 0;
+    link->busy_time_ = 0;
+    link->noisy_tx_ = 0;
+    for (b = 0; b < LINK_BUCKETS; ++b) {
+      link->goodcrc_time_[b] = 0;
+    }
+  }
+}
+
+void LinkRestart(struct Port *port)
+{
+  FSC_U8 i = 0;
+
+  for (i = 0; i < NUM_SOP_SUPPORTED; ++i) {
+    port->link_stats_[i].noise_ = 0;
+    port->link_stats_[i].contention_ = 0;
+  }
+  port->link_tx_sop_ = SOP_TYPE_ERROR;
+}
+
+void LinkTxStarted(struct Port *port, SopType sop, FSC_U8 bytes,
+                   FSC_BOOL timed)
+{
+  if (sop >= NUM_SOP_SUPPORTED) {
+    port->link_tx_sop_ = SOP_TYPE_ERROR;
+    return;
+  }
+
+  port->link_stats_[sop].attempts_++;
+  port->link_tx_sop_ = sop;
+  port->link_tx_bytes_ = bytes;
+  port->link_tx_timed_ = timed;
+
+  /* A staged transmit starts when its deadline action runs */
+  port->link_tx_start_ = platform_current_time() +
+                         DeadlineRemaining(port, DeadlineTransmit);
+}
+
+void LinkTxDone(struct Port *port, LinkResult result)
+{
+  struct LinkStats *link = 0;
+  FSC_U32 elapsed = 0;
+  FSC_U32 expected = 0;
+  FSC_U32 retries = 0;
+  FSC_U32 bucket = 0;
+
+  if (port->link_tx_sop_ >= NUM_SOP_SUPPORTED) {
+    return;
+  }
+
+  link = &port->link_stats_[port->link_tx_sop_];
+  port->link_tx_sop_ = SOP_TYPE_ERROR;
+
+  elapsed = platform_current_time() - port->link_tx_start_;
+  if (port->link_tx_timed_ && elapsed < 0x80000000) {
+    link->busy_time_ += elapsed;
+  }
+  else {
+    /* Waited on SinkTxOK, or finished before the deadline (time wrapped) */
+    elapsed = 0;
+  }
+
+  switch (result) {
+    case LinkSuccess:
+      link->success_++;
+      if (!port->link_tx_timed_) {
+        break;
+      }
+
+      bucket = elapsed / LINK_BUCKET_TIME;
+      if (bucket >= LINK_BUCKETS) {
+        bucket = LINK_BUCKETS - 1;
+      }
+      link->goodcrc_time_[bucket]++;
+
+      expected = LINK_FRAME_TIME(port->link_tx_bytes_) + LINK_GOODCRC_TIME;
+      if (elapsed > expected) {
+        retries = (elapsed - expected) /
+                  (LINK_FRAME_TIME(port->link_tx_bytes_) + LINK_RECEIVE_TIME);
+        if (retries > LINK_MAX_RETRIES) {
+          retries = LINK_MAX_RETRIES;
+        }
+      }
+
+      link->retries_ += retries;
+      link->noise_ = retries ? LinkRaise(link->noise_, 3) :
+                               LinkDecay(link->noise_);
+      link->contention_ = LinkDecay(link->contention_);
+      break;
+    case LinkDiscarded:
+      link->discards_++;
+      link->contention_ = LinkRaise(link->contention_, 2);
+      break;
+    case LinkFailed:
+      link->failures_++;
+      link->retries_ += port->protocol_retries_;
+      link->noise_ = LinkRaise(link->noise_, 1);
+      break;
+    default:
+      break;
+  }
+}
+
+FSC_U8 LinkRetries(struct Port *port, SopType sop, FSC_U8 spec)
+{
+  if (sop < NUM_SOP_SUPPORTED &&
+      port->link_stats_[sop].noise_ >= LINK_NOISY) {
+    port->link_stats_[sop].noisy_tx_++;
+  }
+
+  /* A partner counts on nRetryCount - more would be out of spec */
+  return (spec < LINK_MAX_RETRIES) ? spec : LINK_MAX_RETRIES;
+}
+
+FSC_U32 LinkSinkTxTime(struct Port *port)
+{
+  return ktSinkTx + (ktSinkTxMax - ktSinkTx) *
+         port->link_stats_[SOP_TYPE_SOP].contention_ / 255;
+}
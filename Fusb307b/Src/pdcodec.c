@@ -0,0 +1,216 @@
+/*******************************************************************************
+ * @file     pdcodec.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * pdcodec.c
+ *
+ * Implements the PD message codec.
+ */
+
+#include "pdcodec.h"
+
+/* Bytes of data an extended message chunk carries */
+#define PD_CHUNK_BYTES          (MAX_EXT_MSG_LEGACY_LEN)
+
+static FSC_U32 PdObject(const FSC_U8 *data)
+{
+  return (FSC_U32)data[0] | ((FSC_U32)data[1] << 8) |
+         ((FSC_U32)data[2] << 16) | ((FSC_U32)data[3] << 24);
+}
+
+PdCodecStatus PdDecodePdo(FSC_U32 pdo, struct PdPdo *out)
+{
+  out->kind_ = PdPdoType(pdo);
+  out->flags_ = 0;
+  out->min_mv_ = PdPdoMinMv(pdo);
+  out->max_mv_ = PdPdoMaxMv(pdo);
+  out->max_ma_ = PdPdoMaxMa(pdo);
+  out->max_mw_ = 0;
+
+  switch (out->kind_) {
+    case PdPdoFixed:
+      out->flags_ = PdPdoFlags(pdo);
+      out->max_mv_ = out->min_mv_;
+      break;
+    case PdPdoBattery:
+      out->max_ma_ = 0;
+      out->max_mw_ = PdPdoMaxMw(pdo);
+      break;
+    case PdPdoVariable:
+      break;
+    default:
+      if (PdApdoType(pdo) != 0) {
+        out->kind_ = PdPdoReserved;
+        out->min_mv_ = out->max_mv_ = out->max_ma_ = 0;
+        return PdCodecInvalid;
+      }
+      out->kind_ = PdPdoPps;
+      out->min_mv_ = PdPpsMinMv(pdo);
+      out->max_mv_ = PdPpsMaxMv(pdo);
+      out->max_ma_ = PdPpsMaxMa(pdo);
+      break;
+  }
+
+  return PdCodecOK;
+}
+
+static PdCodecStatus PdDecodeExtended(const FSC_U8 *data, FSC_U16 length,
+                                      struct PdMessage *out)
+{
+  FSC_U16 size = 0;
+  FSC_U16 offset = 0;
+
+  if (out->objects_ == 0) {
+    return PdCodecObjects;
+  }
+
+  out->ext_header_.word = (FSC_U16)(data[0] | (data[1] << 8));
+  size = PdExtSize(out->ext_header_.word);
+  out->data_ = &data[2];
+
+  if (PdExtRequest(out->ext_header_.word)) {
+    /* Chunk Request - no data */
+    return (out->objects_ == 1 && size == 0) ? PdCodecOK : PdCodecExtended;
+  }
+
+  if (size > MAX_EXT_MSG_LEN) {
+    return PdCodecExtended;
+  }
+
+  if (PdExtChunked(out->ext_header_.word)) {
+    /* This chunk's share, the whole of it in the data objects */
+    offset = PdExtChunk(out->ext_header_.word) * PD_CHUNK_BYTES;
+    if (offset >= size && size > 0) {
+      return PdCodecExtended;
+    }
+    out->bytes_ = size - offset;
+    if (out->bytes_ > PD_CHUNK_BYTES) {
+      out->bytes_ = PD_CHUNK_BYTES;
+    }
+    if (out->objects_ != (2 + out->bytes_ + 3) / 4) {
+      return PdCodecObjects;
+    }
+  }
+  else {
+    /* Unchunked - the data runs past the data objects */
+    if (PdExtChunk(out->ext_header_.word) != 0) {
+      return PdCodecExtended;
+    }
+    out->bytes_ = size;
+  }
+
+  return (length < 2 + out->bytes_) ? PdCodecShort : PdCodecOK;
+}
+
+PdCodecStatus PdDecode(const FSC_U8 *msg, FSC_U16 length,
+                       struct PdMessage *out)
+{
+  const FSC_U8 *data = &msg[2];
+  PdCodecStatus status = PdCodecOK;
+  FSC_U8 type = 0;
+  FSC_U8 i = 0;
+
+  out->objects_ = 0;
+  out->bytes_ = 0;
+  out->data_ = 0;
+  out->ext_header_.word = 0;
+
+  if (length < 2) {
+    return PdCodecShort;
+  }
+
+  out->header_.word = (FSC_U16)(msg[0] | (msg[1] << 8));
+  length -= 2;
+
+  if (PdHdrRevision(out->header_.word) == 0x3) {
+    return PdCodecRevision;
+  }
+
+  out->objects_ = PdHdrObjects(out->header_.word);
+  type = PdHdrType(out->header_.word);
+
+  if (PdHdrExtended(out->header_.word)) {
+    if (length < 2) {
+      return PdCodecShort;
+    }
+    return PdDecodeExtended(data, length, out);
+  }
+
+  if (length < out->objects_ * 4) {
+    return PdCodecShort;
+  }
+
+  for (i = 0; i < out->objects_; ++i) {
+    out->raw_[i] = PdObject(&data[i * 4]);
+  }
+
+  if (out->objects_ == 0) {
+    /* Control message */
+    return PdCodecOK;
+  }
+
+  switch (type) {
+    case DMTSourceCapabilities:
+    case DMTSinkCapabilities:
+      for (i = 0; i < out->objects_; ++i) {
+        if (PdDecodePdo(out->raw_[i], &out->pdo_[i]) != PdCodecOK) {
+          status = PdCodecInvalid;
+        }
+      }
+      /* The first is always vSafe5V */
+      if (out->pdo_[0].kind_ != PdPdoFixed || out->pdo_[0].min_mv_ != 5000) {
+        status = PdCodecInvalid;
+      }
+      break;
+    case DMTRequest:
+      if (out->objects_ != 1) {
+        return PdCodecObjects;
+      }
+      out->rdo_.obj_pos_ = PdRdoObjPos(out->raw_[0]);
+      out->rdo_.flags_ = PdRdoFlags(out->raw_[0]);
+      out->rdo_.word_ = out->raw_[0];
+      if (out->rdo_.obj_pos_ == 0) {
+        status = PdCodecInvalid;
+      }
+      break;
+    case DMTBIST:
+      out->bist_mode_ = (FSC_U8)(out->raw_[0] >> 28);
+      break;
+    case DMTVendorDefined:
+      out->vdm_.svid_ = PdVdmSvid(out->raw_[0]);
+      out->vdm_.structured_ = PdVdmStructured(out->raw_[0]);
+      if (out->vdm_.structured_) {
+        out->vdm_.version_ = PdVdmVersion(out->raw_[0]);
+        out->vdm_.obj_pos_ = PdVdmObjPos(out->raw_[0]);
+        out->vdm_.cmd_type_ = PdVdmCmdType(out->raw_[0]);
+        out->vdm_.command_ = PdVdmCommand(out->raw_[0]);
+        out->vdm_.vendor_ = 0;
+      }
+      else {
+        out->vdm_.version_ = 0;
+        out->vdm_.obj_pos_ = 0;
+        out->vdm_.cmd_type_ = 0;
+        out->vdm_.command_ = 0;
+        out->vdm_.vendor_ = PdVdmVendor(out->raw_[0]);
+      }
+      break;
+    default:
+      break;
+  }
+
+  return status;
+}
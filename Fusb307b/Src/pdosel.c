@@ -0,0 +1,304 @@
+/*******************************************************************************
+ * @file     pdosel.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * pdosel.c
+ *
+ * Implements the PDO selection engine.
+ */
+
+#include "pdosel.h"
+#include "pdcodec.h"
+#include "port.h"
+
+#define FNV_OFFSET              (0x811C9DC5UL)
+#define FNV_PRIME               (0x01000193UL)
+
+static FSC_U32 PdoHash(FSC_U32 hash, FSC_U32 word)
+{
+  FSC_U8 i = 0;
+
+  for (i = 0; i < 4; ++i) {
+    hash ^= (word >> (i * 8)) & 0xFF;
+    hash *= FNV_PRIME;
+  }
+
+  return hash;
+}
+
+/* Everything other than the caps the choice depends on */
+static FSC_U32 PdoInputs(struct Port *port)
+{
+  FSC_U32 hash = FNV_OFFSET;
+
+  hash = PdoHash(hash, port->pdosel_gen_);
+  hash = PdoHash(hash, port->sink_request_max_voltage_);
+  hash = PdoHash(hash, port->sink_request_low_power_);
+  hash = PdoHash(hash, port->sink_pps_mv_);
+
+  return hash;
+}
+
+/* Sink efficiency at mv, straight lines between the curve's points */
+static FSC_U8 PdoEfficiency(const struct PdoGoals *goals, FSC_U32 mv)
+{
+  FSC_U8 i = 0;
+  FSC_S32 span = 0;
+
+  if (mv <= goals->eff_mv_[0]) {
+    return goals->eff_pct_[0];
+  }
+
+  for (i = 1; i < PDOSEL_EFF_POINTS; ++i) {
+    if (mv <= goals->eff_mv_[i]) {
+      span = goals->eff_mv_[i] - goals->eff_mv_[i - 1];
+      if (span <= 0) {
+        return goals->eff_pct_[i];
+      }
+      return (FSC_U8)(goals->eff_pct_[i - 1] +
+                      ((FSC_S32)goals->eff_pct_[i] - goals->eff_pct_[i - 1]) *
+                      (FSC_S32)(mv - goals->eff_mv_[i - 1]) / span);
+    }
+  }
+
+  return goals->eff_pct_[PDOSEL_EFF_POINTS - 1];
+}
+
+/* The object at index as a candidate, FALSE if it can't be one */
+static FSC_BOOL PdoCandidateOf(struct Port *port, FSC_U8 index,
+                               struct PdoCandidate *out)
+{
+  struct PdPdo pdo;
+  FSC_U32 mv = 0;
+
+  if (PdDecodePdo(port->caps_received_[index].object, &pdo) != PdCodecOK) {
+    return FALSE;
+  }
+
+  /* A PPS APDO only has to reach down to it */
+  if (pdo.kind_ != PdPdoPps &&
+      pdo.max_mv_ > port->sink_request_max_voltage_) {
+    return FALSE;
+  }
+
+  out->position_ = index + 1;
+  out->kind_ = pdo.kind_;
+  out->max_mv_ = pdo.max_mv_;
+  out->ma_ = pdo.max_ma_;
+
+  switch (pdo.kind_) {
+    case PdPdoFixed:
+    case PdPdoVariable:
+      /* A variable supply may sit at its minimum */
+      mv = pdo.min_mv_;
+      out->mw_ = (mv * pdo.max_ma_) / 1000;
+      break;
+    case PdPdoBattery:
+      mv = pdo.min_mv_;
+      out->mw_ = pdo.max_mw_;
+      break;
+    case PdPdoPps:
+      mv = port->sink_pps_mv_ ? port->sink_pps_mv_ :
+                                port->pdosel_goals_.preferred_mv_;
+      if (mv == 0 || mv < pdo.min_mv_ || mv > pdo.max_mv_ ||
+          mv > port->sink_request_max_voltage_) {
+        return FALSE;
+      }
+      out->max_mv_ = (FSC_U16)mv;
+      out->mw_ = (mv * pdo.max_ma_) / 1000;
+      break;
+    default:
+      return FALSE;
+  }
+
+  /* A 0V object can't be requested - and the request divides by it */
+  if (mv == 0) {
+    return FALSE;
+  }
+
+  out->mv_ = (FSC_U16)mv;
+  out->eff_pct_ = PdoEfficiency(&port->pdosel_goals_, mv);
+
+  return TRUE;
+}
+
+static FSC_BOOL PdoEvaluate(struct Port *port, struct PdoCandidate *choice)
+{
+  struct PdoCandidate candidate;
+  FSC_S32 best = 0;
+  FSC_S32 score = 0;
+  FSC_BOOL found = FALSE;
+  FSC_U8 i = 0;
+
+  /* Another port has the power - take vSafe5V */
+  if (port->sink_request_low_power_) {
+    if (PdoCandidateOf(port, 0, choice) &&
+        choice->kind_ == PdPdoFixed && choice->mv_ == PD_05_V * 50) {
+      return TRUE;
+    }
+  }
+
+  for (i = 0; i < port->caps_header_received_.NumDataObjects; ++i) {
+    if (!PdoCandidateOf(port, i, &candidate)) {
+      continue;
+    }
+
+    /* Ties go to the later object */
+    score = port->pdosel_score_(port, &candidate);
+    if (!found || score >= best) {
+      best = score;
+      *choice = candidate;
+      found = TRUE;
+    }
+  }
+
+  return found;
+}
+
+void PdoSelInit(struct Port *port)
+{
+  struct PdoGoals goals = {0};
+  FSC_U8 i = 0;
+
+  /* Highest power, a flat curve */
+  goals.power_weight_ = 1;
+  for (i = 0; i < PDOSEL_EFF_POINTS; ++i) {
+    goals.eff_mv_[i] = (FSC_U16)(PPS_MIN_MV + i * 5000);
+    goals.eff_pct_[i] = 100;
+  }
+
+  port->pdosel_score_ = PdoScoreDefault;
+  port->pdosel_gen_ = 0;
+  port->pdosel_next_ = 0;
+  PdoSelSetGoals(port, &goals);
+
+  for (i = 0; i < PDOSEL_CACHE_LENGTH; ++i) {
+    port->pdosel_cache_[i].key_ = 0;
+  }
+
+  port->pdosel_stats_.hits_ = 0;
+  port->pdosel_stats_.misses_ = 0;
+  port->pdosel_stats_.eval_cycles_ = 0;
+  port->pdosel_stats_.max_eval_cycles_ = 0;
+  port->pdosel_stats_.hit_cycles_ = 0;
+}
+
+void PdoSelSetGoals(struct Port *port, const struct PdoGoals *goals)
+{
+  port->pdosel_goals_ = *goals;
+  port->pdosel_gen_++;
+}
+
+void PdoSelSetScore(struct Port *port, PdoScoreFn score)
+{
+  port->pdosel_score_ = score ? score : PdoScoreDefault;
+  port->pdosel_gen_++;
+}
+
+FSC_S32 PdoScoreDefault(struct Port *port,
+                        const struct PdoCandidate *candidate)
+{
+  const struct PdoGoals *goals = &port->pdosel_goals_;
+  FSC_U32 mw = candidate->mw_;
+  FSC_S32 score = 0;
+  FSC_S32 off = 0;
+
+  /* Only what can be taken within the thermal budget counts */
+  if (goals->thermal_mw_ > 0 && candidate->eff_pct_ < 100 &&
+      mw * (100 - candidate->eff_pct_) / 100 > goals->thermal_mw_) {
+    mw = goals->thermal_mw_ * 100 / (100 - candidate->eff_pct_);
+  }
+
+  score = (FSC_S32)(goals->power_weight_ * mw);
+  score += (FSC_S32)goals->efficiency_weight_ * candidate->eff_pct_ * 100;
+
+  if (goals->preferred_mv_ > 0) {
+    off = (FSC_S32)candidate->mv_ - (FSC_S32)goals->preferred_mv_;
+    score -= goals->voltage_weight_ * (off < 0 ? -off : off);
+  }
+
+  if (candidate->kind_ == PdPdoPps && port->sink_pps_mv_ > 0) {
+    score += PDOSEL_PPS_PREFERENCE;
+  }
+
+  return score;
+}
+
+FSC_BOOL PdoSelect(struct Port *port, struct PdoCandidate *choice)
+{
+  struct PdoCacheEntry *entry = 0;
+  FSC_U32 start = platform_cycle_count();
+  FSC_U32 cycles = 0;
+  FSC_U32 inputs = PdoInputs(port);
+  FSC_U32 key = FNV_OFFSET;
+  FSC_U8 count = port->caps_header_received_.NumDataObjects;
+  FSC_BOOL found = FALSE;
+  FSC_U8 i = 0;
+  FSC_U8 j = 0;
+
+  key = PdoHash(key, count);
+  for (i = 0; i < count; ++i) {
+    key = PdoHash(key, port->caps_received_[i].object);
+  }
+  key = key ? key : 1;
+
+  for (i = 0; i < PDOSEL_CACHE_LENGTH; ++i) {
+    entry = &port->pdosel_cache_[i];
+    if (entry->key_ != key || entry->inputs_ != inputs ||
+        entry->count_ != count) {
+      continue;
+    }
+
+    for (j = 0; j < count; ++j) {
+      if (entry->caps_[j] != port->caps_received_[j].object) {
+        break;
+      }
+    }
+
+    if (j == count) {
+      *choice = entry->choice_;
+      port->pdosel_stats_.hits_++;
+      port->pdosel_stats_.hit_cycles_ += platform_cycle_count() - start;
+      return TRUE;
+    }
+  }
+
+  found = PdoEvaluate(port, choice);
+
+  cycles = platform_cycle_count() - start;
+  port->pdosel_stats_.misses_++;
+  port->pdosel_stats_.eval_cycles_ += cycles;
+  if (cycles > port->pdosel_stats_.max_eval_cycles_) {
+    port->pdosel_stats_.max_eval_cycles_ = cycles;
+  }
+
+  /* Only choices are kept - no choice costs a wait for new caps anyway */
+  if (found) {
+    entry = &port->pdosel_cache_[port->pdosel_next_];
+    port->pdosel_next_ = (port->pdosel_next_ + 1) % PDOSEL_CACHE_LENGTH;
+
+    entry->key_ = key;
+    entry->inputs_ = inputs;
+    entry->count_ = count;
+    for (i = 0; i < count; ++i) {
+      entry->caps_[i] = port->caps_received_[i].object;
+    }
+    entry->choice_ = *choice;
+  }
+
+  return found;
+}
@@ -31,6 +31,8 @@
 #include "dpm.h"
 #include "observer.h"
 #include "vendor_info.h"
+#include "policy_pt.h"
+#include "pdcodec.h"
 
 #ifdef FSC_HAVE_VDM
 #include "vdm.h"
@@ -41,6 +43,8 @@
 
 void USBPDPolicyEngine(struct Port *port)
 {
+  PolicyState_t state = port->policy_state_;
+
   switch (port->policy_state_) {
     case PE_ErrorRecovery:
       PolicyErrorRecovery(port);
@@ -263,6 +267,17 @@ void USBPDPolicyEngine(struct Port *port)
       PolicyGiveManufacturerInfo(port);
       break;
 #endif /* FSC_HAVE_EXTENDED */
+#ifdef FSC_HAVE_FWUP
+    case PE_Send_Firmware_Update_Request:
+      PolicySendFwUpdateRequest(port);
+      break;
+    case PE_Send_Firmware_Update_Response:
+      PolicySendFwUpdateResponse(port);
+      break;
+    case PE_Firmware_Update_Response_Received:
+      PolicyFwUpdateResponseReceived(port);
+      break;
+#endif /* FSC_HAVE_FWUP */
 #ifdef FSC_HAVE_VDM
     case PE_GIVE_VDM:
       PolicyGiveVdm(port);
@@ -300,6 +315,14 @@ void USBPDPolicyEngine(struct Port *port)
       }
       break;
   }
+
+  /* An AMS just ended with requests queued - start the next one in this
+   * pass.  Ready either starts it, leaving Ready, or stays put. */
+  if (port->policy_state_ != state && QueuePending(port) &&
+      (port->policy_state_ == PE_SRC_Ready ||
+       port->policy_state_ == PE_SNK_Ready)) {
+    USBPDPolicyEngine(port);
+  }
 }
 
 void PolicyErrorRecovery(struct Port *port)
@@ -322,7 +345,8 @@ void PolicySourceSendSoftReset(struct Port *port)
       if (PolicySend(port, CMTSoftReset, 0, 0, PE_SRC_Send_Soft_Reset,
                      1, SOP_TYPE_SOP, FALSE) == STAT_SUCCESS) {
         TimerStart(&port->policy_state_timer_, ktSenderResponse);
-        port->waiting_on_hr_ = TRUE;
+        DeadlineArm(port, DeadlineHardReset, &port->policy_state_timer_,
+                    TRANSMIT_HARDRESET);
       }
       break;
     case 1:
@@ -391,6 +415,12 @@ void PolicySourceStartup(struct Port *port)
         WriteRegister(port, regTCPC_CTRL);
       }
 
+      /* And the BIST Test Data overflow count */
+      if (port->registers_.AlertMskH.M_RX_FULL == 1) {
+        port->registers_.AlertMskH.M_RX_FULL = 0;
+        WriteRegister(port, regALERTMSKH);
+      }
+
       port->usb_pd_contract_.object = 0;
       port->sink_partner_max_power_ = 0;
       port->partner_caps_.object = 0;
@@ -502,6 +532,14 @@ void PolicySourceDiscovery(struct Port *port)
           set_policy_state(port, PE_SRC_Send_Capabilities);
         }
       }
+      else if (port->caps_counter_ <= MAX_CAPS_COUNT &&
+               port->protocol_state_ == PRLIdle &&
+               port->pd_tx_status_ == txIdle) {
+        /* Load the next Source_Capabilities now and let the deadline
+         * action start it on tTypeCSendSourceCap. */
+        set_policy_state(port, PE_SRC_Send_Capabilities);
+        port->protocol_tx_timer_ = &port->policy_state_timer_;
+      }
       else {
         port->idle_ = TRUE;
       }
@@ -526,9 +564,11 @@ void PolicySourceSendCaps(struct Port *port)
         port->is_hard_reset_ = FALSE;
         port->hard_reset_counter_ = 0;
         port->caps_counter_ = 0;
-        port->waiting_on_hr_ = TRUE;
         TimerDisable(&port->no_response_timer_);
+        TimerDisable(&port->policy_state_timer_);
         TimerStart(&port->policy_state_timer_, ktSenderResponse);
+        DeadlineArm(port, DeadlineHardReset, &port->policy_state_timer_,
+                    TRANSMIT_HARDRESET);
       }
       break;
     case 1:
@@ -699,200 +739,215 @@ void PolicySourceCapabilityResponse(struct Port *port)
   }
 }
 
-void PolicySourceTransitionSupply(struct Port *port)
+/* Program the supply for the new contract.
+ * Returns FALSE if it is already there - no transition to wait on.
+ */
+FSC_BOOL PolicySourceStartTransition(struct Port *port)
 {
-  FSC_BOOL transition_success = FALSE;
+  FSC_BOOL started = FALSE;
+
+  if (port->source_is_apdo_) {
+    /* OpVoltage is 20mv LSB - ok for platform control */
+    platform_setPPSVoltage(port->port_id_,
+                           port->usb_pd_contract_.PPSRDO.OpVoltage);
+    platform_setPPSCurrent(port->port_id_,
+                           port->usb_pd_contract_.PPSRDO.OpCurrent * 50);
+
+    /* Check the transition direction - vPpsValid is +/- 100mv */
+    if (port->usb_pd_contract_.PPSRDO.OpVoltage * 20 >
+        (port->sink_selected_voltage_ + 100)) {
+      /* Going up */
+      SetVBusAlarm(port, 0,
+        FSC_VBUS_LVL_L(port->usb_pd_contract_.PPSRDO.OpVoltage * 20));
+      port->registers_.AlertMskL.M_VBUS_ALRM_HI = 1;
+      WriteRegister(port, regALERTMSKL);
+    }
+    else if (port->usb_pd_contract_.PPSRDO.OpVoltage * 20 <
+             (port->sink_selected_voltage_ - 100)) {
+      /* Going down */
+      SetVBusAlarm(port,
+        FSC_VBUS_LVL_H(port->usb_pd_contract_.PPSRDO.OpVoltage * 20),
+        FSC_VBUS_LVL_HIGHEST);
+      port->registers_.AlertMskH.M_VBUS_ALRM_LO = 1;
+      WriteRegister(port, regALERTMSKH);
+    }
+    else {
+      /* Within existing range */
+    }
 
-  switch (port->policy_subindex_) {
-    case 0:
-      if (port->needs_goto_min_) {
-          if (PolicySend(port, CMTGotoMin, 0, 0, PE_SRC_Transition_Supply,
-                         3, SOP_TYPE_SOP, FALSE) == STAT_SUCCESS) {
-              /* This will send GotoMin followed by PSRdy.
-               * Additional support for adjusting power limits is needed
-               * to make this a useful feature.
-               */
-              TimerStart(&port->policy_state_timer_, ktSrcTransition);
-              port->needs_goto_min_ = FALSE;
-          }
-          break;
-      }
+    ClearInterrupt(port, regALERTH, MSK_I_VBUS_ALRM_LO);
+    ClearInterrupt(port, regALERTL, MSK_I_VBUS_ALRM_HI);
 
-      if (PolicySend(port, CMTAccept, 0, 0, PE_SRC_Transition_Supply,
-                     1, SOP_TYPE_SOP, FALSE) == STAT_SUCCESS) {
-        TimerDisable(&port->policy_state_timer_);
+    port->sink_selected_voltage_ =
+            port->usb_pd_contract_.PPSRDO.OpVoltage * 20;
 
-        if ((port->usb_pd_contract_.object != 0) &&
-            (port->policy_rx_data_obj_[0].FVRDO.ObjectPosition ==
-             port->usb_pd_contract_.FVRDO.ObjectPosition) &&
-            (port->caps_source_[port->policy_rx_data_obj_[0]
-                                .FVRDO.ObjectPosition - 1]
-                                .FPDOSupply.SupplyType == pdoTypeAugmented) &&
-            (port->caps_source_[port->policy_rx_data_obj_[0]
-                                .FVRDO.ObjectPosition - 1]
-                                .APDO.APDOType == apdoTypePPS))
-        {
-          /* If contract already exists and it is PPS increase/decrease in
-           * power then don't start the ktSrcTransition timer. */
-        }
-        else
-        {
-          /* Not a PPS voltage/current change  */
-          TimerStart(&port->policy_state_timer_, ktSrcTransition);
-        }
-      }
-      break;
-    case 1:
-      if (TimerExpired(&port->policy_state_timer_) ||
-          TimerDisabled(&port->policy_state_timer_)) {
-        TimerDisable(&port->policy_state_timer_);
+    /* Use HighV source path for PPS */
+    SendCommand(port, SourceVbusHighV);
 
-        port->usb_pd_contract_.object = port->policy_rx_data_obj_[0].object;
-
-        if (port->source_is_apdo_) {
-          /* OpVoltage is 20mv LSB - ok for platform control */
-          platform_setPPSVoltage(port->port_id_,
-                                 port->usb_pd_contract_.PPSRDO.OpVoltage);
-          platform_setPPSCurrent(port->port_id_,
-                                 port->usb_pd_contract_.PPSRDO.OpCurrent * 50);
-
-          /* Check the transition direction - vPpsValid is +/- 100mv */
-          if (port->usb_pd_contract_.PPSRDO.OpVoltage * 20 >
-              (port->sink_selected_voltage_ + 100)) {
-            /* Going up */
-            SetVBusAlarm(port, 0,
-              FSC_VBUS_LVL_L(port->usb_pd_contract_.PPSRDO.OpVoltage * 20));
-            port->registers_.AlertMskL.M_VBUS_ALRM_HI = 1;
-            WriteRegister(port, regALERTMSKL);
-          }
-          else if (port->usb_pd_contract_.PPSRDO.OpVoltage * 20 <
-                   (port->sink_selected_voltage_ - 100)) {
-            /* Going down */
-            SetVBusAlarm(port,
-              FSC_VBUS_LVL_H(port->usb_pd_contract_.PPSRDO.OpVoltage * 20),
-              FSC_VBUS_LVL_HIGHEST);
-            port->registers_.AlertMskH.M_VBUS_ALRM_LO = 1;
-            WriteRegister(port, regALERTMSKH);
-          }
-          else {
-            /* Within existing range */
-          }
+    TimerStart(&port->policy_state_timer_, ktSrcTransitionSupply);
+    started = TRUE;
+  }
+  else if (port->caps_source_[
+           port->usb_pd_contract_.FVRDO.ObjectPosition - 1]
+          .FPDOSupply.Voltage == FSC_VBUS_LVL_PD(FSC_VBUS_05_V)) {
+    /* If the requested contract is 5V, the three possible cases are: */
+    /* - Already at 5V - Do nothing.    */
+    /* - At HV - Discharge to vSafe5V.  */
+    /* - At 0V - Transition to vSafe5V. */
+    if (port->registers_.PwrStat.SOURCE_VBUS) {
+      /* Do nothing */
+    }
+    else if(port->registers_.PwrStat.SOURCE_HV) {
+    //else if(platform_getHVSwitch()) {
+      /* Need to discharge */
+      port->registers_.PwrCtrl.DIS_VALARM = 1;
+      port->registers_.PwrCtrl.AUTO_DISCH = 0;
+      WriteRegister(port, regPWRCTRL);
 
-          ClearInterrupt(port, regALERTH, MSK_I_VBUS_ALRM_LO);
-          ClearInterrupt(port, regALERTL, MSK_I_VBUS_ALRM_HI);
+      SetVBusStopDisc(port, FSC_VSAFE5V);
 
-          port->sink_selected_voltage_ =
-                  port->usb_pd_contract_.PPSRDO.OpVoltage * 20;
+      port->registers_.AlertMskL.M_PORT_PWR = 1;
+      WriteRegister(port, regALERTMSKL);
+      port->registers_.AlertVDMsk.M_DISCH_SUCC = 1;
+      WriteRegister(port, regALERT_VD_MSK);
 
-          /* Use HighV source path for PPS */
-          SendCommand(port, SourceVbusHighV);
+      SendCommand(port, SourceVbusDefaultV);
 
-          TimerStart(&port->policy_state_timer_, ktSrcTransitionSupply);
-          port->policy_subindex_++;
-        }
-        else if (port->caps_source_[
-                 port->usb_pd_contract_.FVRDO.ObjectPosition - 1]
-                .FPDOSupply.Voltage == FSC_VBUS_LVL_PD(FSC_VBUS_05_V)) {
-          /* If the requested contract is 5V, the three possible cases are: */
-          /* - Already at 5V - Do nothing.    */
-          /* - At HV - Discharge to vSafe5V.  */
-          /* - At 0V - Transition to vSafe5V. */
-          if (port->registers_.PwrStat.SOURCE_VBUS) {
-            /* Do nothing */
-            port->policy_subindex_ = 4;
-          }
-          else if(port->registers_.PwrStat.SOURCE_HV) {
-          //else if(platform_getHVSwitch()) {
-            /* Need to discharge */
-            port->registers_.PwrCtrl.DIS_VALARM = 1;
-            port->registers_.PwrCtrl.AUTO_DISCH = 0;
-            WriteRegister(port, regPWRCTRL);
+      port->registers_.PwrCtrl.FORCE_DISCH = 1;
+      WriteRegister(port, regPWRCTRL);
+
+      TimerStart(&port->policy_state_timer_, ktSrcTransitionSupply);
+      started = TRUE;
+    }
+    else {
+      /* Transition to vSafe5V */
+      port->registers_.PwrCtrl.DIS_VALARM = 0;
+      port->registers_.PwrCtrl.AUTO_DISCH = 0;
+      WriteRegister(port, regPWRCTRL);
 
-            SetVBusStopDisc(port, FSC_VSAFE5V);
+      SetVBusAlarm(port, FSC_VBUS_LVL_H(FSC_VBUS_05_V),
+              FSC_VBUS_LVL_L(FSC_VBUS_05_V));
 
-            port->registers_.AlertMskL.M_PORT_PWR = 1;
-            WriteRegister(port, regALERTMSKL);
-            port->registers_.AlertVDMsk.M_DISCH_SUCC = 1;
-            WriteRegister(port, regALERT_VD_MSK);
+      port->registers_.AlertMskL.M_VBUS_ALRM_HI = 1;
+      port->registers_.AlertMskL.M_PORT_PWR = 1;
+      port->registers_.AlertMskH.M_VBUS_ALRM_LO = 1;
+      WriteRegisters(port, regALERTMSKL, 2);
 
-            SendCommand(port, SourceVbusDefaultV);
+      ClearInterrupt(port, regALERTH, MSK_I_VBUS_ALRM_LO);
+      ClearInterrupt(port, regALERTL, MSK_I_VBUS_ALRM_HI);
 
-            port->registers_.PwrCtrl.FORCE_DISCH = 1;
-            WriteRegister(port, regPWRCTRL);
+      SendCommand(port, SourceVbusDefaultV);
+      TimerStart(&port->policy_state_timer_, ktSrcTransitionSupply);
+      started = TRUE;
+    }
 
-            TimerStart(&port->policy_state_timer_, ktSrcTransitionSupply);
-            port->policy_subindex_++;
-          }
-          else {
-            /* Transition to vSafe5V */
-            port->registers_.PwrCtrl.DIS_VALARM = 0;
-            port->registers_.PwrCtrl.AUTO_DISCH = 0;
-            WriteRegister(port, regPWRCTRL);
+    port->sink_selected_voltage_ = FSC_VBUS_05_V;
+  }
+  else { /* Higher Voltage Option */
+    /* If the requested contract is HV, the two possible cases are: */
+    /* - Already at HV - Do nothing.   */
+    /* - At LV - Ramp up to HV. */
+    if(port->registers_.PwrStat.SOURCE_HV && !port->source_is_apdo_) {
+    //if(platform_getHVSwitch()) {
+      /* If the supply is already enabled, go to PS_READY */
+    }
+    else {
+      /* Go to HV */
+      port->registers_.PwrCtrl.DIS_VALARM = 0;
+      port->registers_.PwrCtrl.AUTO_DISCH = 0;
+      WriteRegister(port, regPWRCTRL);
 
-            SetVBusAlarm(port, FSC_VBUS_LVL_H(FSC_VBUS_05_V),
-                    FSC_VBUS_LVL_L(FSC_VBUS_05_V));
+      /* Using PPS Supply */
+      platform_setPPSVoltage(port->port_id_,
+                             port->pd_HV_option_ / 20); /* 20mv units */
+      platform_setPPSCurrent(port->port_id_,
+                             port->usb_pd_contract_.FVRDO.OpCurrent * 10);
 
-            port->registers_.AlertMskL.M_VBUS_ALRM_HI = 1;
-            port->registers_.AlertMskL.M_PORT_PWR = 1;
-            port->registers_.AlertMskH.M_VBUS_ALRM_LO = 1;
-            WriteRegisters(port, regALERTMSKL, 2);
+      SetVBusAlarm(port, FSC_VBUS_LVL_H(port->pd_HV_option_),
+              FSC_VBUS_LVL_L(port->pd_HV_option_));
 
-            ClearInterrupt(port, regALERTH, MSK_I_VBUS_ALRM_LO);
-            ClearInterrupt(port, regALERTL, MSK_I_VBUS_ALRM_HI);
+      port->registers_.AlertMskL.M_VBUS_ALRM_HI = 1;
+      port->registers_.AlertMskH.M_VBUS_ALRM_LO = 1;
+      WriteRegisters(port, regALERTMSKL, 2);
 
-            SendCommand(port, SourceVbusDefaultV);
-            TimerStart(&port->policy_state_timer_, ktSrcTransitionSupply);
-            port->policy_subindex_++;
-          }
+      ClearInterrupt(port, regALERTH, MSK_I_VBUS_ALRM_LO);
+      ClearInterrupt(port, regALERTL, MSK_I_VBUS_ALRM_HI);
 
-          port->sink_selected_voltage_ = FSC_VBUS_05_V;
-        }
-        else { /* Higher Voltage Option */
-          /* If the requested contract is HV, the two possible cases are: */
-          /* - Already at HV - Do nothing.   */
-          /* - At LV - Ramp up to HV. */
-          if(port->registers_.PwrStat.SOURCE_HV && !port->source_is_apdo_) {
-          //if(platform_getHVSwitch()) {
-            /* If the supply is already enabled, go to PS_READY */
-            port->policy_subindex_ = 4;
-          }
-          else {
-            /* Go to HV */
-            port->registers_.PwrCtrl.DIS_VALARM = 0;
-            port->registers_.PwrCtrl.AUTO_DISCH = 0;
-            WriteRegister(port, regPWRCTRL);
+      SendCommand(port, SourceVbusHighV);
 
-            /* Using PPS Supply */
-            platform_setPPSVoltage(port->port_id_,
-                                   port->pd_HV_option_ / 20); /* 20mv units */
-            platform_setPPSCurrent(port->port_id_,
-                                   port->usb_pd_contract_.FVRDO.OpCurrent * 10);
+      /* Set the policy state timer to wait for transition */
+      TimerStart(&port->policy_state_timer_, ktSrcTransitionSupply);
+      started = TRUE;
+    }
 
-            SetVBusAlarm(port, FSC_VBUS_LVL_H(port->pd_HV_option_),
-                    FSC_VBUS_LVL_L(port->pd_HV_option_));
+    port->sink_selected_voltage_ = port->pd_HV_option_;
+  }
 
-            port->registers_.AlertMskL.M_VBUS_ALRM_HI = 1;
-            port->registers_.AlertMskH.M_VBUS_ALRM_LO = 1;
-            WriteRegisters(port, regALERTMSKL, 2);
+  return started;
+}
 
-            ClearInterrupt(port, regALERTH, MSK_I_VBUS_ALRM_LO);
-            ClearInterrupt(port, regALERTL, MSK_I_VBUS_ALRM_HI);
+void PolicySourceTransitionSupply(struct Port *port)
+{
+  FSC_BOOL transition_success = FALSE;
+  FSC_U8 status = STAT_BUSY;
 
-            SendCommand(port, SourceVbusHighV);
+  PT_BEGIN(port);
+
+  if (port->needs_goto_min_) {
+    PT_SEND(port, status, PolicySend(port, CMTGotoMin, 0, 0,
+            PE_SRC_Transition_Supply, PT_SENT, SOP_TYPE_SOP, FALSE));
+    if (status == STAT_SUCCESS) {
+      /* This will send GotoMin followed by PSRdy.
+       * Additional support for adjusting power limits is needed
+       * to make this a useful feature.
+       */
+      TimerStart(&port->policy_state_timer_, ktSrcTransition);
+      port->needs_goto_min_ = FALSE;
+    }
+    else if (PT_LEFT(port)) {
+      return;
+    }
 
-            /* Set the policy state timer to wait for transition */
-            TimerStart(&port->policy_state_timer_, ktSrcTransitionSupply);
-            port->policy_subindex_++;
-          }
+    PT_WAIT_UNTIL(port, TimerExpired(&port->policy_state_timer_));
+    TimerDisable(&port->policy_state_timer_);
+  }
+  else {
+    PT_SEND(port, status, PolicySend(port, CMTAccept, 0, 0,
+            PE_SRC_Transition_Supply, PT_SENT, SOP_TYPE_SOP, FALSE));
+    if (status == STAT_SUCCESS) {
+      TimerDisable(&port->policy_state_timer_);
 
-          port->sink_selected_voltage_ = port->pd_HV_option_;
-        }
+      if ((port->usb_pd_contract_.object != 0) &&
+          (port->policy_rx_data_obj_[0].FVRDO.ObjectPosition ==
+           port->usb_pd_contract_.FVRDO.ObjectPosition) &&
+          (port->caps_source_[port->policy_rx_data_obj_[0]
+                              .FVRDO.ObjectPosition - 1]
+                              .FPDOSupply.SupplyType == pdoTypeAugmented) &&
+          (port->caps_source_[port->policy_rx_data_obj_[0]
+                              .FVRDO.ObjectPosition - 1]
+                              .APDO.APDOType == apdoTypePPS))
+      {
+        /* If contract already exists and it is PPS increase/decrease in
+         * power then don't start the ktSrcTransition timer. */
       }
-      else {
-        port->idle_ = TRUE;
+      else
+      {
+        /* Not a PPS voltage/current change  */
+        TimerStart(&port->policy_state_timer_, ktSrcTransition);
       }
-      break;
-    case 2:
+    }
+    else if (PT_LEFT(port)) {
+      return;
+    }
+
+    PT_WAIT_UNTIL(port, TimerExpired(&port->policy_state_timer_) ||
+                        TimerDisabled(&port->policy_state_timer_));
+    TimerDisable(&port->policy_state_timer_);
+
+    port->usb_pd_contract_.object = port->policy_rx_data_obj_[0].object;
+
+    if (PolicySourceStartTransition(port)) {
+      PT_RESUME_POINT(port);
       /* Verify we've hit our target voltage, or the transition timer expires */
       if (port->registers_.AlertH.I_VBUS_ALRM_LO ||
           port->registers_.AlertL.I_VBUS_ALRM_HI ||
@@ -906,7 +961,7 @@ void PolicySourceTransitionSupply(struct Port *port)
         transition_success = TRUE;
       }
       else {
-          port->idle_ = TRUE;
+        port->idle_ = TRUE;
       }
 
       /* Clear I_PORT_PWR if it appears and continue monitoring vbus */
@@ -914,60 +969,55 @@ void PolicySourceTransitionSupply(struct Port *port)
         ClearInterrupt(port, regALERTL, MSK_I_PORT_PWR);
       }
 
-      if (transition_success) {
-        port->registers_.AlertMskL.M_PORT_PWR = 0;
-        port->registers_.AlertMskL.M_VBUS_ALRM_HI = 0;
-        port->registers_.AlertMskH.M_VBUS_ALRM_LO = 0;
-        WriteRegisters(port, regALERTMSKL, 2);
-        port->registers_.AlertVDMsk.M_DISCH_SUCC = 0;
-        WriteRegister(port, regALERT_VD_MSK);
+      if (!transition_success) {
+        return;
+      }
 
-        port->registers_.PwrCtrl.AUTO_DISCH = 1;
-        port->registers_.PwrCtrl.FORCE_DISCH = 0;
-        port->registers_.PwrCtrl.DIS_VALARM = 0;
-        WriteRegister(port, regPWRCTRL);
-        /* Optional delay to allow for external switching delays */
-        TimerStart(&port->policy_state_timer_, ktSwitchDelay);
+      port->registers_.AlertMskL.M_PORT_PWR = 0;
+      port->registers_.AlertMskL.M_VBUS_ALRM_HI = 0;
+      port->registers_.AlertMskH.M_VBUS_ALRM_LO = 0;
+      WriteRegisters(port, regALERTMSKL, 2);
+      port->registers_.AlertVDMsk.M_DISCH_SUCC = 0;
+      WriteRegister(port, regALERT_VD_MSK);
 
-        port->policy_subindex_++;
-      }
-      break;
-    case 3:
-        if (TimerExpired(&port->policy_state_timer_)) {
-            TimerDisable(&port->policy_state_timer_);
-            port->policy_subindex_++;
-        }
-        else {
-          port->idle_ = TRUE;
-        }
-        break;
-    case 4:
-      if (PolicySend(port, CMTPS_RDY, 0, 0, PE_SRC_Ready,
-                     0, SOP_TYPE_SOP, FALSE) == STAT_SUCCESS) {
-        /* Have entered into a new contract */
-        if (port->policy_has_contract_ == FALSE) {
-          port->policy_has_contract_ = TRUE;
-          SetSinkTx(port, SinkTxNG);
-        }
+      port->registers_.PwrCtrl.AUTO_DISCH = 1;
+      port->registers_.PwrCtrl.FORCE_DISCH = 0;
+      port->registers_.PwrCtrl.DIS_VALARM = 0;
+      WriteRegister(port, regPWRCTRL);
+      /* Optional delay to allow for external switching delays */
+      TimerStart(&port->policy_state_timer_, ktSwitchDelay);
 
-        if (port->source_is_apdo_) {
-          TimerStart(&port->pps_timer_, ktPPSTimeout);
-        }
-        else {
-          TimerDisable(&port->pps_timer_);
-        }
-        notify_observers(EVENT_PD_NEW_CONTRACT, port->port_id_,
-                         &port->usb_pd_contract_);
-      }
-      break;
-    default:
-      set_policy_state(port, PE_ErrorRecovery);
-      break;
+      PT_WAIT_UNTIL(port, TimerExpired(&port->policy_state_timer_));
+      TimerDisable(&port->policy_state_timer_);
+    }
+  }
+
+  PT_SEND(port, status, PolicySend(port, CMTPS_RDY, 0, 0, PE_SRC_Ready,
+          0, SOP_TYPE_SOP, FALSE));
+  if (status == STAT_SUCCESS) {
+    /* Have entered into a new contract */
+    if (port->policy_has_contract_ == FALSE) {
+      port->policy_has_contract_ = TRUE;
+      SetSinkTx(port, SinkTxNG);
+    }
+
+    if (port->source_is_apdo_) {
+      TimerStart(&port->pps_timer_, ktPPSTimeout);
+    }
+    else {
+      TimerDisable(&port->pps_timer_);
+    }
+    notify_observers(EVENT_PD_NEW_CONTRACT, port->port_id_,
+                     &port->usb_pd_contract_);
   }
+
+  PT_END(port);
 }
 
 void PolicySourceReady(struct Port *port)
 {
+  sopMainHeader_t header = {0};
+
   if (port->protocol_msg_rx_) {
     port->protocol_msg_rx_ = FALSE;
     if (port->policy_rx_header_.NumDataObjects == 0) {
@@ -1039,6 +1089,13 @@ void PolicySourceReady(struct Port *port)
         set_policy_state(port, PE_Give_Manufacturer_Info);
         break;
 #endif /* FSC_HAVE_EXTENDED */
+#ifdef FSC_HAVE_FWUP
+      case EMTFWUpdateRequest:
+        if (FwupRequest(port)) {
+          set_policy_state(port, PE_Send_Firmware_Update_Response);
+        }
+        break;
+#endif /* FSC_HAVE_FWUP */
       default:
 #ifndef FSC_HAVE_EXTENDED
         port->protocol_ext_header_.byte[0] =
@@ -1081,7 +1138,16 @@ void PolicySourceReady(struct Port *port)
       port->pd_tx_status_ = txIdle;
     }
   }
-  else if (port->pd_tx_flag_) {
+#ifdef FSC_HAVE_VDM
+  else if (port->policy_is_dfp_ &&
+           port->vdm_auto_state_ != AUTO_VDM_DONE &&
+           !QueueHasGroup(port, port->vdm_auto_group_) &&
+           !QueueFull(port)) {
+    /* Ahead of QueueNext - the next step joins the sequence in progress */
+    AutoVdmDiscovery(port);
+  }
+#endif /* FSC_HAVE_VDM */
+  else if (QueueNext(port)) {
     port->policy_is_ams_ = TRUE;
     if (port->pd_transmit_header_.NumDataObjects == 0) {
       switch (port->pd_transmit_header_.MessageType) {
@@ -1139,8 +1205,14 @@ void PolicySourceReady(struct Port *port)
           break;
       }
     }
-    port->pd_tx_flag_ = FALSE;
   }
+#ifdef FSC_HAVE_FWUP
+  else if (FwupPending(port)) {
+    port->policy_is_ams_ = TRUE;
+    set_policy_state(port, PE_Send_Firmware_Update_Request);
+    port->pd_tx_status_ = txIdle;
+  }
+#endif /* FSC_HAVE_FWUP */
   else if (port->partner_caps_.object == 0) {
     if (!port->policy_wait_on_sink_caps_) {
       TimerStart(&port->policy_state_timer_, 20 * kMSTimeFactor);
@@ -1150,10 +1222,9 @@ void PolicySourceReady(struct Port *port)
     else {
       if (TimerExpired(&port->policy_state_timer_)) {
         TimerDisable(&port->policy_state_timer_);
-        set_policy_state(port, PE_SRC_Get_Sink_Cap);
-        port->policy_is_ams_ = TRUE;
-
-        port->pd_tx_status_ = txIdle;
+        header.MessageType = CMTGetSinkCap;
+        QueueRequest(port, SOP_TYPE_SOP, header, 0, QueuePriorityNormal,
+                     QUEUE_NO_GROUP);
         port->policy_wait_on_sink_caps_ = FALSE;
       }
       else {
@@ -1177,10 +1248,6 @@ void PolicySourceReady(struct Port *port)
     RequestDiscoverIdentity(port, SOP_TYPE_SOP1);
     port->vdm_check_cbl_ = FALSE;
   }
-  else if (port->policy_is_dfp_ &&
-           port->vdm_auto_state_ != AUTO_VDM_DONE) {
-    AutoVdmDiscovery(port);
-  }
 #endif /* FSC_HAVE_VDM */
   else if (port->req_dr_swap_To_ufp_as_src_ == TRUE &&
            port->policy_is_dfp_ == TRUE &&
@@ -1200,10 +1267,8 @@ void PolicySourceReady(struct Port *port)
   }
   else if (port->renegotiate_) {
     port->renegotiate_ = FALSE;
-    port->policy_is_ams_ = TRUE;
-
-    set_policy_state(port, PE_SRC_Send_Capabilities);
-    port->pd_tx_status_ = txIdle;
+    QueueRequest(port, SOP_TYPE_SOP, port->caps_header_source_, 0,
+                 QueuePriorityHigh, QUEUE_NO_GROUP);
   }
   else if (TimerExpired(&port->pps_timer_))
   {
@@ -2073,6 +2138,12 @@ void PolicySinkStartup(struct Port *port)
     WriteRegister(port, regTCPC_CTRL);
   }
 
+  /* And the BIST Test Data overflow count */
+  if (port->registers_.AlertMskH.M_RX_FULL == 1) {
+    port->registers_.AlertMskH.M_RX_FULL = 0;
+    WriteRegister(port, regALERTMSKH);
+  }
+
   port->sink_selected_voltage_ = FSC_VBUS_05_V;
 
   port->usb_pd_contract_.object = 0;
@@ -2139,7 +2210,8 @@ void PolicySinkSendSoftReset(struct Port *port)
       if (PolicySend(port, CMTSoftReset, 0, 0, PE_SNK_Send_Soft_Reset,
                      1, SOP_TYPE_SOP, FALSE) == STAT_SUCCESS) {
         TimerStart(&port->policy_state_timer_, ktSenderResponse);
-        port->waiting_on_hr_ = TRUE;
+        DeadlineArm(port, DeadlineHardReset, &port->policy_state_timer_,
+                    TRANSMIT_HARDRESET);
       }
       break;
     case 1:
@@ -2336,118 +2408,152 @@ void PolicySinkWaitCaps(struct Port *port)
   }
 }
 
-void PolicySinkEvaluateCaps(struct Port *port)
+/* Request the PPS APDO chosen, at sink_pps_ma_ or as much of it as the
+ * APDO gives - or, with no current asked for, the operating power's worth */
+static void PolicySinkRequestPPS(struct Port *port,
+                                 const struct PdoCandidate *choice)
 {
-  /* All math here should be in mv, ma, mw.  Conversion done on incoming
-   * and outgoing values.
-   */
-  FSC_U8 i = 0;
-  FSC_S32 req_position = 0;
-  FSC_U32 obj_voltage = 0;
-  FSC_U32 obj_current = 0;
-  FSC_U32 sel_voltage = 0;
-  FSC_U32 max_power = 0;
-  FSC_U32 obj_power = 0;
-  FSC_U32 req_current = 0;
-
-  TimerDisable(&port->no_response_timer_);
-  port->hard_reset_counter_ = 0;
+  FSC_U32 ma = port->sink_pps_ma_;
 
-  /* Select the highest power object that we are compatible with */
-  for (i = 0; i < port->caps_header_received_.NumDataObjects; i++) {
-    switch (port->caps_received_[i].PDO.SupplyType) {
-      case pdoTypeFixed:
-        obj_voltage = port->caps_received_[i].FPDOSupply.Voltage * 50;
-        if (obj_voltage > port->sink_request_max_voltage_) {
-          continue;
-        }
-        else {
-          obj_current = port->caps_received_[i].FPDOSupply.MaxCurrent * 10;
-          obj_power = (obj_voltage * obj_current) / 1000;
-        }
-        break;
-      case pdoTypeVariable:
-        obj_voltage = port->caps_received_[i].VPDO.MaxVoltage * 50;
-        if (obj_voltage > port->sink_request_max_voltage_) {
-          continue;
-        }
-        else {
-          obj_voltage = port->caps_received_[i].VPDO.MinVoltage * 50;
-          obj_current = port->caps_received_[i].VPDO.MaxCurrent * 10;
-          obj_power = (obj_voltage * obj_current) / 1000;
-        }
-        break;
-      case pdoTypeBattery:
-        /* Ignore battery powered sources (for now) */
-        obj_power = 0;
-        break;
-      case pdoTypeAugmented:
-        //obj_voltage = port->caps_received_[i].PPSDOSupply.MaxVoltage * 100;
-        //obj_current = port->caps_received_[i].PPSDOSupply.MaxCurrent * 50;
-        //obj_power = (obj_voltage * obj_current) / 1000;
-        /* Set object power to 0 to ignore Augmented/PPS sources (for now) */
-        obj_power = 0;
-        break;
-      default:
-        /* Ignore undefined/unsupported supply types */
-        obj_power = 0;
-        break;
-    }
+  if (ma == 0) {
+    ma = (port->sink_request_op_power_ * 1000) / choice->mv_;
+  }
 
-    /* Track object with highest power */
-    if (obj_power >= max_power) {
-      max_power = obj_power;
-      sel_voltage = obj_voltage;
-      req_position = i + 1;
+  port->sink_request_.object = 0;
+  port->sink_request_.PPSRDO.ObjectPosition = choice->position_ & 0x07;
+  port->sink_request_.PPSRDO.NoUSBSuspend = port->sink_usb_suspend_compatible_;
+  port->sink_request_.PPSRDO.USBCommCapable = port->sink_usb_comm_capable_;
+  port->sink_request_.PPSRDO.OpVoltage = (choice->mv_ / 20) & 0x7FF;
+  if (ma > choice->ma_) {
+    /* Indicate that we need more current */
+    port->sink_request_.PPSRDO.CapabilityMismatch = TRUE;
+    ma = choice->ma_;
+  }
+  port->sink_request_.PPSRDO.OpCurrent = (ma / 50) & 0x7F;
+}
 
-      port->sink_partner_max_power_ = max_power;
-    }
+static void PolicySinkRequestBattery(struct Port *port,
+                                     const struct PdoCandidate *choice)
+{
+  FSC_U32 op_mw = port->sink_request_op_power_;
+  FSC_U32 max_mw = port->sink_request_max_power_;
+
+  port->sink_request_.object = 0;
+  port->sink_request_.BRDO.ObjectPosition = choice->position_ & 0x07;
+  port->sink_request_.BRDO.GiveBack = port->sink_goto_min_compatible_;
+  port->sink_request_.BRDO.NoUSBSuspend = port->sink_usb_suspend_compatible_;
+  port->sink_request_.BRDO.USBCommCapable = port->sink_usb_comm_capable_;
+  if (!port->sink_goto_min_compatible_ && max_mw > choice->mw_) {
+    /* Indicate that we need more power */
+    port->sink_request_.BRDO.CapabilityMismatch = TRUE;
+    max_mw = choice->mw_;
+    op_mw = (op_mw > max_mw) ? max_mw : op_mw;
   }
+  /* In 250mW units */
+  port->sink_request_.BRDO.OpPower = (op_mw / 250) & 0x3FF;
+  port->sink_request_.BRDO.MinMaxPower = (max_mw / 250) & 0x3FF;
+}
 
-  /* If another port is sinking the highest power available, we'll just */
-  /* request a basic low power PDO here. */
-  if (port->sink_request_low_power_) {
-    if (port->caps_received_[0].PDO.SupplyType == pdoTypeFixed) {
-      sel_voltage = port->caps_received_[0].FPDOSupply.Voltage * 50;
-    }
-    else if (port->caps_received_[0].PDO.SupplyType == pdoTypeVariable){
-      sel_voltage = port->caps_received_[0].VPDO.MaxVoltage * 50;
+static void PolicySinkRequestFixed(struct Port *port,
+                                   const struct PdoCandidate *choice)
+{
+  FSC_U32 req_current = 0;
+
+  port->sink_request_.object = 0;
+  port->sink_request_.FVRDO.ObjectPosition = choice->position_ & 0x07;
+  port->sink_request_.FVRDO.GiveBack = port->sink_goto_min_compatible_;
+  port->sink_request_.FVRDO.NoUSBSuspend = port->sink_usb_suspend_compatible_;
+  port->sink_request_.FVRDO.USBCommCapable = port->sink_usb_comm_capable_;
+  port->sink_request_.FVRDO.UnchunkedExtMsg =
+      Unchunked_Extended_Messages_Supported;
+  req_current = (port->sink_request_op_power_ * 1000) / choice->mv_;
+  /* Set the current based on the selected voltage (in 10mA units) */
+  port->sink_request_.FVRDO.OpCurrent = ((req_current / 10) & 0x3FF);
+  req_current = (port->sink_request_max_power_ * 1000) / choice->mv_;
+  /* Set the min/max current based on the selected voltage (in 10mA units) */
+  port->sink_request_.FVRDO.MinMaxCurrent = ((req_current / 10) & 0x3FF);
+  if (port->sink_goto_min_compatible_) {
+    port->sink_request_.FVRDO.CapabilityMismatch = FALSE;
+  }
+  else {
+    if (choice->ma_ < req_current) {
+      /* Indicate that we need more power */
+      port->sink_request_.FVRDO.CapabilityMismatch = TRUE;
+      port->sink_request_.FVRDO.MinMaxCurrent = choice->ma_ / 10;
+      port->sink_request_.FVRDO.OpCurrent = choice->ma_ / 10;
     }
     else {
-      /* Skipping battery sources for now... */
+      port->sink_request_.FVRDO.CapabilityMismatch = FALSE;
     }
+  }
+}
+
+/* TRUE if the caps received hold together - the objects the header says,
+ * vSafe5V first.  A later object of a type this code doesn't know makes
+ * the decode PdCodecInvalid too, but PdoSelect only passes it over. */
+static FSC_BOOL PolicySinkCapsValid(struct Port *port)
+{
+  struct PdMessage msg;
+  FSC_U8 frame[2 + 7 * 4];
+  FSC_U8 count = port->caps_header_received_.NumDataObjects;
+  FSC_U8 i = 0;
+  FSC_U8 b = 0;
 
-    /* Make sure the first position is a 5V object */
-    if (sel_voltage == (PD_05_V * 50)) {
-      req_position = 1;
+  if (count == 0) {
+    return FALSE;
+  }
+
+  frame[0] = port->caps_header_received_.byte[0];
+  frame[1] = port->caps_header_received_.byte[1];
+  for (i = 0; i < count; ++i) {
+    for (b = 0; b < 4; ++b) {
+      frame[2 + i * 4 + b] = port->caps_received_[i].byte[b];
     }
   }
 
-  if ((req_position > 0) && (sel_voltage > 0)) {
+  switch (PdDecode(frame, 2 + count * 4, &msg)) {
+    case PdCodecOK:
+      return TRUE;
+    case PdCodecInvalid:
+      return (msg.pdo_[0].kind_ == PdPdoFixed &&
+              msg.pdo_[0].min_mv_ == PD_05_V * 50) ? TRUE : FALSE;
+    default:
+      return FALSE;
+  }
+}
+
+void PolicySinkEvaluateCaps(struct Port *port)
+{
+  /* All math here should be in mv, ma, mw.  Conversion done on incoming
+   * and outgoing values.
+   */
+  struct PdoCandidate choice;
+
+  TimerDisable(&port->no_response_timer_);
+  port->hard_reset_counter_ = 0;
+
+  if (!PolicySinkCapsValid(port)) {
+    /* Nothing here can be requested against */
+    port->sink_partner_max_power_ = 0;
+    set_policy_state(port, PE_SNK_Send_Soft_Reset);
+    return;
+  }
+
+  /* Score every object against the port's goals - see pdosel.h */
+  if (PdoSelect(port, &choice)) {
     port->partner_caps_.object = port->caps_received_[0].object;
-    port->sink_request_.FVRDO.ObjectPosition = req_position & 0x07;
-    port->sink_request_.FVRDO.GiveBack = port->sink_goto_min_compatible_;
-    port->sink_request_.FVRDO.NoUSBSuspend = port->sink_usb_suspend_compatible_;
-    port->sink_request_.FVRDO.USBCommCapable = port->sink_usb_comm_capable_;
-    req_current = (port->sink_request_op_power_ * 1000) / sel_voltage;
-    /* Set the current based on the selected voltage (in 10mA units) */
-    port->sink_request_.FVRDO.OpCurrent = ((req_current / 10) & 0x3FF);
-    req_current = (port->sink_request_max_power_ * 1000) / sel_voltage;
-    /* Set the min/max current based on the selected voltage (in 10mA units) */
-    port->sink_request_.FVRDO.MinMaxCurrent = ((req_current / 10) & 0x3FF);
-    if (port->sink_goto_min_compatible_) {
-      port->sink_request_.FVRDO.CapabilityMismatch = FALSE;
-    }
-    else {
-      if (obj_current < req_current) {
-        /* Indicate that we need more power */
-        port->sink_request_.FVRDO.CapabilityMismatch = TRUE;
-        port->sink_request_.FVRDO.MinMaxCurrent = obj_current / 10;
-        port->sink_request_.FVRDO.OpCurrent = obj_current / 10;
-      }
-      else {
-        port->sink_request_.FVRDO.CapabilityMismatch = FALSE;
-      }
+    port->sink_partner_max_power_ = choice.mw_;
+
+    switch (choice.kind_) {
+      case PdPdoPps:
+        PolicySinkRequestPPS(port, &choice);
+        break;
+      case PdPdoBattery:
+        PolicySinkRequestBattery(port, &choice);
+        break;
+      default:
+        PolicySinkRequestFixed(port, &choice);
+        break;
     }
     set_policy_state(port, PE_SNK_Select_Capability);
   }
@@ -2464,12 +2570,16 @@ void PolicySinkEvaluateCaps(struct Port *port)
 
 void PolicySinkSelectCapability(struct Port *port)
 {
+  FSC_BOOL was_apdo = FALSE;
+  FSC_U32 now = 0;
+
   switch (port->policy_subindex_) {
     case 0:
       if (PolicySend(port, DMTRequest, 4, (FSC_U8 *)&port->sink_request_,
             PE_SNK_Select_Capability, 1, SOP_TYPE_SOP, FALSE) == STAT_SUCCESS) {
         TimerStart(&port->policy_state_timer_, ktSenderResponse);
-        port->waiting_on_hr_ = TRUE;
+        DeadlineArm(port, DeadlineHardReset, &port->policy_state_timer_,
+                    TRANSMIT_HARDRESET);
       }
       break;
     case 1:
@@ -2480,7 +2590,9 @@ void PolicySinkSelectCapability(struct Port *port)
           switch (port->policy_rx_header_.MessageType) {
             case CMTAccept:
               port->policy_has_contract_ = TRUE;
+              was_apdo = port->source_is_apdo_;
               port->source_is_apdo_ = FALSE;
+              TimerDisable(&port->pps_timer_);
 
               port->usb_pd_contract_.object = port->sink_request_.object;
 
@@ -2496,6 +2608,15 @@ void PolicySinkSelectCapability(struct Port *port)
                 port->sink_transition_up_ = FALSE;
                 port->stored_apdo_.object = port->sink_request_.object;
                 TimerStart(&port->pps_timer_, ktPPSRequest);
+
+                /* Keep-alive timing - the source gives up at tPPSTimeout */
+                now = platform_current_time();
+                if (was_apdo &&
+                    now - port->sink_pps_last_ > port->sink_pps_max_interval_) {
+                  port->sink_pps_max_interval_ = now - port->sink_pps_last_;
+                }
+                port->sink_pps_last_ = now;
+                port->sink_pps_requests_++;
               }
               else if (port->caps_received_[
                 port->usb_pd_contract_.FVRDO.ObjectPosition - 1].PDO.SupplyType
@@ -2627,6 +2748,8 @@ void PolicySinkTransitionSink(struct Port *port)
 
 void PolicySinkReady(struct Port *port)
 {
+  sopMainHeader_t header = {0};
+
   if (port->protocol_msg_rx_) {
     port->protocol_msg_rx_ = FALSE;
     if (port->policy_rx_header_.NumDataObjects == 0) {
@@ -2698,6 +2821,13 @@ void PolicySinkReady(struct Port *port)
       case EMTPPSStatus:
         break;
 #endif /* FSC_HAVE_EXTENDED */
+#ifdef FSC_HAVE_FWUP
+      case EMTFWUpdateRequest:
+        if (FwupRequest(port)) {
+          set_policy_state(port, PE_Send_Firmware_Update_Response);
+        }
+        break;
+#endif /* FSC_HAVE_FWUP */
       default:
 #ifndef FSC_HAVE_EXTENDED
         port->protocol_ext_header_.byte[0] =
@@ -2740,7 +2870,29 @@ void PolicySinkReady(struct Port *port)
       port->pd_tx_status_ = txIdle;
     }
   }
-  else if (port->pd_tx_flag_) {
+  else if (port->source_is_apdo_ && TimerExpired(&port->pps_timer_)) {
+    /* PPS keep-alive, ahead of anything else queued - the source drops the
+     * contract if it has no request within tPPSTimeout */
+    TimerDisable(&port->pps_timer_);
+    header.MessageType = DMTRequest;
+    header.NumDataObjects = 1;
+    if (!QueueRequest(port, SOP_TYPE_SOP, header, &port->stored_apdo_,
+                      QueuePriorityHigh, QUEUE_NO_GROUP)) {
+      /* No room - it can't wait */
+      port->sink_request_.object = port->stored_apdo_.object;
+      set_policy_state(port, PE_SNK_Select_Capability);
+    }
+  }
+#ifdef FSC_HAVE_VDM
+  else if (port->policy_is_dfp_ == TRUE &&
+           port->vdm_auto_state_ != AUTO_VDM_DONE &&
+           !QueueHasGroup(port, port->vdm_auto_group_) &&
+           !QueueFull(port)) {
+    /* Ahead of QueueNext - the next step joins the sequence in progress */
+    AutoVdmDiscovery(port);
+  }
+#endif /* FSC_HAVE_VDM */
+  else if (QueueNext(port)) {
     if (port->pd_transmit_header_.NumDataObjects == 0) {
       switch (port->pd_transmit_header_.MessageType) {
         case CMTGetSourceCap:
@@ -2770,6 +2922,7 @@ void PolicySinkReady(struct Port *port)
 #endif /* FSC_HAVE_EXTENDED */
         case CMTGetPPSStatus:
           set_policy_state(port, PE_SNK_Get_PPS_Status);
+          break;
         default:
 #ifdef FSC_DEBUG
           set_policy_state(port, PE_Send_Generic_Cmd);
@@ -2796,8 +2949,13 @@ void PolicySinkReady(struct Port *port)
           break;
       }
     }
-    port->pd_tx_flag_ = FALSE;
   }
+#ifdef FSC_HAVE_FWUP
+  else if (FwupPending(port)) {
+    set_policy_state(port, PE_Send_Firmware_Update_Request);
+    port->pd_tx_status_ = txIdle;
+  }
+#endif /* FSC_HAVE_FWUP */
   else if (port->cbl_rst_state_ > CBL_RST_DISABLED)
   {
     ProcessCableResetState(port);
@@ -2827,20 +2985,12 @@ void PolicySinkReady(struct Port *port)
     RequestDiscoverIdentity(port, SOP_TYPE_SOP1);
     port->vdm_check_cbl_ = FALSE;
   }
-  else if (port->policy_is_dfp_ == TRUE &&
-      port->vdm_auto_state_ != AUTO_VDM_DONE) {
-    AutoVdmDiscovery(port);
-  }
 #endif /* FSC_HAVE_VDM */
   else if (port->renegotiate_) {
+    /* The caps held from the last Source_Capabilities do - no need to ask */
     port->renegotiate_ = FALSE;
     set_policy_state(port, PE_SNK_Evaluate_Capability);
   }
-  else if (port->source_is_apdo_ && TimerExpired(&port->pps_timer_)) {
-    TimerDisable(&port->pps_timer_);
-    port->sink_request_.object = port->stored_apdo_.object;
-    set_policy_state(port, PE_SNK_Select_Capability);
-  }
 #ifdef FSC_HAVE_FRSWAP
   else if (port->is_fr_swap_) {
     set_policy_state(port, PE_FRS_SNK_SRC_Send_Swap);
@@ -3208,112 +3358,118 @@ void PolicySinkEvaluateVCONNSwap(struct Port *port)
 void PolicySinkSendPRSwap(struct Port *port)
 {
 #ifdef FSC_HAVE_DRP
-  FSC_U8 status;
+  FSC_U8 status = STAT_BUSY;
   port->req_pr_swap_as_snk_  = FALSE;
-  switch (port->policy_subindex_) {
-    case 0:
-      if (PolicySend(port, CMTPR_Swap, 0, 0, PE_PRS_SNK_SRC_Send_Swap,
-                     1, SOP_TYPE_SOP, FALSE) == STAT_SUCCESS) {
-        TimerStart(&port->policy_state_timer_, ktSenderResponse);
-      }
-      break;
-    case 1:
-      /* Require Accept message to move on or go back to ready state */
-      if (port->protocol_msg_rx_) {
-        port->protocol_msg_rx_ = FALSE;
-        if (port->policy_rx_header_.NumDataObjects == 0) {
-          switch (port->policy_rx_header_.MessageType) {
-            case CMTAccept:
-              port->is_pr_swap_ = TRUE;
-              port->policy_has_contract_ = FALSE;
 
-              port->registers_.PwrCtrl.AUTO_DISCH = 0;
-              WriteRegister(port, regPWRCTRL);
+  PT_BEGIN(port);
 
-              SendCommand(port, DisableSinkVbus);
+  PT_SEND(port, status, PolicySend(port, CMTPR_Swap, 0, 0,
+          PE_PRS_SNK_SRC_Send_Swap, PT_SENT, SOP_TYPE_SOP, FALSE));
+  if (status == STAT_SUCCESS) {
+    TimerStart(&port->policy_state_timer_, ktSenderResponse);
+  }
+  else if (PT_LEFT(port)) {
+    return;
+  }
 
-              TimerStart(&port->policy_state_timer_, ktPSSourceOff);
-              port->policy_subindex_++;
-              break;
-            case CMTWait:
-            case CMTReject:
-            case CMTNotSupported:
-              set_policy_state(port, PE_SNK_Ready);
-              port->is_pr_swap_ = FALSE;
-              port->pd_tx_status_ = txIdle;
-              break;
-            default:
-              /* Interrupted */
-              set_policy_state(port, PE_SNK_Send_Soft_Reset);
-              break;
-          }
-        }
-      }
-      else if (TimerExpired(&port->policy_state_timer_)) {
-        TimerDisable(&port->policy_state_timer_);
+  /* Require Accept message to move on or go back to ready state */
+  PT_RESUME_POINT(port);
+  if (port->protocol_msg_rx_) {
+    port->protocol_msg_rx_ = FALSE;
+    if (port->policy_rx_header_.NumDataObjects != 0) {
+      return;
+    }
+
+    switch (port->policy_rx_header_.MessageType) {
+      case CMTAccept:
+        break;
+      case CMTWait:
+      case CMTReject:
+      case CMTNotSupported:
         set_policy_state(port, PE_SNK_Ready);
         port->is_pr_swap_ = FALSE;
         port->pd_tx_status_ = txIdle;
-      }
-      else {
-        port->idle_ = TRUE;
-      }
-      break;
-    case 2:
-      /* Wait for a PS_RDY message to be received to indicate that the */
-      /* original source is no longer supplying VBUS */
-      if (port->protocol_msg_rx_) {
-        port->protocol_msg_rx_ = FALSE;
-        if (port->policy_rx_header_.NumDataObjects == 0) {
-          switch (port->policy_rx_header_.MessageType) {
-            case CMTPS_RDY:
-              port->policy_is_source_ = TRUE;
+        return;
+      default:
+        /* Interrupted */
+        set_policy_state(port, PE_SNK_Send_Soft_Reset);
+        return;
+    }
+  }
+  else if (TimerExpired(&port->policy_state_timer_)) {
+    TimerDisable(&port->policy_state_timer_);
+    set_policy_state(port, PE_SNK_Ready);
+    port->is_pr_swap_ = FALSE;
+    port->pd_tx_status_ = txIdle;
+    return;
+  }
+  else {
+    port->idle_ = TRUE;
+    return;
+  }
 
-              RoleSwapToAttachedSource(port);
+  port->is_pr_swap_ = TRUE;
+  port->policy_has_contract_ = FALSE;
 
-              port->registers_.MsgHeadr.POWER_ROLE = port->policy_is_source_;
-              WriteRegister(port, regMSGHEADR);
-              TimerDisable(&port->policy_state_timer_);
-              port->policy_subindex_++;
-              break;
-            default:
-              break;
-          }
-        }
-      }
-      else if (TimerExpired(&port->policy_state_timer_)) {
-        TimerDisable(&port->policy_state_timer_);
-        port->is_pr_swap_ = FALSE;
+  port->registers_.PwrCtrl.AUTO_DISCH = 0;
+  WriteRegister(port, regPWRCTRL);
 
-        /* Note: Compliance testing seems to require BOTH HR and ER here. */
-        PolicySinkSendHardReset(port);
-        set_policy_state(port, PE_ErrorRecovery);
+  SendCommand(port, DisableSinkVbus);
 
-        port->pd_tx_status_ = txIdle;
-      }
-      else {
-        port->idle_ = TRUE;
-      }
-      break;
-    case 3:
-      if (IsVbusVSafe5V(port)) {
-        status = PolicySend(port, CMTPS_RDY, 0, 0, PE_SRC_Startup,
-                            0, SOP_TYPE_SOP, FALSE);
-        if (status == STAT_ERROR) {
-          set_policy_state(port, PE_ErrorRecovery);
-        }
-        else if (status == STAT_SUCCESS){
-          port->registers_.PwrCtrl.AUTO_DISCH = 1;
-          WriteRegister(port, regPWRCTRL);
+  TimerStart(&port->policy_state_timer_, ktPSSourceOff);
 
-          TimerStart(&port->swap_source_start_timer_, ktSwapSourceStart);
-        }
-      }
-      break;
-    default:
-      set_policy_state(port, PE_ErrorRecovery);
-      break;
+  /* Wait for a PS_RDY message to be received to indicate that the */
+  /* original source is no longer supplying VBUS */
+  PT_RESUME_POINT(port);
+  if (port->protocol_msg_rx_) {
+    port->protocol_msg_rx_ = FALSE;
+    if (port->policy_rx_header_.NumDataObjects != 0 ||
+        port->policy_rx_header_.MessageType != CMTPS_RDY) {
+      return;
+    }
+  }
+  else if (TimerExpired(&port->policy_state_timer_)) {
+    TimerDisable(&port->policy_state_timer_);
+    port->is_pr_swap_ = FALSE;
+
+    /* Note: Compliance testing seems to require BOTH HR and ER here. */
+    PolicySinkSendHardReset(port);
+    set_policy_state(port, PE_ErrorRecovery);
+
+    port->pd_tx_status_ = txIdle;
+    return;
+  }
+  else {
+    port->idle_ = TRUE;
+    return;
+  }
+
+  port->policy_is_source_ = TRUE;
+
+  RoleSwapToAttachedSource(port);
+
+  port->registers_.MsgHeadr.POWER_ROLE = port->policy_is_source_;
+  WriteRegister(port, regMSGHEADR);
+  TimerDisable(&port->policy_state_timer_);
+
+  PT_RESUME_POINT(port);
+  if (!IsVbusVSafe5V(port)) {
+    return;
+  }
+
+  PT_SEND(port, status, PolicySend(port, CMTPS_RDY, 0, 0, PE_SRC_Startup,
+          0, SOP_TYPE_SOP, FALSE));
+  if (status == STAT_ERROR) {
+    set_policy_state(port, PE_ErrorRecovery);
+  }
+  else if (status == STAT_SUCCESS){
+    port->registers_.PwrCtrl.AUTO_DISCH = 1;
+    WriteRegister(port, regPWRCTRL);
+
+    TimerStart(&port->swap_source_start_timer_, ktSwapSourceStart);
   }
+
+  PT_END(port);
 #endif /* FSC_HAVE_DRP */
 }
 
@@ -3613,13 +3769,7 @@ void PolicyDFPCBLSendReset(struct Port *port)
 #ifdef FSC_HAVE_EXTENDED
 void PolicyGetSecurityMsg(struct Port *port)
 {
-  FSC_U16 i;
-
   /* Send a request to the partner for a Security Response msg */
-  for (i = 0; i < MAX_EXT_MSG_LEN; i++) {
-    port->protocol_ext_buffer_[i] = 0;
-  }
-
   PolicySend(port, EMTSecurityRequest, 0, 0,
              port->policy_is_source_ ? PE_SRC_Ready : PE_SNK_Ready,
              0, SOP_TYPE_SOP, TRUE);
@@ -3629,7 +3779,12 @@ void PolicySendSecurityMsg(struct Port *port)
 {
   FSC_U16 i;
 
-  /* Send a Security Response msg to the partner */
+  /* Send a Security Response msg to the partner, composed in place */
+  if (!ExtPoolLeaseOrWait(port)) {
+    port->idle_ = TRUE;
+    return;
+  }
+
   for (i = 0; i < MAX_EXT_MSG_LEN; i++) {
     /* Not a security message - just an array for testing chunking */
     port->protocol_ext_buffer_[i] = (i < 50) ? i : 0;
@@ -3779,7 +3934,8 @@ void PolicyGiveManufacturerInfo(struct Port *port)
     buf[3] = (Manufacturer_Info_PID_Port & 0xFF00) >> 8;
 
     /* Manufacturer string */
-    if (port->protocol_ext_buffer_[0] > 1 ||
+    if (port->protocol_ext_buffer_ == 0 ||
+        port->protocol_ext_buffer_[0] > 1 ||
         port->protocol_ext_buffer_[1] > 7) {
       /* Unknown/reserved target/ref request */
       len = sizeof(buf);
@@ -3800,6 +3956,84 @@ void PolicyGiveManufacturerInfo(struct Port *port)
 
 #endif /* FSC_HAVE_EXTENDED */
 
+#ifdef FSC_HAVE_FWUP
+void PolicySendFwUpdateRequest(struct Port *port)
+{
+  FSC_U8 status = STAT_BUSY;
+
+  switch (port->policy_subindex_)
+  {
+  case 0:
+    if (port->pd_tx_status_ == txIdle && !FwupCompose(port)) {
+      /* No extended buffer free - the pool wakes the port for another go */
+      port->idle_ = TRUE;
+      break;
+    }
+
+    status = PolicySend(port, EMTFWUpdateRequest, port->fwup_msg_len_,
+                        port->protocol_ext_buffer_,
+                        PE_Send_Firmware_Update_Request, 1,
+                        SOP_TYPE_SOP, TRUE);
+    if (status == STAT_SUCCESS)
+    {
+      TimerStart(&port->policy_state_timer_, ktFwupResponse);
+    }
+    else if (status == STAT_ERROR)
+    {
+      FwupNoResponse(port);
+      set_policy_state(port,
+                       port->policy_is_source_ ? PE_SRC_Ready : PE_SNK_Ready);
+    }
+    break;
+  default:
+    if (port->protocol_msg_rx_) {
+      port->protocol_msg_rx_ = FALSE;
+      port->pd_tx_status_ = txIdle;
+      TimerDisable(&port->policy_state_timer_);
+      if ((port->policy_rx_header_.Extended == 1) &&
+          (port->policy_rx_header_.MessageType == EMTFWUpdateResponse))
+      {
+        set_policy_state(port, PE_Firmware_Update_Response_Received);
+      }
+      else
+      {
+        FwupNoResponse(port);
+        set_policy_state(port, port->policy_is_source_ ?
+                PE_SRC_Send_Soft_Reset : PE_SNK_Send_Soft_Reset);
+      }
+    }
+    else if (TimerExpired(&port->policy_state_timer_))
+    {
+      TimerDisable(&port->policy_state_timer_);
+      FwupNoResponse(port);
+      set_policy_state(port,
+                       port->policy_is_source_ ? PE_SRC_Ready : PE_SNK_Ready);
+    }
+    else
+    {
+      port->idle_ = TRUE;
+    }
+    break;
+  }
+}
+
+void PolicySendFwUpdateResponse(struct Port *port)
+{
+  /* FwupRequest built it over the request, in the buffer still leased */
+  PolicySend(port, EMTFWUpdateResponse, port->fwup_msg_len_,
+             port->protocol_ext_buffer_,
+             port->policy_is_source_ ? PE_SRC_Ready : PE_SNK_Ready, 0,
+             SOP_TYPE_SOP, TRUE);
+}
+
+void PolicyFwUpdateResponseReceived(struct Port *port)
+{
+  /* Builds the next request, sent from Ready when it's due */
+  FwupResponse(port);
+  set_policy_state(port, port->policy_is_source_ ? PE_SRC_Ready : PE_SNK_Ready);
+}
+#endif /* FSC_HAVE_FWUP */
+
 void UpdateCapabilitiesRx(struct Port *port, FSC_BOOL is_source_cap_update)
 {
   FSC_U8 i = 0;
@@ -3964,7 +4198,7 @@ FSC_U8 PolicySend(struct Port *port, FSC_U8 message_type,
           (port->policy_sinktx_state_ == SinkTxOK)) {
         /* If PD 3.0, set CC SinkTxNG and wait out SinkTx timer */
         SetSinkTx(port, SinkTxNG);
-        TimerStart(&port->policy_sinktx_timer_, ktSinkTx);
+        TimerStart(&port->policy_sinktx_timer_, LinkSinkTxTime(port));
         port->pd_tx_status_ = txPending;
         break;
       }
@@ -3983,55 +4217,86 @@ FSC_U8 PolicySend(struct Port *port, FSC_U8 message_type,
       /* Continue on with transmission */
       TimerDisable(&port->policy_sinktx_timer_);
 
-      port->policy_tx_header_.word = 0x0000;
-      port->policy_tx_header_.MessageType = message_type & PDMsgTypeMask;
-      if (sop == SOP_TYPE_SOP)
-      {
-        port->policy_tx_header_.PortDataRole = port->policy_is_dfp_;
-        port->policy_tx_header_.PortPowerRole = port->policy_is_source_;
+#ifdef FSC_HAVE_EXTENDED
+      if (extended && !ExtPoolLeaseOrWait(port)) {
+        /* No extended buffer free - the pool wakes the port for another go */
+        port->pd_tx_status_ = txPending;
+        port->idle_ = TRUE;
+        break;
       }
+#endif /* FSC_HAVE_EXTENDED */
 
-      port->policy_tx_header_.SpecRevision = DPM_CurrentSpecRev(port, sop);
-      port->protocol_retries_ =
-          (port->policy_tx_header_.SpecRevision == PDSpecRev3p0) ?
-                  RETRIES_PD30 : RETRIES_PD20;
-#ifdef FSC_HAVE_EXTENDED
-      if (extended) {
-        /* Extended Data Message */
-        port->protocol_ext_num_bytes_ =
-          (num_bytes > MAX_EXT_MSG_LEN) ? MAX_EXT_MSG_LEN : num_bytes;
+      /* Committed - ProtocolTransmitMessage times it to TRANSMIT */
+      port->protocol_tx_decided_ = platform_current_time();
+      port->protocol_tx_timed_ = TRUE;
 
-        for (i = 0; i < port->protocol_ext_num_bytes_; i++) {
-          port->protocol_ext_buffer_[i] = data[i];
+      port->policy_tx_template_id_ =
+          TemplateFind(port, message_type, num_bytes, data, sop, extended);
+      if (TemplateLoad(port, port->policy_tx_template_id_)) {
+        /* Encoded last time - header and data objects as they were */
+      }
+      else {
+        port->policy_tx_header_.word = 0x0000;
+        port->policy_tx_header_.MessageType = message_type & PDMsgTypeMask;
+        if (sop == SOP_TYPE_SOP)
+        {
+          port->policy_tx_header_.PortDataRole = port->policy_is_dfp_;
+          port->policy_tx_header_.PortPowerRole = port->policy_is_source_;
         }
 
-        port->policy_tx_header_.Extended = TRUE;
-        port->protocol_ext_chunk_number_ = 0;
-        port->protocol_ext_send_chunk_ = TRUE;
-        port->protocol_ext_state_active_ = TRUE;
-      }
-      else
-#endif /* FSC_HAVE_EXTENDED */
-        if (num_bytes > 0) {
-        /* Standard Data Message */
-        if (num_bytes > MAX_MSG_LEGACY_LEN) {
-          num_bytes = MAX_MSG_LEGACY_LEN;
+        port->policy_tx_header_.SpecRevision = DPM_CurrentSpecRev(port, sop);
+#ifdef FSC_HAVE_EXTENDED
+        if (extended) {
+          /* Extended Data Message */
+          port->protocol_ext_num_bytes_ =
+            (num_bytes > MAX_EXT_MSG_LEN) ? MAX_EXT_MSG_LEN : num_bytes;
+
+          for (i = 0; i < port->protocol_ext_num_bytes_; i++) {
+            port->protocol_ext_buffer_[i] = data[i];
+          }
+
+          port->policy_tx_header_.Extended = TRUE;
+          port->protocol_ext_chunk_number_ = 0;
+          port->protocol_ext_send_chunk_ = TRUE;
+          port->protocol_ext_state_active_ = TRUE;
         }
+        else
+#endif /* FSC_HAVE_EXTENDED */
+          if (num_bytes > 0) {
+          /* Standard Data Message */
+          if (num_bytes > MAX_MSG_LEGACY_LEN) {
+            num_bytes = MAX_MSG_LEGACY_LEN;
+          }
+
+          port->policy_tx_header_.NumDataObjects = num_bytes / 4;
 
-        port->policy_tx_header_.NumDataObjects = num_bytes / 4;
-        for (i = 0; i < port->policy_tx_header_.NumDataObjects; i++) {
-          port->policy_tx_data_obj_[i].byte[0] = data[i * 4 + 0];
-          port->policy_tx_data_obj_[i].byte[1] = data[i * 4 + 1];
-          port->policy_tx_data_obj_[i].byte[2] = data[i * 4 + 2];
-          port->policy_tx_data_obj_[i].byte[3] = data[i * 4 + 3];
+          /* Callers may compose the payload in policy_tx_data_obj_ */
+          if (data != (FSC_U8 *)port->policy_tx_data_obj_) {
+            for (i = 0; i < port->policy_tx_header_.NumDataObjects; i++) {
+              port->policy_tx_data_obj_[i].byte[0] = data[i * 4 + 0];
+              port->policy_tx_data_obj_[i].byte[1] = data[i * 4 + 1];
+              port->policy_tx_data_obj_[i].byte[2] = data[i * 4 + 2];
+              port->policy_tx_data_obj_[i].byte[3] = data[i * 4 + 3];
+            }
+          }
+        }
+        else {
+          /* Control Message */
         }
 
-        if (port->policy_state_ == PE_SRC_Send_Capabilities) {
-          port->caps_counter_++;
+        if (port->policy_tx_template_id_ != TplNone) {
+          TemplateStore(port, port->policy_tx_template_id_);
         }
       }
-      else {
-        /* Control Message */
+
+      port->protocol_retries_ = LinkRetries(port, sop,
+          (port->policy_tx_header_.SpecRevision == PDSpecRev3p0) ?
+                  RETRIES_PD30 : RETRIES_PD20);
+
+      if (port->policy_state_ == PE_SRC_Send_Capabilities &&
+          !port->policy_tx_header_.Extended &&
+          port->policy_tx_header_.NumDataObjects > 0) {
+        port->caps_counter_++;
       }
 
       port->protocol_msg_tx_sop_ = sop;
@@ -4044,6 +4309,10 @@ FSC_U8 PolicySend(struct Port *port, FSC_U8 message_type,
     case txSend:
     case txBusy:
     case txWait:
+      if (DeadlinePending(port, DeadlineTransmit)) {
+        /* Staged - sleep until the deadline action sends it */
+        port->idle_ = TRUE;
+      }
       /* Waiting for GoodCRC or timeout of the protocol */
       if (TimerExpired(&port->protocol_timer_)){
         TimerDisable(&port->protocol_timer_);
@@ -4167,8 +4436,17 @@ void ProcessDmtBist(struct Port *port)
       /* Mask everything but HARDRST and VBUSOK */
       if (port->caps_source_[port->usb_pd_contract_.FVRDO.ObjectPosition - 1]
           .FPDOSupply.Voltage == PD_05_V) {
-        port->registers_.TcpcCtrl.BIST_TMODE = 1;
-        WriteRegister(port, regTCPC_CTRL);
+        if (port->bist_measure_) {
+          /* In test mode the TCPC need not pass the frames up - to count
+           * them, stay in normal mode and take every one off it */
+          PolicyBISTClearStats(port);
+          port->registers_.AlertMskH.M_RX_FULL = 1;
+          WriteRegister(port, regALERTMSKH);
+        }
+        else {
+          port->registers_.TcpcCtrl.BIST_TMODE = 1;
+          WriteRegister(port, regTCPC_CTRL);
+        }
 
         set_policy_state(port, PE_BIST_Test_Data);
         port->protocol_state_ = PRLDisabled;
@@ -4226,7 +4504,58 @@ void PolicyBISTCarrierMode2(struct Port *port)
 
 void PolicyBISTTestData(struct Port *port)
 {
-  /* Nothing needed here.  Wait for detach or reset to end this mode. */
+  sopMainHeader_t header = {0};
+  FSC_U32 now = 0;
+
+  /* Wait for detach or reset to end this mode.  The TCPC GoodCRCs the
+   * frames - any it passes up are taken off it, and counted if measuring. */
+  if (port->registers_.AlertH.I_RX_FULL) {
+    ClearInterrupt(port, regALERTH, MSK_I_RX_FULL);
+    port->bist_overflows_++;
+  }
+
+  if (port->registers_.AlertL.I_RXSTAT) {
+    if (port->bist_measure_ && ReadRxFrame(port, port->protocol_rx_head_)) {
+      header.byte[0] = port->protocol_rx_head_[2];
+      header.byte[1] = port->protocol_rx_head_[3];
+      now = platform_current_time();
+
+      if (port->bist_frames_ > 0 &&
+          header.MessageID == port->bist_last_id_) {
+        /* Sent again - the first try failed CRC here or lost its GoodCRC */
+        port->bist_repeats_++;
+      }
+      else if (header.NumDataObjects == 7 &&
+               header.MessageType == DMTBIST) {
+        if (port->bist_frames_ == 0) {
+          port->bist_first_ = now;
+        }
+        port->bist_frames_++;
+        port->bist_bytes_ += 2 + COMM_BUFFER_LENGTH;
+        port->bist_last_ = now;
+      }
+      else {
+        port->bist_other_++;
+      }
+      port->bist_last_id_ = header.MessageID;
+    }
+
+    ClearInterrupt(port, regALERTL, MSK_I_RXSTAT);
+  }
+
+  port->idle_ = TRUE;
+}
+
+void PolicyBISTClearStats(struct Port *port)
+{
+  port->bist_frames_ = 0;
+  port->bist_bytes_ = 0;
+  port->bist_repeats_ = 0;
+  port->bist_overflows_ = 0;
+  port->bist_other_ = 0;
+  port->bist_first_ = 0;
+  port->bist_last_ = 0;
+  port->bist_last_id_ = 0;
 }
 
 void PolicyInvalidState(struct Port *port)
@@ -21,6 +21,8 @@
  * Implements the port interface for the port manager.
  * ************************************************************************** */
 
+#include <stddef.h>
+
 #include "port.h"
 #include "dpm.h"
 #include "vendor_info.h"
@@ -36,11 +38,13 @@
  * initial configuration values to the device.
  */
 
-void InitializeVars(struct Port *port, FSC_U8 id, FSC_U8 i2c_addr)
+void InitializeVars(struct Port *port, FSC_U8 id, FSC_U8 i2c_bus,
+                    FSC_U8 i2c_addr)
 {
   FSC_U32 i = 0;
 
   port->port_id_ = id;
+  port->i2c_bus_ = i2c_bus;
   port->i2c_addr_ = i2c_addr;
   port->idle_ = FALSE;
   port->initialized_ = FALSE;
@@ -79,21 +83,60 @@ void InitializeVars(struct Port *port, FSC_U8 id, FSC_U8 i2c_addr)
   port->pd_enabled_ = USB_PD_Support;
   port->protocol_state_ = PRLDisabled;
   port->pd_tx_status_ = txIdle;
-  port->pd_tx_flag_ = FALSE;
+  port->queue_last_group_ = QUEUE_NO_GROUP;
+  port->queue_started_ = 0;
+  port->queue_dropped_ = 0;
+  port->queue_wait_ = 0;
+  port->queue_max_wait_ = 0;
+  QueueFlush(port);
+  port->protocol_rx_fifo_high_ = 0;
+  port->protocol_rx_fifo_full_ = 0;
+  RxFifoFlush(port);
+  LinkClear(port);
+  LinkRestart(port);
+#ifdef FSC_HAVE_FWUP
+  port->fwup_state_ = FwupIdle;
+  port->fwup_status_ = FwupOK;
+  port->fwup_queued_ = 0;
+  port->fwup_writing_ = FALSE;
+  port->fwup_time_ = 0;
+  port->fwup_rate_ = 0;
+  port->fwup_crc_errors_ = 0;
+  TimerDisable(&port->fwup_timer_);
+#endif /* FSC_HAVE_FWUP */
+#ifdef FSC_HAVE_SNIFFER
+  port->sniffer_ = FALSE;
+  port->sniffer_alert_time_ = 0;
+#endif /* FSC_HAVE_SNIFFER */
   port->policy_msg_tx_sop_ = SOP_TYPE_SOP;
   port->protocol_msg_rx_ = FALSE;
   port->protocol_msg_rx_sop_ = SOP_TYPE_SOP;
   port->protocol_msg_tx_sop_ = SOP_TYPE_SOP;
   port->protocol_retries_ = RETRIES_PD30;
   port->protocol_use_sinktx_ = FALSE;
-  port->waiting_on_hr_ = FALSE;
+  port->protocol_tx_timer_ = 0;
+  port->protocol_rx_count_ = 0;
+  port->protocol_rx_cycles_ = 0;
+  port->protocol_max_rx_cycles_ = 0;
+  port->protocol_tx_timed_ = FALSE;
+  port->protocol_tx_decided_ = 0;
+  port->protocol_tx_count_ = 0;
+  port->protocol_tx_latency_ = 0;
+  port->protocol_max_tx_latency_ = 0;
+  DeadlineReset(port);
 #ifdef FSC_HAVE_EXTENDED
+  ExtPoolRelease(port);
   port->protocol_ext_num_bytes_ = 0;
   port->protocol_ext_chunk_number_ = 0;
   port->protocol_ext_request_chunk_ = 0;
   port->protocol_ext_send_chunk_ = FALSE;
   port->protocol_ext_request_cmd_ = 0;
   port->protocol_chunking_supported_ = TRUE;
+  TimerDisable(&port->protocol_chunk_timer_);
+  port->protocol_ext_rx_count_ = 0;
+  port->protocol_ext_rx_time_ = 0;
+  port->protocol_ext_rx_max_time_ = 0;
+  port->protocol_ext_rx_timeouts_ = 0;
 #ifdef FSC_HAVE_SRC
   port->policy_src_cap_ext_.VID = Manufacturer_Info_VID_Port;
   port->policy_src_cap_ext_.PID = Manufacturer_Info_PID_Port;
@@ -102,6 +145,7 @@ void InitializeVars(struct Port *port, FSC_U8 id, FSC_U8 i2c_addr)
 #endif /* FSC_HAVE_EXTENDED */
   port->policy_state_ = PE_SRC_Disabled;
   port->policy_subindex_ = 0;
+  port->policy_pt_ = 0;
   port->policy_is_ams_ = FALSE;
   port->policy_sinktx_state_ = SinkTxNG;
 
@@ -114,6 +158,15 @@ void InitializeVars(struct Port *port, FSC_U8 id, FSC_U8 i2c_addr)
   port->caps_counter_ = 0;
   port->policy_has_contract_ = FALSE;
   port->needs_goto_min_ = FALSE;
+  port->bist_measure_ = FALSE;
+  port->bist_frames_ = 0;
+  port->bist_bytes_ = 0;
+  port->bist_repeats_ = 0;
+  port->bist_overflows_ = 0;
+  port->bist_other_ = 0;
+  port->bist_first_ = 0;
+  port->bist_last_ = 0;
+  port->bist_last_id_ = 0;
   port->renegotiate_ = FALSE;
   port->policy_wait_on_sink_caps_ = FALSE;
   port->sink_selected_voltage_ = FSC_VBUS_05_V;
@@ -130,6 +183,12 @@ void InitializeVars(struct Port *port, FSC_U8 id, FSC_U8 i2c_addr)
   port->partner_caps_available_ = FALSE;
   port->pd_HV_option_ = FSC_VBUS_09_V;
   port->source_is_apdo_ = FALSE;
+  port->sink_pps_mv_ = 0;
+  port->sink_pps_ma_ = 0;
+  port->sink_pps_requests_ = 0;
+  port->sink_pps_last_ = 0;
+  port->sink_pps_max_interval_ = 0;
+  PdoSelInit(port);
   port->pd_preferred_rev_ = PD_Specification_Revision;
 
 #if defined(FSC_DEBUG) || defined(FSC_HAVE_USBHID)
@@ -198,6 +257,22 @@ void InitializeVars(struct Port *port, FSC_U8 id, FSC_U8 i2c_addr)
   VIF_InitializeSrcCaps(port->caps_source_);
 #endif /* FSC_HAVE_SRC */
 
+#ifdef FSC_HAVE_BUDGET
+  BudgetInit(port);
+#endif /* FSC_HAVE_BUDGET */
+
+  /* Response templates are built as they are first sent */
+  for (i = 0; i < NUM_TX_TEMPLATES; ++i) {
+    port->policy_tx_template_[i].key_ = 0;
+    port->policy_tx_template_[i].builds_ = 0;
+    port->policy_tx_template_[i].count_ = 0;
+    port->policy_tx_template_[i].latency_ = 0;
+    port->policy_tx_template_[i].max_latency_ = 0;
+  }
+  port->policy_tx_template_gen_ = 0;
+  port->policy_tx_template_id_ = TplNone;
+  TemplateInvalidate(port);
+
 #ifdef FSC_HAVE_VDM
   TimerDisable(&port->vdm_timer_);
 
@@ -206,7 +281,9 @@ void InitializeVars(struct Port *port, FSC_U8 id, FSC_U8 i2c_addr)
   port->vdm_expecting_response_ = FALSE;
   port->vdm_sending_data_ = FALSE;
   port->vdm_auto_state_ = AUTO_VDM_INIT;
+  port->vdm_auto_group_ = QUEUE_NO_GROUP;
   port->vdm_msg_length_ = 0;
+  port->vdm_tx_template_ = TplNone;
   port->vdm_msg_tx_sop_ = SOP_TYPE_SOP;
   port->svid_discv_idx_ = -1;
   port->svid_discvry_done_ = FALSE;
@@ -218,9 +295,6 @@ void InitializeVars(struct Port *port, FSC_U8 id, FSC_U8 i2c_addr)
   port->mode_entered_ = FALSE;
   port->discover_id_counter_ = 0;
 
-  for (i = 0; i < 7; ++i) {
-    port->vdm_msg_obj_[i].object = 0;
-  }
   port->auto_mode_entry_pos_ = -1;
   port->auto_mode_entry_enabled_ = TRUE;
 
@@ -294,13 +368,15 @@ void InitializePort(struct Port *port)
 /* Register Update Functions */
 FSC_BOOL ReadRegister(struct Port *port, enum RegAddress regaddress)
 {
-  return platform_i2c_read(port->i2c_addr_, (FSC_U8)regaddress, 1,
+  return platform_i2c_read(port->i2c_bus_, port->i2c_addr_,
+                           (FSC_U8)regaddress, 1,
                            AddressToRegister(&port->registers_, regaddress));
 }
 
 FSC_BOOL ReadRegisters(struct Port *port, enum RegAddress regaddr, FSC_U8 cnt)
 {
-  return platform_i2c_read(port->i2c_addr_, (FSC_U8)regaddr, cnt,
+  return platform_i2c_read(port->i2c_bus_, port->i2c_addr_,
+                           (FSC_U8)regaddr, cnt,
                            AddressToRegister(&port->registers_, regaddr));
 }
 
@@ -385,34 +461,52 @@ void ReadAllRegisters(struct Port *port)
   ReadRegister(port, regRPVAL_OVERRIDE);
 }
 
-void ReadRxRegisters(struct Port *port, FSC_U8 numbytes)
-{
-  /* Check length limit */
-  if (numbytes > COMM_BUFFER_LENGTH) numbytes = COMM_BUFFER_LENGTH;
+/* Frames go over the bus as laid out - the data objects have to follow the
+ * 4 head bytes with no gap and be 4 bytes each */
+_Static_assert(offsetof(struct Port, policy_tx_data_obj_) ==
+               offsetof(struct Port, protocol_tx_head_) + 4 &&
+               sizeof(doDataObject_t) == 4 &&
+               4 + 7 * sizeof(doDataObject_t) == RXFIFO_FRAME_SIZE,
+               "RX/TX frame layout");
+#ifdef FSC_HAVE_EXTENDED
+_Static_assert(offsetof(struct Port, protocol_chunk_obj_) ==
+               offsetof(struct Port, protocol_chunk_head_) + 4,
+               "Chunk frame layout");
+#endif /* FSC_HAVE_EXTENDED */
 
-  platform_i2c_read(port->i2c_addr_, regRXDATA_00,
-                    numbytes, port->registers_.RxData);
+FSC_BOOL ReadRxFrame(struct Port *port, FSC_U8 *frame)
+{
+  /* RXBYTECNT counts the bytes after it - RXSTAT, header and data */
+  return platform_i2c_block_read(port->i2c_bus_, port->i2c_addr_,
+                                 regRXBYTECNT, RXFIFO_FRAME_SIZE, frame);
 }
 
 void WriteRegister(struct Port *port, enum RegAddress regaddress)
 {
-  platform_i2c_write(port->i2c_addr_, (FSC_U8)regaddress, 1,
+  platform_i2c_write(port->i2c_bus_, port->i2c_addr_,
+                     (FSC_U8)regaddress, 1,
                      AddressToRegister(&port->registers_, regaddress));
 }
 
 void WriteRegisters(struct Port *port, enum RegAddress regaddr, FSC_U8 cnt)
 {
-  platform_i2c_write(port->i2c_addr_, (FSC_U8)regaddr, cnt,
+  platform_i2c_write(port->i2c_bus_, port->i2c_addr_,
+                     (FSC_U8)regaddr, cnt,
                      AddressToRegister(&port->registers_, regaddr));
 }
 
-void WriteTxRegisters(struct Port *port, FSC_U8 numbytes)
+FSC_BOOL WriteTxFrame(struct Port *port, FSC_U8 *frame, FSC_U8 numbytes)
 {
   /* Check length limit */
   if (numbytes > COMM_BUFFER_LENGTH) numbytes = COMM_BUFFER_LENGTH;
 
-  platform_i2c_write(port->i2c_addr_, regTXDATA_00,
-                     numbytes, port->registers_.TxData);
+  /* Byte count, header and data in one transfer from TXBYTECNT */
+  frame[1] = port->registers_.TxByteCnt;
+  frame[2] = port->registers_.TxHeadL;
+  frame[3] = port->registers_.TxHeadH;
+
+  return platform_i2c_write(port->i2c_bus_, port->i2c_addr_, regTXBYTECNT,
+                            3 + numbytes, &frame[1]);
 }
 
 /*
@@ -422,7 +516,8 @@ void WriteTxRegisters(struct Port *port, FSC_U8 numbytes)
 void ClearInterrupt(struct Port *port, enum RegAddress address, FSC_U8 mask)
 {
   FSC_U8 data = mask;
-  platform_i2c_write(port->i2c_addr_, (FSC_U8)address, 1, &data);
+  platform_i2c_write(port->i2c_bus_, port->i2c_addr_,
+                     (FSC_U8)address, 1, &data);
   RegClearBits(&(port->registers_), address, mask);
 }
 
@@ -1010,15 +1105,25 @@ void ResetProtocolLayer(struct Port *port, SopType sop)
     port->protocol_msg_rx_ = FALSE;
     port->protocol_msg_rx_sop_ = SOP_TYPE_SOP;
     port->protocol_msg_tx_sop_ = SOP_TYPE_SOP;
-    port->pd_tx_flag_ = FALSE;
+    QueueFlush(port);
+    RxFifoFlush(port);
     port->policy_has_contract_ = FALSE;
 
-    port->waiting_on_hr_ = FALSE;
+    port->protocol_tx_timer_ = 0;
+    port->protocol_tx_timed_ = FALSE;
+    port->policy_tx_template_id_ = TplNone;
+    DeadlineReset(port);
 
 #ifdef FSC_HAVE_EXTENDED
     port->protocol_ext_num_bytes_ = 0;
+    TimerDisable(&port->protocol_chunk_timer_);
+    ExtPoolRelease(port);
 #endif /* FSC_HAVE_EXTENDED */
 
+#ifdef FSC_HAVE_FWUP
+    FwupAbort(port);
+#endif /* FSC_HAVE_FWUP */
+
 #ifdef FSC_HAVE_USBHID
     /* Set the source caps updated flag to trigger an update of the GUI */
     port->source_caps_updated_ = TRUE;
@@ -1050,6 +1155,7 @@ void PDEnable(struct Port *port, FSC_BOOL is_source)
   port->req_vconn_swap_to_off_as_src_ = Attempt_Vconn_Swap_to_Off_As_Src;
   port->req_pr_swap_as_src_ = Requests_PR_Swap_As_Src;
   port->req_pr_swap_as_snk_ = Requests_PR_Swap_As_Snk;
+  LinkRestart(port);
 #ifdef FSC_HAVE_EXTENDED
   port->protocol_ext_request_chunk_ = FALSE;
   port->protocol_ext_send_chunk_ = FALSE;
@@ -1069,6 +1175,7 @@ void PDEnable(struct Port *port, FSC_BOOL is_source)
       port->policy_is_source_ = is_source;
       port->policy_is_dfp_ = is_source;
       port->policy_subindex_ = 0;
+      port->policy_pt_ = 0;
 
       DPM_Initialize(port);
       /* Reset the protocol layer */
@@ -1183,8 +1290,19 @@ void set_policy_state(struct Port *port, PolicyState_t state)
 
   port->policy_state_ = state;
   port->policy_subindex_ = 0;
+  port->policy_pt_ = 0;
+
+  /* Leaving the state - a pending hard reset shortcut no longer applies */
+  DeadlineCancel(port, DeadlineHardReset);
+
+  /* Drop a message still staged for a deadline */
+  port->protocol_tx_timer_ = 0;
+  if (DeadlineCancel(port, DeadlineTransmit)) {
+    TimerDisable(&port->protocol_timer_);
+    port->protocol_state_ = PRLIdle;
+    port->pd_tx_status_ = txIdle;
+  }
 
-  port->waiting_on_hr_ = FALSE;
   port->policy_wait_on_sink_caps_ = FALSE;
 
   platform_printf(port->port_id_, "PE SS ", state);
@@ -90,12 +90,15 @@ void USBPDProtocol(struct Port *port)
 
 void ProtocolIdle(struct Port *port)
 {
+  /* Free the TCPC for the next message as soon as one is in */
+  RxFifoDrain(port);
+
   if (port->pd_tx_status_ == txReset) {
     /* If we need to send a hard reset */
     port->protocol_state_ = PRLReset;
   }
-  else if (port->registers_.AlertL.I_RXSTAT) {
-    /* If we have received a message */
+  else if (RxFifoPending(port) && !port->protocol_msg_rx_) {
+    /* Hand the policy engine the oldest message waiting */
     ProtocolGetRxPacket(port);
 
     /* If we happened to get here by receiving a msg during a sinktx event,
@@ -110,7 +113,7 @@ void ProtocolIdle(struct Port *port)
     if (port->pd_tx_status_ == txSend) {
         port->pd_tx_status_ = txAbort;
     }
-    else {
+    else if (port->pd_tx_status_ != txAbort) {
         port->pd_tx_status_ = txIdle;
     }
 
@@ -125,6 +128,23 @@ void ProtocolIdle(struct Port *port)
     }
 #endif /* FSC_HAVE_EXTENDED */
   }
+#ifdef FSC_HAVE_EXTENDED
+  else if (port->protocol_ext_state_active_ &&
+           port->protocol_ext_request_chunk_) {
+    /* A Chunk Request that couldn't go out with its chunk */
+    port->pd_tx_status_ = txSend;
+    ProtocolTransmitMessage(port);
+    port->idle_ = TRUE;
+  }
+  else if (TimerExpired(&port->protocol_chunk_timer_)) {
+    /* The next chunk never came - drop the message */
+    TimerDisable(&port->protocol_chunk_timer_);
+    port->protocol_ext_state_active_ = FALSE;
+    port->protocol_ext_num_bytes_ = 0;
+    port->protocol_ext_rx_timeouts_++;
+    ExtPoolRelease(port);
+  }
+#endif /* FSC_HAVE_EXTENDED */
   else if (port->pd_tx_status_ == txSend) {
     /* Otherwise check to see if there has been a request to send data... */
     if (port->protocol_msg_rx_) {
@@ -155,16 +175,32 @@ void ProtocolResetWait(struct Port *port)
 
 void ProtocolGetRxPacket(struct Port *port)
 {
-  FSC_U8 i = 0, j = 0;
+  FSC_U8 i = 0;
+  FSC_U32 start_cycles = platform_cycle_count();
+  FSC_U32 cycles = 0;
 #ifdef FSC_LOGGING
   sopMainHeader_t temp_GCRCHeader = {0};
 #endif /* FSC_LOGGING */
 #ifdef FSC_HAVE_EXTENDED
+  FSC_U8 *rx_data = 0;
   sopExtendedHeader_t temp_ExtHeader = {0};
+  FSC_U8 *ext_data = 0;
+  FSC_U16 count = 0;
+  FSC_U32 elapsed = 0;
 #endif /* FSC_HAVE_EXTENDED */
 
-  /* Read the Rx token, two header bytes, and the byte count */
-  ReadRegisters(port, regRXBYTECNT, 4);
+  /* The byte count, Rx token, two header bytes and the data, as read in
+   * one transfer - policy_rx_data_obj_ points at the data in the frame */
+  if (!RxFifoNext(port)) {
+    return;
+  }
+#ifdef FSC_HAVE_EXTENDED
+  rx_data = (FSC_U8 *)port->policy_rx_data_obj_;
+#endif /* FSC_HAVE_EXTENDED */
+  port->registers_.RxByteCnt = port->protocol_rx_head_[0];
+  port->registers_.RxStat.byte = port->protocol_rx_head_[1];
+  port->registers_.RxHeadL = port->protocol_rx_head_[2];
+  port->registers_.RxHeadH = port->protocol_rx_head_[3];
 
   port->policy_rx_header_.byte[0] = port->registers_.RxHeadL;
   port->policy_rx_header_.byte[1] = port->registers_.RxHeadH;
@@ -205,13 +241,11 @@ void ProtocolGetRxPacket(struct Port *port)
   }
   else {
     /* Drop anything else - possible retried message with same ID */
-    ClearInterrupt(port, regALERTL, MSK_I_RXSTAT);
     return;
   }
 
   /* Did we receive a data message? If so, we want to retrieve the data */
   if (port->policy_rx_header_.NumDataObjects > 0) {
-    ReadRxRegisters(port, port->policy_rx_header_.NumDataObjects * 4);
 #ifdef FSC_HAVE_EXTENDED
     if (port->policy_rx_header_.Extended == 1) {
       /* Extended message */
@@ -222,8 +256,8 @@ void ProtocolGetRxPacket(struct Port *port)
         set_policy_state(port, PE_SRC_Send_Not_Supported);
       }
       else {
-        temp_ExtHeader.byte[0] = port->registers_.RxData[0];
-        temp_ExtHeader.byte[1] = port->registers_.RxData[1];
+        temp_ExtHeader.byte[0] = rx_data[0];
+        temp_ExtHeader.byte[1] = rx_data[1];
 
         if (temp_ExtHeader.RequestChunk == 1) {
           /* Rec'd a request chunk - tell the transmit function to continue */
@@ -231,12 +265,16 @@ void ProtocolGetRxPacket(struct Port *port)
 
           platform_printf(port->port_id_, "Rx'd Req Chnk\n", -1);
         }
+        else if (!ExtPoolLease(port)) {
+          /* No buffer free - dropped, see extpool.h */
+          ExtPoolRxDropped(port);
+        }
         else if (temp_ExtHeader.DataSize <= MAX_EXT_MSG_LEGACY_LEN) {
           /* Single extended packet */
           port->protocol_ext_num_bytes_ = temp_ExtHeader.DataSize;
 
           for (i = 0; i < temp_ExtHeader.DataSize; ++i) {
-            port->protocol_ext_buffer_[i] = port->registers_.RxData[2 + i];
+            port->protocol_ext_buffer_[i] = rx_data[2 + i];
           }
 
           /* Set the flag to pass the message to the policy engine */
@@ -244,9 +282,6 @@ void ProtocolGetRxPacket(struct Port *port)
           platform_printf(port->port_id_, "Rx'd Ext Msg - 1 Chnk\n", -1);
         }
         else if (port->protocol_chunking_supported_) {
-          port->protocol_ext_request_chunk_ = TRUE;
-          port->protocol_ext_state_active_ = TRUE;
-
           platform_printf(port->port_id_, "Rx'd Chnk: \n",
                   temp_ExtHeader.ChunkNumber);
 
@@ -254,33 +289,55 @@ void ProtocolGetRxPacket(struct Port *port)
             /* First Chunk */
             port->protocol_ext_chunk_number_ = 0;
             port->protocol_ext_num_bytes_ = 0;
+            port->protocol_ext_rx_start_ = platform_current_time();
           }
 
-          for (i = 0; i < MAX_EXT_MSG_LEGACY_LEN; ++i) {
-            port->protocol_ext_buffer_[port->protocol_ext_num_bytes_] =
-                port->registers_.RxData[2 + i];
-            port->protocol_ext_num_bytes_ += 1;
-
-            if (port->protocol_ext_num_bytes_ == temp_ExtHeader.DataSize) {
-              /* Done */
-              port->protocol_ext_request_chunk_ = FALSE;
-              port->protocol_ext_state_active_ = FALSE;
-              platform_printf(port->port_id_, "Ext Done - Bytes: \n",
-                  port->protocol_ext_num_bytes_);
-
-              /* Set the flag to pass the message to the policy engine */
-              port->protocol_msg_rx_ = TRUE;
-
-              break;
+          /* The rest of the message, at most a chunk, in one copy */
+          count = 0;
+          if (temp_ExtHeader.DataSize <= MAX_EXT_MSG_LEN &&
+              port->protocol_ext_num_bytes_ < temp_ExtHeader.DataSize) {
+            count = temp_ExtHeader.DataSize - port->protocol_ext_num_bytes_;
+            if (count > MAX_EXT_MSG_LEGACY_LEN) {
+              count = MAX_EXT_MSG_LEGACY_LEN;
             }
           }
 
+          ext_data = &port->protocol_ext_buffer_[port->protocol_ext_num_bytes_];
+          for (i = 0; i < count; ++i) {
+            ext_data[i] = rx_data[2 + i];
+          }
+          port->protocol_ext_num_bytes_ += count;
           port->protocol_ext_chunk_number_ += 1;
 
-          if (port->protocol_ext_request_chunk_) {
+          if (count == 0 ||
+              port->protocol_ext_num_bytes_ == temp_ExtHeader.DataSize) {
+            /* Done */
+            port->protocol_ext_request_chunk_ = FALSE;
+            port->protocol_ext_state_active_ = FALSE;
+            TimerDisable(&port->protocol_chunk_timer_);
+            platform_printf(port->port_id_, "Ext Done - Bytes: \n",
+                port->protocol_ext_num_bytes_);
+
+            elapsed = platform_current_time() - port->protocol_ext_rx_start_;
+            port->protocol_ext_rx_count_++;
+            port->protocol_ext_rx_time_ += elapsed;
+            if (elapsed > port->protocol_ext_rx_max_time_) {
+              port->protocol_ext_rx_max_time_ = elapsed;
+            }
+
+            /* Set the flag to pass the message to the policy engine */
+            port->protocol_msg_rx_ = TRUE;
+          }
+          else {
+            /* ProtocolIdle sends the Chunk Request in this pass, and
+             * tChunkReceiverRequest holds if it can't */
             platform_printf(port->port_id_, "Req Next Chnk\n", -1);
+            port->protocol_ext_request_chunk_ = TRUE;
+            port->protocol_ext_state_active_ = TRUE;
             port->protocol_ext_request_cmd_ =
                     port->policy_rx_header_.MessageType;
+            TimerDisable(&port->protocol_chunk_timer_);
+            TimerStart(&port->protocol_chunk_timer_, ktChunkReceiverRequest);
           }
         }
         else {
@@ -291,15 +348,10 @@ void ProtocolGetRxPacket(struct Port *port)
     else
 #endif /* FSC_HAVE_EXTENDED */
     {
-      /* Standard data message */
-      /* Load the FIFO data into the data objects (loop through each object) */
-      for (i = 0; i < port->policy_rx_header_.NumDataObjects; i++) {
-        /* Loop through each byte in the object */
-        for (j = 0; j < 4; j++) {
-          /* Store the actual bytes */
-          port->policy_rx_data_obj_[i].byte[j] =
-            port->registers_.RxData[(i * 4) + j];
-        }
+      /* Standard data message - already in the data objects.
+       * Zero the unused ones, VDM processing may look past the end. */
+      for (i = port->policy_rx_header_.NumDataObjects; i < 7; i++) {
+        port->policy_rx_data_obj_[i].object = 0;
       }
       /* Set the flag to pass the message to the policy engine */
       port->protocol_msg_rx_ = TRUE;
@@ -311,24 +363,11 @@ void ProtocolGetRxPacket(struct Port *port)
     port->protocol_msg_rx_ = TRUE;
   }
 
-  /* Clear the interrupt here, as it also clears the RX data registers */
-  ClearInterrupt(port, regALERTL, MSK_I_RXSTAT);
-
-  /* Delay to allow for a fast, possibly interrupting next message */
-  /* Fixes compliance issue VDM interrupt VDM command. Ellisys VDMU.E17 */
-  if(port->policy_rx_header_.NumDataObjects != 0 &&
-     port->policy_rx_header_.MessageType == DMTVendorDefined) {
-
-    /* Delay may need to be reduced or removed for slower response
-     * implementations - e.g. kernel driver.
-     */
-    platform_delay(3 * 1000);
-
-    ReadRegister(port, regALERTL);
-
-    if (port->registers_.AlertL.I_RXSTAT) {
-      ProtocolGetRxPacket(port);
-    }
+  cycles = platform_cycle_count() - start_cycles;
+  port->protocol_rx_count_++;
+  port->protocol_rx_cycles_ += cycles;
+  if (cycles > port->protocol_max_rx_cycles_) {
+    port->protocol_max_rx_cycles_ = cycles;
   }
 
 #ifdef FSC_LOGGING
@@ -344,7 +383,7 @@ void ProtocolGetRxPacket(struct Port *port)
 #ifdef FSC_HAVE_EXTENDED
   else {
     WritePDMsg(&port->log_, port->policy_rx_header_,
-               port->registers_.RxData, FALSE, port->protocol_msg_rx_sop_);
+               rx_data, FALSE, port->protocol_msg_rx_sop_);
   }
 #endif /* FSC_HAVE_EXTENDED */
 
@@ -355,12 +394,16 @@ void ProtocolGetRxPacket(struct Port *port)
 
 void ProtocolTransmitMessage(struct Port *port)
 {
-  FSC_U8 i = 0, j = 0;
+  FSC_U8 *frame = port->protocol_tx_head_;
+  FSC_U32 elapsed = 0;
   sopMainHeader_t temp_TxHeader = {0};
 #ifdef FSC_HAVE_EXTENDED
+  FSC_U8 i = 0;
+  FSC_U8 *tx_data = (FSC_U8 *)port->protocol_chunk_obj_;
   sopExtendedHeader_t temp_ExtHeader = {0};
 #endif /* FSC_HAVE_EXTENDED */
   FSC_U8 bytestosend = 0;
+  FSC_BOOL sinktx = FALSE;
 
   temp_TxHeader.word = port->policy_tx_header_.word;
 
@@ -403,20 +446,17 @@ void ProtocolTransmitMessage(struct Port *port)
     temp_ExtHeader.RequestChunk = 1;
     temp_ExtHeader.ChunkNumber = port->protocol_ext_chunk_number_;
 
-    port->registers_.TxData[0] = temp_ExtHeader.byte[0];
-    port->registers_.TxData[1] = temp_ExtHeader.byte[1];
-    port->registers_.TxData[2] = 0;
-    port->registers_.TxData[3] = 0;
+    frame = port->protocol_chunk_head_;
+    tx_data[0] = temp_ExtHeader.byte[0];
+    tx_data[1] = temp_ExtHeader.byte[1];
+    tx_data[2] = 0;
+    tx_data[3] = 0;
     bytestosend = 4;
 
-#ifdef FSC_LOGGING
-    /* For logging purpose */
-    for (i = 0; i < bytestosend; i++)
-    {
-      ((FSC_U8*)port->policy_tx_data_obj_[0].byte)[i] =
-                port->registers_.TxData[i];
-    }
-#endif
+    /* Now the next chunk has tChunkSenderResponse to arrive */
+    TimerDisable(&port->protocol_chunk_timer_);
+    TimerStart(&port->protocol_chunk_timer_, ktChunkSenderResponse +
+               DeadlineRemaining(port, DeadlineTransmit));
   }
   else if (port->protocol_ext_send_chunk_ == TRUE &&
       temp_TxHeader.Extended == TRUE) {
@@ -454,11 +494,12 @@ void ProtocolTransmitMessage(struct Port *port)
     }
 
     /* Load the data */
-    port->registers_.TxData[0] = temp_ExtHeader.byte[0];
-    port->registers_.TxData[1] = temp_ExtHeader.byte[1];
+    frame = port->protocol_chunk_head_;
+    tx_data[0] = temp_ExtHeader.byte[0];
+    tx_data[1] = temp_ExtHeader.byte[1];
 
     for (i = 0; i < bytestosend; ++i) {
-      port->registers_.TxData[2 + i] = port->protocol_ext_buffer_
+      tx_data[2 + i] = port->protocol_ext_buffer_
         [(port->protocol_ext_chunk_number_ * MAX_EXT_MSG_LEGACY_LEN) + i];
     }
 
@@ -468,7 +509,7 @@ void ProtocolTransmitMessage(struct Port *port)
     /* Pad with 0's to 4-byte (data object) boundary. */
     for (; (i < MAX_EXT_MSG_LEGACY_LEN) &&
            (bytestosend % 4 != 0); ++i, ++bytestosend) {
-      port->registers_.TxData[2 + i] = 0;
+      tx_data[2 + i] = 0;
     }
 
     /* Update NumDataObjects accordingly, 4-byte boundary adjusted */
@@ -476,32 +517,12 @@ void ProtocolTransmitMessage(struct Port *port)
 
     /* Increment chunk number for next time through */
     port->protocol_ext_chunk_number_ += 1;
-#ifdef FSC_LOGGING
-    /* For logging purpose */
-    for (i = 0; i < bytestosend; i++)
-    {
-      ((FSC_U8*)port->policy_tx_data_obj_[0].byte)[i] =
-                port->registers_.TxData[i];
-    }
-#endif
   }
   else
 #endif /* FSC_HAVE_EXTENDED */
   {
-    /* Not extended messaging */
+    /* Not extended messaging - the data objects are already in place */
     bytestosend = temp_TxHeader.NumDataObjects * 4;
-
-    if (temp_TxHeader.NumDataObjects > 0) {
-      /* If this is a data object... */
-      for (i = 0; i < temp_TxHeader.NumDataObjects; i++) {
-        /* Load the data objects */
-        for (j = 0; j < 4; ++j) {
-          /* Loop through each byte in the object */
-          port->registers_.TxData[(i * 4) + j] =
-            port->policy_tx_data_obj_[i].byte[j];
-        }
-      }
-    }
   }
 
   /* Update the tx message id to send */
@@ -515,14 +536,39 @@ void ProtocolTransmitMessage(struct Port *port)
   port->registers_.TxHeadL = temp_TxHeader.byte[0];
   port->registers_.TxHeadH = temp_TxHeader.byte[1];
 
-  /* Commit to device */
-  WriteRegisters(port, regTXBYTECNT, 3);
-
-  /* Commit the TxData array to the device */
-  WriteTxRegisters(port, bytestosend);
+  /* Commit to device - count, header and data in one burst */
+  if (!WriteTxFrame(port, frame, bytestosend)) {
+    /* The frame never reached the TCPC - fail the transmit rather than
+     * start one with whatever the TX buffer held */
+    if (port->protocol_tx_timer_ != 0) {
+      TimerDisable(port->protocol_tx_timer_);
+      port->protocol_tx_timer_ = 0;
+    }
+    port->protocol_use_sinktx_ = FALSE;
+    port->protocol_tx_timed_ = FALSE;
+    port->protocol_state_ = PRLIdle;
+    port->pd_tx_status_ = txError;
+    return;
+  }
 
   /* Send the SOP indicator to enable the transmitter */
-  if (port->protocol_use_sinktx_ == FALSE) {
+  sinktx = (port->protocol_tx_timer_ == 0 && port->protocol_use_sinktx_) ?
+           TRUE : FALSE;
+  if (port->protocol_tx_timer_ != 0) {
+    /* Staged - the deadline action enables the transmitter on expiry */
+    port->registers_.Transmit.TX_SOP = port->protocol_msg_tx_sop_;
+    port->registers_.Transmit.RETRY_CNT = port->protocol_retries_;
+    DeadlineArm(port, DeadlineTransmit, port->protocol_tx_timer_,
+                port->registers_.Transmit.byte);
+    TimerDisable(port->protocol_tx_timer_);
+    port->protocol_tx_timer_ = 0;
+
+    if (port->registers_.SinkTransmit.DIS_SNK_TX == 0) {
+      port->registers_.SinkTransmit.DIS_SNK_TX = 1;
+      WriteRegister(port, regSINK_TRANSMIT);
+    }
+  }
+  else if (port->protocol_use_sinktx_ == FALSE) {
     port->registers_.Transmit.TX_SOP = port->protocol_msg_tx_sop_;
     port->registers_.Transmit.RETRY_CNT = port->protocol_retries_;
     WriteRegister(port, regTRANSMIT);
@@ -544,6 +590,22 @@ void ProtocolTransmitMessage(struct Port *port)
     port->protocol_use_sinktx_ = FALSE;
   }
 
+  if (port->protocol_tx_timed_) {
+    /* Time from PolicySend's decision to TRANSMIT written (or armed) */
+    elapsed = platform_current_time() - port->protocol_tx_decided_;
+    port->protocol_tx_timed_ = FALSE;
+    port->protocol_tx_count_++;
+    port->protocol_tx_latency_ += elapsed;
+    if (elapsed > port->protocol_max_tx_latency_) {
+      port->protocol_max_tx_latency_ = elapsed;
+    }
+    if (port->policy_tx_template_id_ != TplNone) {
+      TemplateTimed(port, port->policy_tx_template_id_, elapsed);
+    }
+  }
+
+  LinkTxStarted(port, port->protocol_msg_tx_sop_, 2 + bytestosend, !sinktx);
+
   /* Move on to waiting for a success or fail */
   port->pd_tx_status_ = txBusy;
   port->protocol_state_ = PRLTxSendingMessage;
@@ -551,15 +613,15 @@ void ProtocolTransmitMessage(struct Port *port)
   /* Timeout specifically for chunked messages, but used with each transmit
    * to prevent a theoretical protocol hang.
    */
-  TimerStart(&port->protocol_timer_, ktChunkSenderRequest);
+  TimerStart(&port->protocol_timer_, ktChunkSenderRequest +
+             DeadlineRemaining(port, DeadlineTransmit));
 
 #ifdef FSC_LOGGING
   /* Time-stamped log entry */
   WritePEState(&port->log_, platform_timestamp(), DBG_Tx_Packet);
 
   /* Store all messages that we attempt to send for debugging */
-  WritePDMsg(&port->log_, temp_TxHeader,
-             (FSC_U8 *)port->policy_tx_data_obj_,
+  WritePDMsg(&port->log_, temp_TxHeader, &frame[4],
              TRUE, port->protocol_msg_tx_sop_);
 #endif /* FSC_LOGGING */
 }
@@ -594,6 +656,15 @@ void ProtocolSendingMessage(struct Port *port)
       (port->message_id_counter_[rx_sop] + 1) & 0x07;
     port->protocol_state_ = PRLIdle;
     port->pd_tx_status_ = txSuccess;
+    LinkTxDone(port, LinkSuccess);
+
+#ifdef FSC_HAVE_EXTENDED
+    /* A Chunk Request went - the chunk it asked for may be in already */
+    if (!TimerDisabled(&port->protocol_chunk_timer_) &&
+        port->registers_.AlertL.I_RXSTAT) {
+      ProtocolIdle(port);
+    }
+#endif /* FSC_HAVE_EXTENDED */
   }
   else if (port->registers_.AlertL.I_TXDISC) {
     ClearInterrupt(port, regALERTL, MSK_I_TXDISC);
@@ -602,6 +673,7 @@ void ProtocolSendingMessage(struct Port *port)
          (port->message_id_counter_[rx_sop] + 1) & 0x07;
     /* Indicate to the policy engine that there was a collision */
     port->pd_tx_status_ = txCollision;
+    LinkTxDone(port, LinkDiscarded);
     /* Go to the Idle state to receive whatever message is incoming... */
     port->protocol_state_ = PRLIdle;
   }
@@ -611,32 +683,20 @@ void ProtocolSendingMessage(struct Port *port)
     /* Transmission failed */
     port->protocol_state_ = PRLIdle;
     port->pd_tx_status_ = txError;
+    LinkTxDone(port, LinkFailed);
     port->message_id_counter_[rx_sop] =
       (port->message_id_counter_[rx_sop] + 1) & 0x07;
   }
   else if (port->registers_.AlertL.I_RXSTAT) {
-    /* TODO - possibly determine better mechanism for handling sink transmit
-     * discarded messages.  For now just go back to idle...
-     */
-    ProtocolGetRxPacket(port);
-    if (port->policy_rx_header_.Extended == 0 &&
-        port->policy_rx_header_.NumDataObjects == 0 &&
-        port->policy_rx_header_.MessageType == CMTGoodCRC &&
-        port->policy_tx_header_.Extended == 0 &&
-        port->policy_tx_header_.NumDataObjects == 0 &&
-        port->policy_tx_header_.MessageType == CMTGetSourceCapExt)
-    {
-      /* GoodCRC response for sent GSCE message */
-      port->protocol_msg_rx_ = FALSE;
-      port->message_id_counter_[rx_sop] =
-        (port->message_id_counter_[rx_sop] + 1) & 0x07;
-    }
-    else
-    {
-      set_policy_state(port, PE_SNK_Ready);
-    }
+    /* A message came in and the transmit was discarded for it.  Only the
+     * transmit is settled here - the message goes to the policy engine
+     * the way any other does, in FIFO order and not over one it hasn't
+     * taken yet.  The policy engine sees txAbort and goes back to Ready
+     * to handle it. */
+    LinkTxDone(port, LinkDiscarded);
     port->protocol_state_ = PRLIdle;
-    port->pd_tx_status_ = txSuccess;
+    port->pd_tx_status_ = txAbort;
+    ProtocolIdle(port);
   }
 }
 
@@ -645,13 +705,12 @@ void ProtocolSendHardReset(struct Port *port, FSC_BOOL cable)
   /* Set the send hard reset TRANSMIT register code */
   FSC_U8 data = cable ? TRANSMIT_CABLERESET : TRANSMIT_HARDRESET;
 
-  /* If this flag is set, we've already sent the hard reset command */
-  if (port->waiting_on_hr_) {
-    port->waiting_on_hr_ = FALSE;
-  }
-  else {
+  /* The deadline action may have already sent the hard reset command */
+  DeadlineCancel(port, DeadlineHardReset);
+  if (cable || !DeadlineFired(port, DeadlineHardReset)) {
     /* Send the hard reset */
-    platform_i2c_write(port->i2c_addr_, regTRANSMIT, 1, &data);
+    platform_i2c_write(port->i2c_bus_, port->i2c_addr_,
+                       regTRANSMIT, 1, &data);
   }
 
   port->pd_tx_status_ = txReset;
@@ -0,0 +1,176 @@
+/*******************************************************************************
+ * @file     queue.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * queue.c
+ *
+ * Implements the outbound request queue.
+ */
+
+#include "queue.h"
+#include "port.h"
+
+void QueueFlush(struct Port *port)
+{
+  port->queue_count_ = 0;
+  port->queue_group_ = QUEUE_NO_GROUP;
+}
+
+FSC_U8 QueueGroup(struct Port *port)
+{
+  port->queue_last_group_++;
+  if (port->queue_last_group_ == QUEUE_NO_GROUP) {
+    port->queue_last_group_++;
+  }
+
+  return port->queue_last_group_;
+}
+
+QueuePriority QueuePriorityOf(sopMainHeader_t header)
+{
+  if (header.NumDataObjects == 0) {
+    switch (header.MessageType) {
+      case CMTGotoMin:
+      case CMTSoftReset:
+        return QueuePriorityHigh;
+      default:
+        return QueuePriorityNormal;
+    }
+  }
+
+  switch (header.MessageType) {
+    case DMTSourceCapabilities:
+    case DMTRequest:
+      return QueuePriorityHigh;
+    case DMTVendorDefined:
+      return QueuePriorityLow;
+    default:
+      return QueuePriorityNormal;
+  }
+}
+
+FSC_BOOL QueueRequest(struct Port *port, SopType sop, sopMainHeader_t header,
+                      doDataObject_t *objects, QueuePriority priority,
+                      FSC_U8 group)
+{
+  struct PolicyRequest *req = 0;
+  FSC_U8 i = 0;
+
+  if (port->queue_count_ >= QUEUE_LENGTH) {
+    port->queue_dropped_++;
+    return FALSE;
+  }
+
+  req = &port->queue_[port->queue_count_++];
+  req->header_.word = header.word;
+  for (i = 0; i < header.NumDataObjects && objects != 0; ++i) {
+    req->objects_[i].object = objects[i].object;
+  }
+  req->sop_ = sop;
+  req->priority_ = priority;
+  req->group_ = group;
+  req->time_ = platform_current_time();
+
+  /* Wake up the port if idle */
+  port->idle_ = FALSE;
+
+  return TRUE;
+}
+
+FSC_BOOL QueuePending(struct Port *port)
+{
+  return (port->queue_count_ > 0) ? TRUE : FALSE;
+}
+
+FSC_BOOL QueueHasGroup(struct Port *port, FSC_U8 group)
+{
+  FSC_U8 i = 0;
+
+  if (group == QUEUE_NO_GROUP) {
+    return FALSE;
+  }
+
+  for (i = 0; i < port->queue_count_; ++i) {
+    if (port->queue_[i].group_ == group) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+FSC_BOOL QueueFull(struct Port *port)
+{
+  return (port->queue_count_ >= QUEUE_LENGTH) ? TRUE : FALSE;
+}
+
+FSC_BOOL QueueNext(struct Port *port)
+{
+  struct PolicyRequest *req = 0;
+  FSC_U32 wait = 0;
+  FSC_U8 next = 0;
+  FSC_U8 i = 0;
+
+  if (port->queue_count_ == 0) {
+    port->queue_group_ = QUEUE_NO_GROUP;
+    return FALSE;
+  }
+
+  /* The rest of the sequence in progress, or else the first of the highest
+   * priority - the queue is kept in order */
+  next = port->queue_count_;
+  if (port->queue_group_ != QUEUE_NO_GROUP) {
+    for (i = 0; i < port->queue_count_; ++i) {
+      if (port->queue_[i].group_ == port->queue_group_) {
+        next = i;
+        break;
+      }
+    }
+  }
+
+  if (next == port->queue_count_) {
+    next = 0;
+    for (i = 1; i < port->queue_count_; ++i) {
+      if (port->queue_[i].priority_ < port->queue_[next].priority_) {
+        next = i;
+      }
+    }
+  }
+
+  req = &port->queue_[next];
+  port->pd_transmit_header_.word = req->header_.word;
+  for (i = 0; i < req->header_.NumDataObjects; ++i) {
+    port->pd_transmit_objects_[i].object = req->objects_[i].object;
+  }
+  port->policy_msg_tx_sop_ = req->sop_;
+  port->queue_group_ = req->group_;
+
+  wait = platform_current_time() - req->time_;
+  port->queue_started_++;
+  port->queue_wait_ += wait;
+  if (wait > port->queue_max_wait_) {
+    port->queue_max_wait_ = wait;
+  }
+
+  /* Close the gap */
+  port->queue_count_--;
+  for (i = next; i < port->queue_count_; ++i) {
+    port->queue_[i] = port->queue_[i + 1];
+  }
+
+  return TRUE;
+}
@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * @file     rxfifo.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * rxfifo.c
+ *
+ * Implements the received message FIFO.
+ */
+
+#include "rxfifo.h"
+#include "port.h"
+
+/* Hand the frame in the slot over to the protocol and policy code */
+static void RxFifoPoint(struct Port *port, FSC_U8 slot)
+{
+  FSC_U8 *frame = port->protocol_rx_fifo_[slot].frame_;
+
+  port->protocol_rx_head_ = frame;
+  port->policy_rx_data_obj_ = (doDataObject_t *)(frame + 4);
+}
+
+void RxFifoFlush(struct Port *port)
+{
+  port->protocol_rx_fifo_head_ = 0;
+  port->protocol_rx_fifo_count_ = 0;
+  port->protocol_rx_fifo_taken_ = FALSE;
+  RxFifoPoint(port, 0);
+}
+
+FSC_BOOL RxFifoDrain(struct Port *port)
+{
+  FSC_U8 tail = 0;
+  FSC_U8 waiting = 0;
+
+  if (!port->registers_.AlertL.I_RXSTAT) {
+    return FALSE;
+  }
+
+  if (port->protocol_rx_fifo_count_ >= RXFIFO_LENGTH) {
+    /* Leave it with the TCPC until there is room */
+    port->protocol_rx_fifo_full_++;
+    return FALSE;
+  }
+
+  tail = (port->protocol_rx_fifo_head_ + port->protocol_rx_fifo_count_) %
+         RXFIFO_LENGTH;
+  if (!ReadRxFrame(port, port->protocol_rx_fifo_[tail].frame_)) {
+    return FALSE;
+  }
+
+  /* The TCPC can take the next message now */
+  ClearInterrupt(port, regALERTL, MSK_I_RXSTAT);
+
+  port->protocol_rx_fifo_count_++;
+  waiting = port->protocol_rx_fifo_count_ - port->protocol_rx_fifo_taken_;
+  if (waiting > port->protocol_rx_fifo_high_) {
+    port->protocol_rx_fifo_high_ = waiting;
+  }
+
+  return TRUE;
+}
+
+FSC_BOOL RxFifoPending(struct Port *port)
+{
+  return (port->protocol_rx_fifo_count_ > port->protocol_rx_fifo_taken_) ?
+         TRUE : FALSE;
+}
+
+FSC_BOOL RxFifoNext(struct Port *port)
+{
+  /* The policy engine is done with the frame it was handed last */
+  if (port->protocol_rx_fifo_taken_) {
+    port->protocol_rx_fifo_head_ =
+        (port->protocol_rx_fifo_head_ + 1) % RXFIFO_LENGTH;
+    port->protocol_rx_fifo_count_--;
+    port->protocol_rx_fifo_taken_ = FALSE;
+  }
+
+  if (port->protocol_rx_fifo_count_ == 0) {
+    return FALSE;
+  }
+
+  /* No copy - the head bytes and data objects are read in place */
+  RxFifoPoint(port, port->protocol_rx_fifo_head_);
+  port->protocol_rx_fifo_taken_ = TRUE;
+
+  return TRUE;
+}
@@ -0,0 +1,196 @@
+/*******************************************************************************
+ * @file     sniffer.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * sniffer.c
+ *
+ * Implements the PD sniffer.
+ */
+
+#include "sniffer.h"
+#include "port.h"
+#include "typec.h"
+
+#ifdef FSC_HAVE_SNIFFER
+
+static struct Port *SnifferOwner = 0;
+
+static struct SnifferFrame SnifferRing[SNIFFER_RING_LENGTH];
+static FSC_U8 SnifferHead = 0;
+static FSC_U8 SnifferCount = 0;
+
+static struct SnifferStats Stats;
+
+static void SnifferRxDetect(struct Port *port)
+{
+  /* Clear before write is needed for cable reset */
+  port->registers_.RxDetect.byte = 0;
+  WriteRegister(port, regRXDETECT);
+
+  port->registers_.RxDetect.EN_SOP = 1;
+  port->registers_.RxDetect.EN_SOP1 = 1;
+  port->registers_.RxDetect.EN_SOP2 = 1;
+  port->registers_.RxDetect.EN_SOP1_DBG = 1;
+  port->registers_.RxDetect.EN_SOP2_DBG = 1;
+  port->registers_.RxDetect.EN_HRD_RST = 1;
+  port->registers_.RxDetect.EN_CABLE_RST = 1;
+  WriteRegister(port, regRXDETECT);
+}
+
+/* The next free slot, or 0 if the ring is full */
+static struct SnifferFrame *SnifferSlot(void)
+{
+  if (SnifferCount >= SNIFFER_RING_LENGTH) {
+    Stats.dropped_++;
+    return 0;
+  }
+
+  return &SnifferRing[(SnifferHead + SnifferCount) % SNIFFER_RING_LENGTH];
+}
+
+static void SnifferCommit(struct SnifferFrame *slot)
+{
+  Stats.captured_++;
+  Stats.bytes_ += (slot->frame_[0] > 1) ? slot->frame_[0] - 1 : 0;
+
+  SnifferCount++;
+  if (SnifferCount > Stats.high_) {
+    Stats.high_ = SnifferCount;
+  }
+}
+
+FSC_BOOL SnifferStart(struct Port *port, FSC_U8 cc)
+{
+  if ((SnifferOwner != 0 && SnifferOwner != port &&
+       SnifferOwner->sniffer_) ||
+      (cc != CC1 && cc != CC2)) {
+    return FALSE;
+  }
+
+  /* Open/Open, PD off */
+  SetStateDisabled(port);
+
+  SnifferOwner = port;
+  port->sniffer_ = TRUE;
+  SnifferHead = 0;
+  SnifferCount = 0;
+  Stats.captured_ = 0;
+  Stats.bytes_ = 0;
+  Stats.dropped_ = 0;
+  Stats.high_ = 0;
+  Stats.start_ = platform_current_time();
+
+  /* The PD receiver listens on the CC ORIENT selects */
+  port->registers_.TcpcCtrl.ORIENT = (cc == CC2) ? 1 : 0;
+  WriteRegister(port, regTCPC_CTRL);
+
+  ClearInterrupt(port, regALERTL, MSK_I_RXSTAT | MSK_I_RXHRDRST);
+  port->registers_.AlertMskL.byte = MSK_I_RXSTAT | MSK_I_RXHRDRST;
+  port->registers_.AlertMskH.byte = 0;
+  WriteRegisters(port, regALERTMSKL, 2);
+
+  SnifferRxDetect(port);
+
+  port->idle_ = FALSE;
+  return TRUE;
+}
+
+void SnifferStop(struct Port *port)
+{
+  if (!port->sniffer_) {
+    return;
+  }
+
+  port->sniffer_ = FALSE;
+  port->registers_.RxDetect.byte = 0;
+  WriteRegister(port, regRXDETECT);
+
+  SetStateUnattached(port);
+}
+
+void SnifferService(struct Port *port)
+{
+  struct SnifferFrame *slot = 0;
+
+  if (port->registers_.AlertL.I_RXHRDRST) {
+    ClearInterrupt(port, regALERTL, MSK_I_RXHRDRST);
+
+    slot = SnifferSlot();
+    if (slot != 0) {
+      slot->time_ = port->sniffer_alert_time_;
+      slot->frame_[0] = 1;
+      slot->frame_[1] = SNIFFER_HARD_RESET;
+      SnifferCommit(slot);
+    }
+
+    /* The TCPC clears RXDETECT on a Hard Reset */
+    SnifferRxDetect(port);
+  }
+
+  if (port->registers_.AlertL.I_RXSTAT) {
+    slot = SnifferSlot();
+    if (slot == 0) {
+      /* Counted - free the TCPC for the next one regardless */
+      ClearInterrupt(port, regALERTL, MSK_I_RXSTAT);
+    }
+    else if (ReadRxFrame(port, slot->frame_)) {
+      slot->time_ = port->sniffer_alert_time_;
+      ClearInterrupt(port, regALERTL, MSK_I_RXSTAT);
+      SnifferCommit(slot);
+    }
+  }
+
+  /* Until the next ALERT edge */
+  port->idle_ = TRUE;
+}
+
+FSC_U8 SnifferNextSize(void)
+{
+  FSC_U8 count = 0;
+
+  if (SnifferCount == 0) {
+    return 0;
+  }
+
+  /* Time, then RXBYTECNT and the RXBYTECNT bytes after it */
+  count = SnifferRing[SnifferHead].frame_[0];
+  if (count > RXFIFO_FRAME_SIZE - 1) {
+    count = RXFIFO_FRAME_SIZE - 1;
+  }
+
+  return 4 + 1 + count;
+}
+
+FSC_BOOL SnifferNext(struct SnifferFrame *frame)
+{
+  if (SnifferCount == 0) {
+    return FALSE;
+  }
+
+  *frame = SnifferRing[SnifferHead];
+  SnifferHead = (SnifferHead + 1) % SNIFFER_RING_LENGTH;
+  SnifferCount--;
+
+  return TRUE;
+}
+
+const struct SnifferStats *SnifferGetStats(void)
+{
+  return &Stats;
+}
+
+#endif /* FSC_HAVE_SNIFFER */
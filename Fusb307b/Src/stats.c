@@ -0,0 +1,541 @@
+/*******************************************************************************
+ * @file     stats.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * stats.c
+ *
+ * Implements the run-time statistics report.
+ */
+
+#include "stats.h"
+#include "port.h"
+#include "local_platform.h"
+#include "task.h"
+#include "policy.h"
+#include "pdcodec.h"
+#include "core.h"
+
+#ifdef FSC_HAVE_VDM
+#include "vdm.h"
+#endif /* FSC_HAVE_VDM */
+
+/* Writes val little-endian, returns the byte after it */
+static FSC_U8 *StatsPut(FSC_U8 *buf, FSC_U32 val)
+{
+  buf[0] = val & 0xFF;
+  buf[1] = (val >> 8) & 0xFF;
+  buf[2] = (val >> 16) & 0xFF;
+  buf[3] = (val >> 24) & 0xFF;
+  return buf + 4;
+}
+
+#if defined(FSC_HAVE_FWUP) || defined(FSC_HAVE_BUDGET)
+/* Reads a little-endian word */
+static FSC_U32 StatsGet32(const FSC_U8 *req)
+{
+  return (FSC_U32)req[0] | ((FSC_U32)req[1] << 8) |
+         ((FSC_U32)req[2] << 16) | ((FSC_U32)req[3] << 24);
+}
+#endif /* FSC_HAVE_FWUP || FSC_HAVE_BUDGET */
+
+/* Reads a little-endian half word */
+static FSC_U16 StatsGet16(const FSC_U8 *req)
+{
+  return (FSC_U16)(req[0] | (req[1] << 8));
+}
+
+#ifdef FSC_HAVE_LOWPOWER
+/* Tickless idle residency and wake latency */
+static StatsStatus StatsLowPower(struct Port *port, const FSC_U8 *req,
+                                 FSC_U8 *buf, FSC_U8 len)
+{
+  const LowPowerStats_t *stats = platform_GetLowPowerStats();
+
+  buf = StatsPut(buf, stats->StopCount);
+  buf = StatsPut(buf, stats->WakeOnTimer);
+  buf = StatsPut(buf, stats->WakeOnAlert);
+  buf = StatsPut(buf, stats->StopTimeMs);
+  buf = StatsPut(buf, stats->RunTimeMs);
+  buf = StatsPut(buf, stats->LastWakeLatency);
+  buf = StatsPut(buf, stats->MaxWakeLatency);
+  return StatsOK;
+}
+#endif /* FSC_HAVE_LOWPOWER */
+
+/* Per-port task CPU time */
+static StatsStatus StatsTask(struct Port *port, const FSC_U8 *req,
+                             FSC_U8 *buf, FSC_U8 len)
+{
+  struct PortTask *task = TaskGet(port->port_id_);
+
+  if (task == 0) {
+    return StatsFailed;
+  }
+
+  buf = StatsPut(buf, task->run_count_);
+  buf = StatsPut(buf, task->run_time_);
+  buf = StatsPut(buf, task->max_run_time_);
+  buf = StatsPut(buf, task->run_cycles_);
+  buf = StatsPut(buf, task->max_run_cycles_);
+  buf = StatsPut(buf, task->alert_count_);
+  buf = StatsPut(buf, task->alert_latency_);
+  buf = StatsPut(buf, task->max_alert_latency_);
+  buf = StatsPut(buf, task->alert_reads_);
+  return StatsOK;
+}
+
+/* Scheduler pass cost over all configured ports */
+static StatsStatus StatsPass(struct Port *port, const FSC_U8 *req,
+                             FSC_U8 *buf, FSC_U8 len)
+{
+  const struct TaskPassStats *stats = TaskGetPassStats();
+
+  buf = StatsPut(buf, stats->num_tasks_);
+  buf = StatsPut(buf, stats->pass_count_);
+  buf = StatsPut(buf, stats->pass_time_);
+  buf = StatsPut(buf, stats->max_pass_time_);
+  buf = StatsPut(buf, stats->pass_cycles_);
+  buf = StatsPut(buf, stats->max_pass_cycles_);
+  return StatsOK;
+}
+
+#ifdef FSC_HAVE_LOWPOWER
+/* Clock governor residency and latency, full then low mode */
+static StatsStatus StatsClock(struct Port *port, const FSC_U8 *req,
+                              FSC_U8 *buf, FSC_U8 len)
+{
+  const ClockStats_t *stats = platform_GetClockStats();
+  FSC_U8 mode = 0;
+
+  buf = StatsPut(buf, platform_GetClockMode());
+  for (mode = 0; mode < NUM_CLOCK_MODES; mode++) {
+    buf = StatsPut(buf, stats->SwitchCount[mode]);
+    buf = StatsPut(buf, stats->TimeMs[mode]);
+    buf = StatsPut(buf, stats->LastSwitchLatency[mode]);
+    buf = StatsPut(buf, stats->MaxSwitchLatency[mode]);
+    buf = StatsPut(buf, stats->PassCount[mode]);
+    buf = StatsPut(buf, stats->PassTime[mode]);
+    buf = StatsPut(buf, stats->MaxPassTime[mode]);
+  }
+  return StatsOK;
+}
+#endif /* FSC_HAVE_LOWPOWER */
+
+/* Protocol layer message handling cost */
+static StatsStatus StatsProtocol(struct Port *port, const FSC_U8 *req,
+                                 FSC_U8 *buf, FSC_U8 len)
+{
+  buf = StatsPut(buf, port->protocol_rx_count_);
+  buf = StatsPut(buf, port->protocol_rx_cycles_);
+  buf = StatsPut(buf, port->protocol_max_rx_cycles_);
+  buf = StatsPut(buf, port->protocol_tx_count_);
+  buf = StatsPut(buf, port->protocol_tx_latency_);
+  buf = StatsPut(buf, port->protocol_max_tx_latency_);
+  buf = StatsPut(buf, port->protocol_rx_fifo_high_);
+  buf = StatsPut(buf, port->protocol_rx_fifo_full_);
+#ifdef FSC_HAVE_EXTENDED
+  /* Chunked message reception, chunk 0 to the last chunk */
+  buf = StatsPut(buf, port->protocol_ext_rx_count_);
+  buf = StatsPut(buf, port->protocol_ext_rx_time_);
+  buf = StatsPut(buf, port->protocol_ext_rx_max_time_);
+  buf = StatsPut(buf, port->protocol_ext_rx_timeouts_);
+  /* Shared extended buffer pool, all ports */
+  buf = StatsPut(buf, ExtPoolGetStats()->tx_waits_);
+  buf = StatsPut(buf, ExtPoolGetStats()->rx_drops_);
+  buf = StatsPut(buf, ExtPoolGetStats()->high_);
+#endif /* FSC_HAVE_EXTENDED */
+  return StatsOK;
+}
+
+/* Response template use and latency, template ID in req[0] */
+static StatsStatus StatsTemplate(struct Port *port, const FSC_U8 *req,
+                                 FSC_U8 *buf, FSC_U8 len)
+{
+  struct TxTemplate *tpl = 0;
+
+  if (req[0] >= NUM_TX_TEMPLATES) {
+    return StatsFailed;
+  }
+
+  tpl = &port->policy_tx_template_[req[0]];
+  buf = StatsPut(buf, tpl->builds_);
+  buf = StatsPut(buf, tpl->count_);
+  buf = StatsPut(buf, tpl->latency_);
+  buf = StatsPut(buf, tpl->max_latency_);
+  return StatsOK;
+}
+
+/* Outbound request queue */
+static StatsStatus StatsQueue(struct Port *port, const FSC_U8 *req,
+                              FSC_U8 *buf, FSC_U8 len)
+{
+  buf = StatsPut(buf, port->queue_count_);
+  buf = StatsPut(buf, port->queue_started_);
+  buf = StatsPut(buf, port->queue_dropped_);
+  buf = StatsPut(buf, port->queue_wait_);
+  buf = StatsPut(buf, port->queue_max_wait_);
+  return StatsOK;
+}
+
+#ifdef FSC_HAVE_FWUP
+/* PD firmware update - req[0] 1 starts sending the staged image, length in
+ * req[1-4].  Reports the last update. */
+static StatsStatus StatsFwup(struct Port *port, const FSC_U8 *req,
+                             FSC_U8 *buf, FSC_U8 len)
+{
+  if (req[0] == 1 && !FwupStart(port, StatsGet32(&req[1]))) {
+    return StatsFailed;
+  }
+
+  buf = StatsPut(buf, port->fwup_state_);
+  buf = StatsPut(buf, port->fwup_status_);
+  buf = StatsPut(buf, port->fwup_bytes_);
+  buf = StatsPut(buf, port->fwup_time_);
+  buf = StatsPut(buf, port->fwup_rate_);
+  buf = StatsPut(buf, port->fwup_waits_);
+  buf = StatsPut(buf, port->fwup_crc_errors_);
+  return StatsOK;
+}
+#endif /* FSC_HAVE_FWUP */
+
+/* Transmit statistics for the SOP* in req[0] - successes are the attempts
+ * less discards and failures.  req[1] 1 clears all of them after the
+ * report. */
+static StatsStatus StatsLink(struct Port *port, const FSC_U8 *req,
+                             FSC_U8 *buf, FSC_U8 len)
+{
+  struct LinkStats *link = 0;
+  FSC_U8 i = 0;
+
+  if (req[0] >= NUM_SOP_SUPPORTED) {
+    return StatsFailed;
+  }
+
+  link = &port->link_stats_[req[0]];
+  buf = StatsPut(buf, link->attempts_);
+  buf = StatsPut(buf, link->discards_);
+  buf = StatsPut(buf, link->failures_);
+  buf = StatsPut(buf, link->retries_);
+  buf = StatsPut(buf, link->busy_time_);
+  buf = StatsPut(buf, link->noisy_tx_);
+  for (i = 0; i < LINK_BUCKETS; i++) {
+    buf = StatsPut(buf, link->goodcrc_time_[i]);
+  }
+  *buf++ = link->noise_;
+  *buf++ = link->contention_;
+
+  if (req[1] == 1) {
+    LinkClear(port);
+  }
+  return StatsOK;
+}
+
+#ifdef FSC_HAVE_SNIFFER
+/* PD sniffer - req[0] 1 starts capture on the CC in req[1], 2 stops it,
+ * 3 reports the capture stats.  0 reads frames: a count, then per frame
+ * the time and the frame from RXBYTECNT, as many whole frames as fit. */
+static StatsStatus StatsSniffer(struct Port *port, const FSC_U8 *req,
+                                FSC_U8 *buf, FSC_U8 len)
+{
+  const struct SnifferStats *stats = SnifferGetStats();
+  struct SnifferFrame frame;
+  FSC_U8 *count = buf++;
+  FSC_U8 left = len - 1;
+  FSC_U8 size = 0;
+  FSC_U8 i = 0;
+  FSC_U32 elapsed = 0;
+  FSC_U32 rate = 0;
+
+  switch (req[0]) {
+    case 1:
+      return SnifferStart(port, req[1]) ? StatsOK : StatsFailed;
+    case 2:
+      SnifferStop(port);
+      return StatsOK;
+    case 3:
+      /* Sustained capture rate in frames per second */
+      elapsed = platform_current_time() - stats->start_;
+      if (elapsed > 0) {
+        rate = (FSC_U32)((FSC_U64)stats->captured_ * 1000000 / elapsed);
+      }
+      buf = count;
+      buf = StatsPut(buf, stats->captured_);
+      buf = StatsPut(buf, stats->bytes_);
+      buf = StatsPut(buf, stats->dropped_);
+      buf = StatsPut(buf, stats->high_);
+      buf = StatsPut(buf, elapsed);
+      buf = StatsPut(buf, rate);
+      return StatsOK;
+    default:
+      break;
+  }
+
+  *count = 0;
+  size = SnifferNextSize();
+  while (size > 0 && size <= left && SnifferNext(&frame)) {
+    buf = StatsPut(buf, frame.time_);
+    for (i = 0; i < size - 4; i++) {
+      *buf++ = frame.frame_[i];
+    }
+    left -= size;
+    (*count)++;
+    size = SnifferNextSize();
+  }
+  return StatsOK;
+}
+#endif /* FSC_HAVE_SNIFFER */
+
+/* BIST Test Data measurement - req[0] 1 sets measuring on (req[1] 1) or
+ * off for the next BIST Test Data, 2 clears the counts.  Reports the counts
+ * and the receive rate. */
+static StatsStatus StatsBist(struct Port *port, const FSC_U8 *req,
+                             FSC_U8 *buf, FSC_U8 len)
+{
+  FSC_U32 elapsed = port->bist_last_ - port->bist_first_;
+  FSC_U32 rate = 0;
+
+  if (req[0] == 1) {
+    port->bist_measure_ = (req[1] == 1) ? TRUE : FALSE;
+  }
+  else if (req[0] == 2) {
+    PolicyBISTClearStats(port);
+    elapsed = 0;
+  }
+
+  /* Frames per second, first frame to last */
+  if (port->bist_frames_ > 1 && elapsed > 0) {
+    rate = (FSC_U32)((FSC_U64)(port->bist_frames_ - 1) * 1000000 / elapsed);
+  }
+
+  buf = StatsPut(buf, port->bist_measure_);
+  buf = StatsPut(buf, port->bist_frames_);
+  buf = StatsPut(buf, port->bist_bytes_);
+  buf = StatsPut(buf, port->bist_repeats_);
+  buf = StatsPut(buf, port->bist_overflows_);
+  buf = StatsPut(buf, port->bist_other_);
+  buf = StatsPut(buf, elapsed);
+  buf = StatsPut(buf, rate);
+  buf = StatsPut(buf, rate * (2 + COMM_BUFFER_LENGTH));
+  return StatsOK;
+}
+
+/* PD codec cost - the last message received, req[0] times (once if 0):
+ * PdDecode of the message, then its first object through
+ * getStructuredVdmHeader and through the codec accessors.  Reports the
+ * decode status and the cycles of one of each. */
+static StatsStatus StatsCodec(struct Port *port, const FSC_U8 *req,
+                              FSC_U8 *buf, FSC_U8 len)
+{
+  FSC_U8 runs = req[0] ? req[0] : 1;
+  FSC_U8 msg[2 + MAX_MSG_LEGACY_LEN];
+  FSC_U8 *data = (FSC_U8 *)port->policy_rx_data_obj_;
+  FSC_U8 length = 2 + port->policy_rx_header_.NumDataObjects * 4;
+  FSC_U32 object = port->policy_rx_data_obj_[0].object;
+  struct PdMessage decoded;
+  PdCodecStatus status = PdCodecOK;
+  volatile FSC_U32 sink = 0;
+  FSC_U32 start = 0;
+  FSC_U32 cycles[3] = {0};
+  FSC_U8 i = 0;
+
+  msg[0] = port->policy_rx_header_.byte[0];
+  msg[1] = port->policy_rx_header_.byte[1];
+  for (i = 2; i < length; i++) {
+    msg[i] = data[i - 2];
+  }
+
+  start = platform_cycle_count();
+  for (i = 0; i < runs; i++) {
+    status = PdDecode(msg, length, &decoded);
+  }
+  cycles[0] = (platform_cycle_count() - start) / runs;
+
+#ifdef FSC_HAVE_VDM
+  start = platform_cycle_count();
+  for (i = 0; i < runs; i++) {
+    StructuredVdmHeader header = getStructuredVdmHeader(object);
+    sink = header.svid + header.vdm_type + header.svdm_version +
+           header.obj_pos + header.cmd_type + header.command;
+  }
+  cycles[1] = (platform_cycle_count() - start) / runs;
+#endif /* FSC_HAVE_VDM */
+
+  start = platform_cycle_count();
+  for (i = 0; i < runs; i++) {
+    sink = PdVdmSvid(object) + PdVdmStructured(object) +
+           PdVdmVersion(object) + PdVdmObjPos(object) +
+           PdVdmCmdType(object) + PdVdmCommand(object);
+  }
+  cycles[2] = (platform_cycle_count() - start) / runs;
+  (void)sink;
+
+  buf = StatsPut(buf, status);
+  buf = StatsPut(buf, decoded.objects_);
+  buf = StatsPut(buf, cycles[0]);
+  buf = StatsPut(buf, cycles[1]);
+  buf = StatsPut(buf, cycles[2]);
+  return StatsOK;
+}
+
+/* PPS sink - req[0] 1 sets the output wanted, mV in req[1-2] (0 for none)
+ * and mA in req[3-4].  Reports the setting, the contract and the
+ * keep-alive timing, whether or not the setting was taken. */
+static StatsStatus StatsPps(struct Port *port, const FSC_U8 *req,
+                            FSC_U8 *buf, FSC_U8 len)
+{
+  StatsStatus status = StatsOK;
+
+  if (req[0] == 1 &&
+      !core_set_sink_pps(port, StatsGet16(&req[1]), StatsGet16(&req[3]))) {
+    status = StatsFailed;
+  }
+
+  buf = StatsPut(buf, port->sink_pps_mv_);
+  buf = StatsPut(buf, port->sink_pps_ma_);
+  buf = StatsPut(buf, port->source_is_apdo_);
+  buf = StatsPut(buf, port->source_is_apdo_ ?
+                 port->usb_pd_contract_.PPSRDO.OpVoltage * 20 : 0);
+  buf = StatsPut(buf, port->source_is_apdo_ ?
+                 port->usb_pd_contract_.PPSRDO.OpCurrent * 50 : 0);
+  buf = StatsPut(buf, port->sink_pps_requests_);
+  buf = StatsPut(buf, port->sink_pps_max_interval_);
+  return status;
+}
+
+/* PDO selection - req[0] 1 sets the goals: preferred mV in req[1-2],
+ * thermal limit mW in req[3-4] and the power, voltage and efficiency
+ * weights in req[5-7], keeping the efficiency curve.  2 clears the counts.
+ * Reports the cache hits and misses, their cost in cycles and the last
+ * object chosen. */
+static StatsStatus StatsPdoSel(struct Port *port, const FSC_U8 *req,
+                               FSC_U8 *buf, FSC_U8 len)
+{
+  struct PdoSelStats *stats = &port->pdosel_stats_;
+  struct PdoGoals goals = port->pdosel_goals_;
+
+  if (req[0] == 1) {
+    goals.preferred_mv_ = StatsGet16(&req[1]);
+    goals.thermal_mw_ = StatsGet16(&req[3]);
+    goals.power_weight_ = req[5];
+    goals.voltage_weight_ = req[6];
+    goals.efficiency_weight_ = req[7];
+    PdoSelSetGoals(port, &goals);
+  }
+  else if (req[0] == 2) {
+    stats->hits_ = 0;
+    stats->misses_ = 0;
+    stats->eval_cycles_ = 0;
+    stats->max_eval_cycles_ = 0;
+    stats->hit_cycles_ = 0;
+  }
+
+  buf = StatsPut(buf, stats->hits_);
+  buf = StatsPut(buf, stats->misses_);
+  buf = StatsPut(buf, stats->misses_ ?
+                 stats->eval_cycles_ / stats->misses_ : 0);
+  buf = StatsPut(buf, stats->max_eval_cycles_);
+  buf = StatsPut(buf, stats->hits_ ? stats->hit_cycles_ / stats->hits_ : 0);
+  buf = StatsPut(buf, port->sink_request_.FVRDO.ObjectPosition);
+  buf = StatsPut(buf, port->sink_partner_max_power_);
+  return StatsOK;
+}
+
+#ifdef FSC_HAVE_BUDGET
+/* Source power budget - req[0] 1 sets the supply, mW in req[1-4].  2
+ * clears the counts.  Reports the supply, the rounds and how long they
+ * took to converge (us), and this port's target, offer and contracted
+ * power (mW). */
+static StatsStatus StatsBudget(struct Port *port, const FSC_U8 *req,
+                               FSC_U8 *buf, FSC_U8 len)
+{
+  const struct BudgetStats *stats = BudgetGetStats();
+
+  if (req[0] == 1) {
+    BudgetSetSupply(StatsGet32(&req[1]));
+  }
+  else if (req[0] == 2) {
+    BudgetClearStats();
+  }
+
+  buf = StatsPut(buf, BudgetGetSupply());
+  buf = StatsPut(buf, stats->rounds_);
+  buf = StatsPut(buf, stats->converged_);
+  buf = StatsPut(buf, stats->timeouts_);
+  buf = StatsPut(buf, stats->goto_mins_);
+  buf = StatsPut(buf, stats->readvertised_);
+  buf = StatsPut(buf, stats->converged_ ?
+                 stats->latency_ / stats->converged_ : 0);
+  buf = StatsPut(buf, stats->max_latency_);
+  buf = StatsPut(buf, port->budget_target_mw_);
+  buf = StatsPut(buf, port->budget_offer_mw_);
+  buf = StatsPut(buf, BudgetUsed(port));
+  return StatsOK;
+}
+#endif /* FSC_HAVE_BUDGET */
+
+StatsStatus StatsReport(struct Port *port, FSC_U8 id, const FSC_U8 *req,
+                        FSC_U8 *buf, FSC_U8 len)
+{
+  if (len < STATS_MAX_REPORT) {
+    return StatsFailed;
+  }
+
+  switch (id) {
+#ifdef FSC_HAVE_LOWPOWER
+    case STATS_LOWPOWER:
+      return StatsLowPower(port, req, buf, len);
+#endif /* FSC_HAVE_LOWPOWER */
+    case STATS_TASK:
+      return StatsTask(port, req, buf, len);
+    case STATS_PASS:
+      return StatsPass(port, req, buf, len);
+#ifdef FSC_HAVE_LOWPOWER
+    case STATS_CLOCK:
+      return StatsClock(port, req, buf, len);
+#endif /* FSC_HAVE_LOWPOWER */
+    case STATS_PROTOCOL:
+      return StatsProtocol(port, req, buf, len);
+    case STATS_TEMPLATE:
+      return StatsTemplate(port, req, buf, len);
+    case STATS_QUEUE:
+      return StatsQueue(port, req, buf, len);
+#ifdef FSC_HAVE_FWUP
+    case STATS_FWUP:
+      return StatsFwup(port, req, buf, len);
+#endif /* FSC_HAVE_FWUP */
+    case STATS_LINK:
+      return StatsLink(port, req, buf, len);
+#ifdef FSC_HAVE_SNIFFER
+    case STATS_SNIFFER:
+      return StatsSniffer(port, req, buf, len);
+#endif /* FSC_HAVE_SNIFFER */
+    case STATS_BIST:
+      return StatsBist(port, req, buf, len);
+    case STATS_CODEC:
+      return StatsCodec(port, req, buf, len);
+    case STATS_PPS:
+      return StatsPps(port, req, buf, len);
+    case STATS_PDOSEL:
+      return StatsPdoSel(port, req, buf, len);
+#ifdef FSC_HAVE_BUDGET
+    case STATS_BUDGET:
+      return StatsBudget(port, req, buf, len);
+#endif /* FSC_HAVE_BUDGET */
+    default:
+      return StatsNoClass;
+  }
+}
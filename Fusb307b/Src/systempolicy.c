@@ -26,6 +26,7 @@
 
 #include "port.h"
 #include "platform.h"
+#include "stats.h"
 
 #ifdef FSC_HAVE_USBHID
 #include "usbd_hid.h"
@@ -36,10 +37,59 @@
 #ifdef FSC_HAVE_UART
 FSC_U8 UARTRecBuffer[64];
 FSC_U8 UARTRecIndex = 0;
-FSC_BOOL UARTRecHaveMsg = FALSE;
+volatile FSC_BOOL UARTRecHaveMsg = FALSE;
+
+/* Request bytes a stats command may carry */
+#define UART_STATS_REQ  (8)
+
+/* Parses the space separated hex bytes starting at str into bytes, up to
+ * max of them.  Returns the number parsed. */
+static FSC_U8 UARTHexBytes(const FSC_U8 *str, FSC_U8 *bytes, FSC_U8 max)
+{
+  FSC_U8 count = 0;
+  FSC_U8 digits = 0;
+  FSC_U8 c;
+
+  for (; *str != 0; ++str) {
+    c = *str;
+    if (c >= '0' && c <= '9') c -= '0';
+    else if (c >= 'a' && c <= 'f') c -= 'a' - 10;
+    else if (c >= 'A' && c <= 'F') c -= 'A' - 10;
+    else {
+      /* Separator ends the byte */
+      if (digits) { ++count; digits = 0; }
+      continue;
+    }
+
+    if (count >= max) break;
+    if (digits == 0) bytes[count] = 0;
+    bytes[count] = (bytes[count] << 4) | c;
+    if (++digits == 2) { ++count; digits = 0; }
+  }
+
+  return (digits && count < max) ? count + 1 : count;
+}
+
+/* "<port> st <class> [request bytes]" - writes the class's StatsReport
+ * out as a line of hex bytes: class, status, then the report. */
+static void UARTStats(struct Port *port, const FSC_U8 *args)
+{
+  FSC_U8 req[1 + UART_STATS_REQ] = {0};
+  FSC_U8 out[2 + STATS_MAX_REPORT];
+
+  if (UARTHexBytes(args, req, sizeof(req)) == 0) {
+    platform_printf(port->port_id_, "Stats: no class\n", -1);
+    return;
+  }
+
+  out[0] = req[0];
+  out[1] = StatsReport(port, req[0], &req[1], &out[2], STATS_MAX_REPORT);
+  platform_printbytes(port->port_id_, "Stats",
+                      out, out[1] == StatsOK ? sizeof(out) : 2);
+}
 #endif /* FSC_HAVE_UART */
 
-void SystemPolicyProcess(struct Port *ports) {
+void SystemPolicyProcess(struct Port *ports, FSC_U8 num_ports) {
 #ifdef FSC_HAVE_UART
   FSC_U8 i;
 #endif /* FSC_HAVE_UART */
@@ -48,7 +98,7 @@ void SystemPolicyProcess(struct Port *ports) {
 #ifdef FSC_HAVE_USBHID
   if (haveUSBInMsg) {
         /* HostComm */
-        ProcessMsg(USBInputMsg, USBOutputMsg, &ports[0]);
+        ProcessMsg(USBInputMsg, USBOutputMsg, ports, num_ports);
         haveUSBInMsg = FALSE;
         USBD_HID_SendReport(&USBD_Device, USBOutputMsg, USB_MSG_LENGTH);
     }
@@ -64,15 +114,19 @@ void SystemPolicyProcess(struct Port *ports) {
  */
     /* Buffer[0] should be a channel number */
     UARTRecBuffer[0] -= 0x31; /* Hex offset for digit '1' */
-    if (UARTRecBuffer[0] < 1 || UARTRecBuffer[0] > FSC_NUMBER_OF_PORTS)
+    if (UARTRecBuffer[0] >= num_ports)
       UARTRecBuffer[0] = 0;
 
     if (UARTRecBuffer[2] == 's' &&
         UARTRecBuffer[3] == 'e' &&
         UARTRecBuffer[4] == 'c') {
-      ports[0].idle_ = FALSE;
+      ports[UARTRecBuffer[0]].idle_ = FALSE;
       set_policy_state(&ports[UARTRecBuffer[0]], PE_Send_Security_Request);
     }
+    else if (UARTRecBuffer[2] == 's' &&
+             UARTRecBuffer[3] == 't') {
+      UARTStats(&ports[UARTRecBuffer[0]], &UARTRecBuffer[4]);
+    }
 
     for (i = 0; i < 64; ++i) UARTRecBuffer[i] = 0;
     UARTRecHaveMsg = FALSE;
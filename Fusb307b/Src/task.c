@@ -0,0 +1,386 @@
+/*******************************************************************************
+ * @file     task.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * task.c
+ *
+ * Implements the cooperative per-port task.
+ */
+
+#include "task.h"
+#include "core.h"
+#include "platform.h"
+
+/* Tasks by port ID (1 based) */
+static struct PortTask *Tasks[FSC_NUMBER_OF_PORTS];
+
+/* Shared ALERT lines, each by the Tasks index of its first running port */
+static FSC_U8 LineFirst[FSC_NUMBER_OF_PORTS];
+static FSC_U8 NumLines;
+
+static struct TaskPassStats PassStats;
+static FSC_U32 PassStart;
+static FSC_U32 PassStartCycles;
+
+/* TRUE if the task takes part in the scans of the ALERT line */
+static FSC_BOOL TaskOnLine(struct PortTask *task, FSC_U8 line)
+{
+  return (task != 0 && task->state_ == TaskRunning &&
+          task->alert_line_ == line) ? TRUE : FALSE;
+}
+
+/* Rebuild LineFirst - whenever a task starts or stops running */
+static void TaskUpdateLines(void)
+{
+  FSC_U8 i = 0;
+  FSC_U8 j = 0;
+
+  NumLines = 0;
+
+  for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+    if (Tasks[i] == 0 || !Tasks[i]->alert_shared_ ||
+        Tasks[i]->state_ != TaskRunning) {
+      continue;
+    }
+
+    for (j = 0; j < NumLines; ++j) {
+      if (Tasks[LineFirst[j]]->alert_line_ == Tasks[i]->alert_line_) {
+        break;
+      }
+    }
+
+    if (j == NumLines) {
+      LineFirst[NumLines++] = i;
+    }
+  }
+}
+
+void TaskInitialize(struct PortTask *task, struct Port *port)
+{
+  FSC_U8 i = 0;
+
+  task->port_ = port;
+  task->state_ = TaskWaitInit;
+  task->ready_ = FALSE;
+  task->run_count_ = 0;
+  task->run_time_ = 0;
+  task->max_run_time_ = 0;
+  task->run_cycles_ = 0;
+  task->max_run_cycles_ = 0;
+  task->alert_line_ = platform_get_alert_line(port->port_id_);
+  task->alert_shared_ = FALSE;
+  task->alert_pending_ = FALSE;
+  task->alert_quiet_ = FALSE;
+  task->alert_timed_ = FALSE;
+  task->alert_time_ = 0;
+  task->alert_count_ = 0;
+  task->alert_latency_ = 0;
+  task->max_alert_latency_ = 0;
+  task->alert_reads_ = 0;
+  TimerDisable(&task->start_timer_);
+
+  if (port->port_id_ > 0 && port->port_id_ <= FSC_NUMBER_OF_PORTS) {
+    if (Tasks[port->port_id_ - 1] == 0) {
+      PassStats.num_tasks_++;
+    }
+    Tasks[port->port_id_ - 1] = task;
+  }
+
+  /* Note the ports sharing this one's ALERT line */
+  for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+    if (Tasks[i] != 0 && Tasks[i] != task && task->alert_line_ != 0 &&
+        Tasks[i]->alert_line_ == task->alert_line_) {
+      Tasks[i]->alert_shared_ = TRUE;
+      task->alert_shared_ = TRUE;
+    }
+  }
+
+  TaskUpdateLines();
+}
+
+void TaskWake(struct PortTask *task)
+{
+  task->ready_ = TRUE;
+}
+
+void TaskAlert(FSC_U8 line)
+{
+  struct PortTask *task = 0;
+  FSC_U32 now = platform_current_time();
+  FSC_U8 i = 0;
+
+  for (i = 0; i < FSC_NUMBER_OF_PORTS; ++i) {
+    task = Tasks[i];
+    if (task == 0 || task->alert_line_ != line) {
+      continue;
+    }
+
+    /* Latency counts from the first edge not yet serviced */
+    if (!task->alert_timed_) {
+      task->alert_time_ = now;
+      task->alert_timed_ = TRUE;
+    }
+
+    if (task->alert_shared_) {
+      task->alert_pending_ = TRUE;
+    }
+    else {
+      task->ready_ = TRUE;
+    }
+  }
+}
+
+/* TRUE if the port has a real (unmasked) alert - one 2 byte transfer */
+static FSC_BOOL TaskReadAlert(struct PortTask *task)
+{
+  struct Port *port = task->port_;
+
+  task->alert_reads_++;
+  if (!ReadRegisters(port, regALERTL, 2)) {
+    /* Let the port's pass sort it out */
+    return TRUE;
+  }
+
+  return ((port->registers_.AlertL.byte & port->registers_.AlertMskL.byte) ||
+          (port->registers_.AlertH.byte & port->registers_.AlertMskH.byte)) ?
+         TRUE : FALSE;
+}
+
+static void TaskScanLine(FSC_U8 first)
+{
+  struct PortTask *task = 0;
+  FSC_U8 line = Tasks[first]->alert_line_;
+  FSC_BOOL pending = FALSE;
+  FSC_BOOL busy = FALSE;
+  FSC_BOOL found = FALSE;
+  FSC_U8 quiet = 0;
+  FSC_U8 i = 0;
+
+  for (i = first; i < FSC_NUMBER_OF_PORTS; ++i) {
+    task = Tasks[i];
+    if (TaskOnLine(task, line)) {
+      pending |= task->alert_pending_;
+      busy |= TaskReady(task);
+    }
+  }
+
+  if (!pending) {
+    if (busy) {
+      return;
+    }
+
+    if (!platform_get_device_irq_state(Tasks[first]->port_->port_id_)) {
+      /* Released - ports left unread by the last scan had nothing */
+      for (i = first; i < FSC_NUMBER_OF_PORTS; ++i) {
+        if (TaskOnLine(Tasks[i], line)) {
+          Tasks[i]->alert_timed_ = FALSE;
+        }
+      }
+      return;
+    }
+
+    /* Still asserted with nobody on the line working on it */
+    TaskAlert(line);
+  }
+
+  /* Ports not known to be quiet first, then the quiet ones */
+  for (quiet = FALSE; quiet <= TRUE && !found; ++quiet) {
+    for (i = first; i < FSC_NUMBER_OF_PORTS && !found; ++i) {
+      task = Tasks[i];
+      if (!TaskOnLine(task, line) ||
+          !task->alert_pending_ || task->alert_quiet_ != quiet) {
+        continue;
+      }
+
+      task->alert_pending_ = FALSE;
+
+      /* A port with work in hand reads its own ALERT on its next pass */
+      if (TaskReady(task)) {
+        continue;
+      }
+
+      if (TaskReadAlert(task)) {
+        task->alert_quiet_ = FALSE;
+        task->ready_ = TRUE;
+        found = TRUE;
+      }
+      else {
+        task->alert_quiet_ = TRUE;
+        task->alert_timed_ = FALSE;
+      }
+    }
+  }
+
+  /* Leave the rest unread - if the line stays asserted after this port's
+   * pass, the next scan gets to them */
+  for (i = first; i < FSC_NUMBER_OF_PORTS; ++i) {
+    task = Tasks[i];
+    if (TaskOnLine(task, line)) {
+      task->alert_pending_ = FALSE;
+    }
+  }
+}
+
+void TaskScanAlerts(void)
+{
+  FSC_U8 i = 0;
+
+  /* Once per line, from its first (highest priority) running port */
+  for (i = 0; i < NumLines; ++i) {
+    TaskScanLine(LineFirst[i]);
+  }
+}
+
+FSC_BOOL TaskReady(struct PortTask *task)
+{
+  if (task->state_ != TaskRunning) {
+    return TRUE;
+  }
+
+  return (task->ready_ || !task->port_->idle_) ? TRUE : FALSE;
+}
+
+static void TaskStartupPass(struct PortTask *task)
+{
+  struct Port *port = task->port_;
+
+  switch (task->state_) {
+    case TaskWaitInit:
+      /* Wait on the TCPC to finish its own initialization */
+      if (ReadRegister(port, regPWRSTAT) != FALSE &&
+          port->registers_.PwrStat.TCPC_INIT == 0) {
+        TimerStart(&task->start_timer_, ktTaskStartup);
+        task->state_ = TaskStartup;
+      }
+      break;
+    case TaskStartup:
+      if (TimerExpired(&task->start_timer_)) {
+        TimerDisable(&task->start_timer_);
+        InitializePort(port);
+        platform_printf(port->port_id_, "Port Initialized.\n", -1);
+        task->state_ = TaskRunning;
+        task->ready_ = TRUE;
+        task->alert_timed_ = FALSE;
+        TaskUpdateLines();
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+FSC_BOOL TaskRun(struct PortTask *task)
+{
+  struct Port *port = task->port_;
+  FSC_U32 start = 0;
+  FSC_U32 elapsed = 0;
+  FSC_U32 start_cycles = 0;
+  FSC_U32 cycles = 0;
+
+  if (task->state_ != TaskRunning) {
+    TaskStartupPass(task);
+    return FALSE;
+  }
+
+  /* Reset for next wake-up */
+  task->ready_ = FALSE;
+
+  start = platform_current_time();
+
+#ifdef FSC_HAVE_SNIFFER
+  /* Sniffer frames are stamped with the edge that reported them */
+  port->sniffer_alert_time_ = task->alert_timed_ ? task->alert_time_ : start;
+#endif /* FSC_HAVE_SNIFFER */
+
+  if (task->alert_timed_) {
+    elapsed = start - task->alert_time_;
+    task->alert_timed_ = FALSE;
+    task->alert_count_++;
+    task->alert_latency_ += elapsed;
+    if (elapsed > task->max_alert_latency_) {
+      task->max_alert_latency_ = elapsed;
+    }
+  }
+
+  start_cycles = platform_cycle_count();
+  core_state_machine(port);
+  cycles = platform_cycle_count() - start_cycles;
+  elapsed = platform_current_time() - start;
+
+  task->run_count_++;
+  task->run_time_ += elapsed;
+  if (elapsed > task->max_run_time_) {
+    task->max_run_time_ = elapsed;
+  }
+  task->run_cycles_ += cycles;
+  if (cycles > task->max_run_cycles_) {
+    task->max_run_cycles_ = cycles;
+  }
+
+  /* Wait on the next alert/interrupt.
+   * A still-asserted ALERT earns one more pass - unless the line is shared,
+   * when it may be another port's (TaskScanAlerts). */
+  if (port->idle_) {
+    if (!task->alert_shared_ &&
+        platform_get_device_irq_state(port->port_id_)) {
+      port->idle_ = FALSE;
+    }
+    else {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+struct PortTask *TaskGet(FSC_U8 port_id)
+{
+  if (port_id == 0 || port_id > FSC_NUMBER_OF_PORTS) {
+    return 0;
+  }
+
+  return Tasks[port_id - 1];
+}
+
+void TaskPassStart(void)
+{
+  PassStart = platform_current_time();
+  PassStartCycles = platform_cycle_count();
+}
+
+FSC_U32 TaskPassEnd(void)
+{
+  FSC_U32 cycles = platform_cycle_count() - PassStartCycles;
+  FSC_U32 elapsed = platform_current_time() - PassStart;
+
+  PassStats.pass_count_++;
+  PassStats.pass_time_ += elapsed;
+  if (elapsed > PassStats.max_pass_time_) {
+    PassStats.max_pass_time_ = elapsed;
+  }
+  PassStats.pass_cycles_ += cycles;
+  if (cycles > PassStats.max_pass_cycles_) {
+    PassStats.max_pass_cycles_ = cycles;
+  }
+
+  return elapsed;
+}
+
+const struct TaskPassStats *TaskGetPassStats(void)
+{
+  return &PassStats;
+}
@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * @file     template.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * template.c
+ *
+ * Implements the response templates.
+ */
+
+#include "template.h"
+#include "port.h"
+#include "dpm.h"
+
+/* Generation bits of the key - the low 4 are the roles and spec revision */
+#define TEMPLATE_GEN_MASK       (0x0FFF)
+
+static FSC_U16 TemplateKey(struct Port *port)
+{
+  return (FSC_U16)((port->policy_tx_template_gen_ << 4) |
+                   (DPM_CurrentSpecRev(port, SOP_TYPE_SOP) << 2) |
+                   (port->policy_is_dfp_ ? 0x2 : 0) |
+                   (port->policy_is_source_ ? 0x1 : 0));
+}
+
+void TemplateInvalidate(struct Port *port)
+{
+  /* Never 0, so a key is never 0 either */
+  port->policy_tx_template_gen_ =
+      (port->policy_tx_template_gen_ + 1) & TEMPLATE_GEN_MASK;
+  if (port->policy_tx_template_gen_ == 0) {
+    port->policy_tx_template_gen_ = 1;
+  }
+}
+
+TxTemplateId TemplateFind(struct Port *port, FSC_U8 message_type,
+                          FSC_U16 num_bytes, FSC_U8 *data, SopType sop,
+                          FSC_BOOL extended)
+{
+  if (sop != SOP_TYPE_SOP || extended) {
+    return TplNone;
+  }
+
+  if (num_bytes == 0) {
+    switch (message_type & PDMsgTypeMask) {
+      case CMTAccept:
+        return TplAccept;
+      case CMTReject:
+        return TplReject;
+      case CMTWait:
+        return TplWait;
+      case CMTNotSupported:
+        return TplNotSupported;
+      case CMTPS_RDY:
+        return TplPS_RDY;
+      default:
+        return TplNone;
+    }
+  }
+
+  switch (message_type & PDMsgTypeMask) {
+    case DMTSourceCapabilities:
+      return (data == (FSC_U8 *)port->caps_source_) ? TplSourceCaps : TplNone;
+    case DMTSinkCapabilities:
+      return (data == (FSC_U8 *)port->caps_sink_) ? TplSinkCaps : TplNone;
+#ifdef FSC_HAVE_VDM
+    case DMTVendorDefined:
+      /* Only PolicyGiveVdm's, composed in place */
+      return (data == (FSC_U8 *)port->policy_tx_data_obj_) ?
+             port->vdm_tx_template_ : TplNone;
+#endif /* FSC_HAVE_VDM */
+    default:
+      return TplNone;
+  }
+}
+
+FSC_BOOL TemplateValid(struct Port *port, TxTemplateId id)
+{
+  return (id < NUM_TX_TEMPLATES &&
+          port->policy_tx_template_[id].key_ == TemplateKey(port)) ?
+         TRUE : FALSE;
+}
+
+FSC_U8 TemplateObjects(struct Port *port, TxTemplateId id)
+{
+  return port->policy_tx_template_[id].header_.NumDataObjects;
+}
+
+FSC_BOOL TemplateLoad(struct Port *port, TxTemplateId id)
+{
+  struct TxTemplate *tpl = &port->policy_tx_template_[id];
+  FSC_U8 i = 0;
+
+  if (!TemplateValid(port, id)) {
+    return FALSE;
+  }
+
+  port->policy_tx_header_.word = tpl->header_.word;
+  for (i = 0; i < tpl->header_.NumDataObjects; ++i) {
+    port->policy_tx_data_obj_[i].object = tpl->objects_[i].object;
+  }
+
+  return TRUE;
+}
+
+void TemplateStore(struct Port *port, TxTemplateId id)
+{
+  struct TxTemplate *tpl = &port->policy_tx_template_[id];
+  FSC_U8 i = 0;
+
+  tpl->header_.word = port->policy_tx_header_.word;
+  tpl->header_.MessageID = 0;
+  for (i = 0; i < tpl->header_.NumDataObjects; ++i) {
+    tpl->objects_[i].object = port->policy_tx_data_obj_[i].object;
+  }
+  tpl->key_ = TemplateKey(port);
+  tpl->builds_++;
+}
+
+void TemplateTimed(struct Port *port, TxTemplateId id, FSC_U32 elapsed)
+{
+  struct TxTemplate *tpl = &port->policy_tx_template_[id];
+
+  tpl->count_++;
+  tpl->latency_ += elapsed;
+  if (elapsed > tpl->max_latency_) {
+    tpl->max_latency_ = elapsed;
+  }
+}
@@ -31,8 +31,10 @@
 #include "timer.h"    /*  Timer values */
 #include "vdm_types.h"
 #include "vdm.h"
+#include "pdcodec.h"
 #include "dpm.h"
 #include "observer.h"
+#include "queue.h"
 
 #define VDM_ARRAY_LEN 1
 
@@ -112,8 +114,8 @@ void PolicyGiveVdm(struct Port *port)
     }
 
     result = PolicySend(port, DMTVendorDefined, port->vdm_msg_length_ * 4,
-                        (FSC_U8 *)port->vdm_msg_obj_, port->vdm_next_ps_, 0,
-                        port->vdm_msg_tx_sop_, FALSE);
+                        (FSC_U8 *)port->policy_tx_data_obj_,
+                        port->vdm_next_ps_, 0, port->vdm_msg_tx_sop_, FALSE);
     if (result == STAT_SUCCESS) {
       if (port->vdm_expecting_response_ == TRUE) {
         StartVdmTimer(port);
@@ -122,10 +124,12 @@ void PolicyGiveVdm(struct Port *port)
         ResetPolicyState(port, port->vdm_msg_tx_sop_);
       }
       port->vdm_sending_data_ = FALSE;
+      port->vdm_tx_template_ = TplNone;
     }
     else if (result == STAT_ERROR) {
       ResetPolicyState(port, port->vdm_msg_tx_sop_);
       port->vdm_sending_data_ = FALSE;
+      port->vdm_tx_template_ = TplNone;
     }
   }
   else {
@@ -135,14 +139,10 @@ void PolicyGiveVdm(struct Port *port)
 
 void ConvertAndProcessVdmMessage(struct Port *port)
 {
-  FSC_U32 i;
-  /*  form the word arrays that VDM block expects */
-  FSC_U32 vdm_arr[7] = {0};
-
-  for (i = 0; i < port->policy_rx_header_.NumDataObjects; i++) {
-    vdm_arr[i] = port->policy_rx_data_obj_[i].object;
-  }
-  ProcessVdmMessage(port, vdm_arr, port->policy_rx_header_.NumDataObjects);
+  /*  The received objects are already the word array the VDM block
+   *  expects, zero past the end (ProtocolGetRxPacket) */
+  ProcessVdmMessage(port, &port->policy_rx_data_obj_[0].object,
+                    port->policy_rx_header_.NumDataObjects);
 }
 
 void DoVdmCommand(struct Port *port)
@@ -172,7 +172,7 @@ void DoVdmCommand(struct Port *port)
 
   mode_index = port->pd_transmit_objects_[0].byte[1] & 0x7;
 
-  /*  Must be set with correct type when setting port->pd_tx_flag_ */
+  /*  Must be set with correct type when queueing the request */
   sop = port->policy_msg_tx_sop_;
 
 #ifdef FSC_HAVE_DP
@@ -204,20 +204,55 @@ void DoVdmCommand(struct Port *port)
   }
 }
 
+/*  Queues one discovery request - DoVdmCommand sends it */
+static FSC_BOOL AutoVdmQueue(struct Port *port, FSC_U8 command, FSC_U16 svid,
+                             FSC_U8 pos, doDataObject_t *config)
+{
+  sopMainHeader_t header = {0};
+  doDataObject_t objects[2];
+
+  objects[0].object = 0;
+  objects[0].SVDM.SVID = svid;
+  objects[0].SVDM.VDMType = STRUCTURED_VDM;
+  objects[0].SVDM.ObjPos = pos;
+  objects[0].SVDM.CommandType = INITIATOR;
+  objects[0].SVDM.Command = command;
+
+  header.MessageType = DMTVendorDefined;
+  header.NumDataObjects = 1;
+  if (config != 0) {
+    objects[1].object = config->object;
+    header.NumDataObjects = 2;
+  }
+
+  return QueueRequest(port, SOP_TYPE_SOP, header, objects, QueuePriorityLow,
+                      port->vdm_auto_group_);
+}
+
 void AutoVdmDiscovery(struct Port *port)
 {
+#ifdef FSC_HAVE_DP
+  doDataObject_t config;
+#endif /* FSC_HAVE_DP */
+  FSC_U16 svid = 0;
+
+  /*  Each step is queued once the last one is answered, all under one
+   *  group so nothing else starts in between */
   if (port->pd_tx_status_ == txIdle)
   {
     switch (port->vdm_auto_state_)
     {
       case AUTO_VDM_INIT:
+        port->vdm_auto_group_ = QueueGroup(port);
+        /* Fall through */
       case AUTO_VDM_DISCOVER_ID_PP:
-        RequestDiscoverIdentity(port, SOP_TYPE_SOP);
-        port->vdm_auto_state_ = AUTO_VDM_DISCOVER_SVIDS_PP;
+        if (AutoVdmQueue(port, DISCOVER_IDENTITY, PD_SID, 0, 0)) {
+          port->vdm_auto_state_ = AUTO_VDM_DISCOVER_SVIDS_PP;
+        }
         break;
       case AUTO_VDM_DISCOVER_SVIDS_PP:
         if (port->svid_discvry_done_ == FALSE) {
-          RequestDiscoverSvids(port, SOP_TYPE_SOP);
+          AutoVdmQueue(port, DISCOVER_SVIDS, PD_SID, 0, 0);
         }
         else {
           port->vdm_auto_state_ = AUTO_VDM_DISCOVER_MODES_PP;
@@ -225,9 +260,10 @@ void AutoVdmDiscovery(struct Port *port)
         break;
       case AUTO_VDM_DISCOVER_MODES_PP:
         if (port->svid_discv_idx_ >= 0) {
-          RequestDiscoverModes(port, SOP_TYPE_SOP,
-              port->core_svid_info_.svids[port->svid_discv_idx_]);
-          port->vdm_auto_state_ = AUTO_VDM_ENTER_MODE_PP;
+          svid = port->core_svid_info_.svids[port->svid_discv_idx_];
+          if (AutoVdmQueue(port, DISCOVER_MODES, svid, 0, 0)) {
+            port->vdm_auto_state_ = AUTO_VDM_ENTER_MODE_PP;
+          }
         }
         else {
           /* No known SVIDs found */
@@ -236,22 +272,22 @@ void AutoVdmDiscovery(struct Port *port)
         break;
       case AUTO_VDM_ENTER_MODE_PP:
         if (port->auto_mode_entry_pos_ > 0) {
+          svid = port->core_svid_info_.svids[port->svid_discv_idx_];
 #ifdef FSC_HAVE_DP
-          if (port->core_svid_info_.svids[port->svid_discv_idx_] == DP_SID) {
-              if (port->display_port_data_.DpConfigured == TRUE) {
-                port->vdm_auto_state_ = AUTO_VDM_DONE;
-                break;
-              }
-              else {
-                port->vdm_auto_state_ = AUTO_VDM_DP_GET_STATUS;
-              }
-          } else {
+          if (svid == DP_SID &&
+              port->display_port_data_.DpConfigured == TRUE) {
             port->vdm_auto_state_ = AUTO_VDM_DONE;
+            break;
+          }
+#endif /* FSC_HAVE_DP */
+          if (!AutoVdmQueue(port, ENTER_MODE, svid,
+                            port->auto_mode_entry_pos_, 0)) {
+            break;
           }
+#ifdef FSC_HAVE_DP
+          port->vdm_auto_state_ = (svid == DP_SID) ?
+              AUTO_VDM_DP_GET_STATUS : AUTO_VDM_DONE;
 #endif /* FSC_HAVE_DP */
-          RequestEnterMode(port, SOP_TYPE_SOP,
-                          port->core_svid_info_.svids[port->svid_discv_idx_],
-                          port->auto_mode_entry_pos_);
         } else {
           port->vdm_auto_state_ = AUTO_VDM_DONE;
         }
@@ -259,8 +295,10 @@ void AutoVdmDiscovery(struct Port *port)
 #ifdef FSC_HAVE_DP
       case AUTO_VDM_DP_GET_STATUS:
         if (port->display_port_data_.DpModeEntered > 0) {
-          DP_RequestPartnerStatus(port);
-          port->vdm_auto_state_ = AUTO_VDM_DP_SET_CONFIG;
+          if (AutoVdmQueue(port, DP_COMMAND_STATUS, DP_SID,
+                           port->display_port_data_.DpModeEntered & 0x7, 0)) {
+            port->vdm_auto_state_ = AUTO_VDM_DP_SET_CONFIG;
+          }
         }
         else {
           port->vdm_auto_state_ = AUTO_VDM_DONE;
@@ -276,8 +314,12 @@ void AutoVdmDiscovery(struct Port *port)
         }
         else if (port->display_port_data_.DpCapMatched &&
             port->display_port_data_.DpPpStatus.Connection > 0) {
-          DP_RequestPartnerConfig(port, port->display_port_data_.DpPpConfig);
-          port->vdm_auto_state_ = AUTO_VDM_DONE;
+          config.object = port->display_port_data_.DpPpConfig.word;
+          if (AutoVdmQueue(port, DP_COMMAND_CONFIG, DP_SID,
+                           port->display_port_data_.DpModeEntered & 0x7,
+                           &config)) {
+            port->vdm_auto_state_ = AUTO_VDM_DONE;
+          }
         }
         else {
           port->vdm_auto_state_ = AUTO_VDM_DONE;
@@ -591,6 +633,15 @@ FSC_S32 ProcessDiscoverIdentity(struct Port *port, SopType sop, FSC_U32* arr_in,
     port->original_policy_state_ = port->policy_state_;
     if (sop == SOP_TYPE_SOP) {
       if (evalResponseToSopVdm(port, vdmh_in)) {
+        if (TemplateValid(port, TplDiscoverIdentity)) {
+          /*  Same ACK as last time - send it as encoded then */
+          set_policy_state(port, PE_RESP_VDM_Get_Identity);
+          set_policy_state(port, PE_RESP_VDM_Send_Identity);
+          SendVdmResponse(port, sop, 0,
+                          TemplateObjects(port, TplDiscoverIdentity),
+                          port->original_policy_state_, TplDiscoverIdentity);
+          return 0;
+        }
         id = VdmRequestIdentityInfo(port, sop);
       }
       set_policy_state(port, PE_RESP_VDM_Get_Identity);
@@ -651,7 +702,9 @@ FSC_S32 ProcessDiscoverIdentity(struct Port *port, SopType sop, FSC_U32* arr_in,
       }
     }
 
-    SendVdmMessage(port, sop, arr, length, port->original_policy_state_);
+    SendVdmResponse(port, sop, arr, length, port->original_policy_state_,
+                    (sop == SOP_TYPE_SOP && id.nack == FALSE) ?
+                    TplDiscoverIdentity : TplNone);
     return 0;
   }
   else {
@@ -762,6 +815,15 @@ FSC_S32 ProcessDiscoverSvids(struct Port *port, SopType sop, FSC_U32* arr_in,
     port->original_policy_state_ = port->policy_state_;
     if (sop == SOP_TYPE_SOP) {
       if (evalResponseToSopVdm(port, vdmh_in)) {
+        if (TemplateValid(port, TplDiscoverSvids)) {
+          /*  Same ACK as last time - send it as encoded then */
+          set_policy_state(port, PE_RESP_VDM_Get_SVIDs);
+          set_policy_state(port, PE_RESP_VDM_Send_SVIDs);
+          SendVdmResponse(port, sop, 0,
+                          TemplateObjects(port, TplDiscoverSvids),
+                          port->original_policy_state_, TplDiscoverSvids);
+          return 0;
+        }
         /*  assuming that the splitting of SVID info is done outside this block */
         svid_info = VdmRequestSvidInfo(port);
       }
@@ -811,7 +873,9 @@ FSC_S32 ProcessDiscoverSvids(struct Port *port, SopType sop, FSC_U32* arr_in,
         }
       }
     }
-    SendVdmMessage(port, sop, arr, length, port->original_policy_state_);
+    SendVdmResponse(port, sop, arr, length, port->original_policy_state_,
+                    (sop == SOP_TYPE_SOP && svid_info.nack == FALSE) ?
+                    TplDiscoverSvids : TplNone);
     return 0;
   }
   else {
@@ -875,6 +939,16 @@ FSC_S32 ProcessDiscoverModes(struct Port *port, SopType sop, FSC_U32 *arr_in,
     port->original_policy_state_ = port->policy_state_;
     if (sop == SOP_TYPE_SOP) {
       if (evalResponseToSopVdm(port, vdmh_in)) {
+        if (vdmh_in.SVDM.SVID == port->my_svid_ &&
+            TemplateValid(port, TplDiscoverModes)) {
+          /*  Same ACK as last time - send it as encoded then */
+          set_policy_state(port, PE_RESP_VDM_Get_Modes);
+          set_policy_state(port, PE_RESP_VDM_Send_Modes);
+          SendVdmResponse(port, sop, 0,
+                          TemplateObjects(port, TplDiscoverModes),
+                          port->original_policy_state_, TplDiscoverModes);
+          return 0;
+        }
         modes_info = VdmRequestModesInfo(port, vdmh_in.SVDM.SVID);
       }
       set_policy_state(port, PE_RESP_VDM_Get_Modes);
@@ -908,7 +982,10 @@ FSC_S32 ProcessDiscoverModes(struct Port *port, SopType sop, FSC_U32 *arr_in,
         length++;
       }
     }
-    SendVdmMessage(port, sop, arr, length, port->original_policy_state_);
+    /*  Only my_svid_ is ACKed */
+    SendVdmResponse(port, sop, arr, length, port->original_policy_state_,
+                    (sop == SOP_TYPE_SOP && modes_info.nack == FALSE) ?
+                    TplDiscoverModes : TplNone);
     return 0;
   }
   else {
@@ -1133,13 +1210,21 @@ FSC_S32 ProcessSvidSpecific(struct Port *port, SopType sop, FSC_U32 *arr_in,
 /*  Internal utility functions */
 void SendVdmMessage(struct Port *port, SopType sop, FSC_U32 *arr,
                     FSC_U32 length, PolicyState_t next_ps) {
+  SendVdmResponse(port, sop, arr, length, next_ps, TplNone);
+}
+
+void SendVdmResponse(struct Port *port, SopType sop, FSC_U32 *arr,
+                     FSC_U32 length, PolicyState_t next_ps, TxTemplateId tpl)
+{
   FSC_U32 i;
 
+  /*  Compose straight into the transmit frame (PolicyGiveVdm) */
+  for (i = 0; arr != 0 && i < length; i++) {
+    port->policy_tx_data_obj_[i].object = arr[i];
+  }
   port->vdm_msg_length_ = length;
   port->vdm_next_ps_ = next_ps;
-  for (i = 0; i < port->vdm_msg_length_; i++) {
-    port->vdm_msg_obj_[i].object = arr[i];
-  }
+  port->vdm_tx_template_ = tpl;
   port->vdm_msg_tx_sop_  = sop;
   port->vdm_sending_data_ = TRUE;
   TimerDisable(&port->vdm_timer_);
@@ -1532,48 +1617,49 @@ void VdmInitDpm(struct Port *port)
   port->my_svid_ = SVID_DEFAULT;
   port->my_mode_  = MODE_DEFAULT;
   port->mode_entered_ = FALSE;
+  TemplateInvalidate(port);
 }
 
 /*
  * VdmBitTranslator implementation
  * Functions that convert bits into internal header representations.
+ * The bit layouts are the codec's (pdcodec.h).
  */
 VdmType getVdmTypeOf(FSC_U32 in)
 {
-  UnstructuredVdmHeader vdm_header = getUnstructuredVdmHeader(in);
-  return vdm_header.vdm_type;
+  return (VdmType)PdVdmStructured(in);
 }
 
 UnstructuredVdmHeader getUnstructuredVdmHeader(FSC_U32 in)
 {
   UnstructuredVdmHeader ret;
-  ret.svid = (Svid)((in >> 16) & 0xFFFF);
-  ret.vdm_type = (VdmType)((in >> 15) & 0x1);
-  ret.info = (in >> 0) & 0x7FFF;
+  ret.svid = (Svid)PdVdmSvid(in);
+  ret.vdm_type = (VdmType)PdVdmStructured(in);
+  ret.info = PdVdmVendor(in);
   return ret;
 }
 
 StructuredVdmHeader getStructuredVdmHeader(FSC_U32 in)
 {
   StructuredVdmHeader ret;
-  ret.svid = (Svid)((in >> 16) & 0xFFFF);
-  ret.vdm_type = (VdmType)((in >> 15) & 0x1);
-  ret.svdm_version = (SvdmVersion)((in >> 13) & 0x3);
-  ret.obj_pos = (ObjPos)((in >> 8) & 0x7);
-  ret.cmd_type = (CmdType)((in >> 6) & 0x3);
-  ret.command = (Command)((in >> 0) & 0x1F);
+  ret.svid = (Svid)PdVdmSvid(in);
+  ret.vdm_type = (VdmType)PdVdmStructured(in);
+  ret.svdm_version = (SvdmVersion)PdVdmVersion(in);
+  ret.obj_pos = (ObjPos)PdVdmObjPos(in);
+  ret.cmd_type = (CmdType)PdVdmCmdType(in);
+  ret.command = (Command)PdVdmCommand(in);
   return ret;
 }
 
 IdHeader getIdHeader(FSC_U32 in)
 {
   IdHeader ret;
-  ret.usb_host_data_capable = (FSC_BOOL)((in >> 31) & 0x1);
-  ret.usb_device_data_capable = (FSC_BOOL)((in >> 30) & 0x1);
-  ret.product_type_ufp = (ProductType)((in >> 27) & 0x7);
-  ret.modal_op_supported = (FSC_BOOL)((in >> 26) & 0x1);
-  ret.product_type_dfp = (ProductType)((in >> 23));
-  ret.usb_vid = (FSC_U16)((in >> 0) & 0xFFFF);
+  ret.usb_host_data_capable = (FSC_BOOL)PdIdHost(in);
+  ret.usb_device_data_capable = (FSC_BOOL)PdIdDevice(in);
+  ret.product_type_ufp = (ProductType)PdIdProductUfp(in);
+  ret.modal_op_supported = (FSC_BOOL)PdIdModal(in);
+  ret.product_type_dfp = (ProductType)PdIdProductDfp(in);
+  ret.usb_vid = PdIdVid(in);
   return ret;
 }
 
@@ -0,0 +1,4 @@
+#!/bin/bash
+# usage: sz.sh <rev> <defines>
+rm -rf /tmp/sz/t && mkdir -p /tmp/sz/t && cd /root/repo && git archive $1 | tar -x -C /tmp/sz/t && cd /tmp/sz/t
+gcc -m32 -malign-double -ffreestanding -S -o - -std=gnu11 -DUSE_HAL_DRIVER -DPLATFORM_ARM -DSTM32L476xx -DDEBUG -IDrivers/CMSIS/Include -ICore/Inc -IDrivers/CMSIS/Device/ST/STM32L4xx/Include -IDrivers/STM32L4xx_HAL_Driver/Inc -IFusb307b/Inc $2 /tmp/sz/probe.c 2>/dev/null | grep -A2 "^port_size:" | grep long | awk '{print $2}'
@@ -0,0 +1,300 @@
+/*******************************************************************************
+ * @file     budget_sim.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * budget_sim.c
+ *
+ * Host simulation of the source power budget manager (budget.c) - three
+ * source ports on one supply, sinks that take 40ms to answer caps.
+ *
+ * Build and run from the top of the tree:
+ *
+ *   gcc -std=gnu11 -DUSE_HAL_DRIVER -DPLATFORM_ARM -DSTM32L476xx \
+ *       -DFSC_HAVE_SNK -DFSC_HAVE_SRC -DFSC_HAVE_MULTIPORT -DFSC_HAVE_BUDGET \
+ *       -IDrivers/CMSIS/Include -ICore/Inc \
+ *       -IDrivers/CMSIS/Device/ST/STM32L4xx/Include \
+ *       -IDrivers/STM32L4xx_HAL_Driver/Inc -IFusb307b/Inc \
+ *       tools/budget_sim.c Fusb307b/Src/budget.c -o budget_sim && ./budget_sim
+ *
+ * Each scenario prints the ports' targets, offers and contracts after each
+ * step (* - the sink flagged a capability mismatch), the most the contracts
+ * ever added up to, and the round counts and latencies from
+ * BudgetGetStats.  budget.c's queue calls are stubbed: a queued message is
+ * answered AMS_MS later.
+ */
+
+#include <stdio.h>
+
+#include "port.h"
+#include "budget.h"
+
+#define PORTS                   (3)
+#define AMS_MS                  (40)
+
+static struct Port Ports[PORTS];
+static FSC_U32 Now;                     /* us */
+
+/* What each sink wants, in mW, and whether it answers caps at all */
+static FSC_U32 Need[PORTS];
+static FSC_BOOL NonPd[PORTS];
+static FSC_BOOL GiveBack;
+
+/* Queued message and when it is answered */
+static FSC_BOOL Queued[PORTS];
+static FSC_U8 QueuedType[PORTS];
+static FSC_U32 Due[PORTS];
+
+static FSC_U32 Peak;
+
+FSC_U32 platform_current_time(void)
+{
+  return Now;
+}
+
+FSC_BOOL QueueRequest(struct Port *port, SopType sop, sopMainHeader_t header,
+                      doDataObject_t *objects, QueuePriority priority,
+                      FSC_U8 group)
+{
+  FSC_U8 i = port->port_id_ - 1;
+
+  Queued[i] = TRUE;
+  QueuedType[i] = header.MessageType;
+  Due[i] = Now + AMS_MS * 1000;
+
+  /* Caps go out straight away and wait on the sink */
+  if (header.NumDataObjects > 0) {
+    port->policy_state_ = PE_SRC_Send_Capabilities;
+    port->policy_subindex_ = 1;
+  }
+  return TRUE;
+}
+
+FSC_BOOL QueuePending(struct Port *port)
+{
+  return Queued[port->port_id_ - 1];
+}
+
+static doDataObject_t Fixed(FSC_U32 mv, FSC_U32 ma)
+{
+  doDataObject_t pdo;
+
+  pdo.object = 0;
+  pdo.FPDOSupply.SupplyType = pdoTypeFixed;
+  pdo.FPDOSupply.Voltage = mv / 50;
+  pdo.FPDOSupply.MaxCurrent = ma / 10;
+  return pdo;
+}
+
+/* The sink takes the highest power object, as much of it as it needs */
+static void Negotiate(struct Port *port)
+{
+  FSC_U8 i = port->port_id_ - 1;
+  FSC_U8 n = 0;
+  FSC_U8 best = 0;
+  FSC_U32 mw = 0;
+  FSC_U32 best_mw = 0;
+  FSC_U32 mv = 0;
+  FSC_U32 ma = 0;
+  FSC_U32 max = 0;
+
+  BudgetRestoreCaps(port);
+  BudgetApply(port);
+
+  if (NonPd[i]) {
+    /* Never answers - caps_counter_ runs out */
+    port->policy_state_ = PE_SRC_Disabled;
+    port->policy_has_contract_ = FALSE;
+    return;
+  }
+
+  for (n = 0; n < port->caps_header_source_.NumDataObjects; ++n) {
+    mw = port->caps_source_[n].FPDOSupply.Voltage * 50 *
+         port->caps_source_[n].FPDOSupply.MaxCurrent * 10 / 1000;
+    if (mw >= best_mw) {
+      best_mw = mw;
+      best = n;
+    }
+  }
+
+  mv = port->caps_source_[best].FPDOSupply.Voltage * 50;
+  max = port->caps_source_[best].FPDOSupply.MaxCurrent * 10;
+  ma = Need[i] * 1000 / mv;
+
+  port->usb_pd_contract_.object = 0;
+  port->usb_pd_contract_.FVRDO.ObjectPosition = best + 1;
+  port->usb_pd_contract_.FVRDO.CapabilityMismatch = (ma > max) ? 1 : 0;
+  ma = (ma > max) ? max : ma;
+  port->usb_pd_contract_.FVRDO.OpCurrent = ma / 10;
+  port->usb_pd_contract_.FVRDO.GiveBack = GiveBack;
+  port->usb_pd_contract_.FVRDO.MinMaxCurrent =
+      GiveBack ? ma / 30 : ma / 10;
+  port->policy_has_contract_ = TRUE;
+  port->policy_state_ = PE_SRC_Ready;
+  port->policy_subindex_ = 0;
+}
+
+static void Run(FSC_U32 ms)
+{
+  FSC_U32 sum = 0;
+  FSC_U8 i = 0;
+
+  while (ms--) {
+    Now += 1000;
+    for (i = 0; i < PORTS; ++i) {
+      if (Queued[i] && (FSC_S32)(Now - Due[i]) >= 0) {
+        Queued[i] = FALSE;
+        if (QueuedType[i] == CMTGotoMin) {
+          Ports[i].policy_state_ = PE_SRC_Ready;
+        }
+        else {
+          Negotiate(&Ports[i]);
+        }
+      }
+      BudgetService();
+
+      sum = BudgetUsed(&Ports[0]) + BudgetUsed(&Ports[1]) +
+            BudgetUsed(&Ports[2]);
+      Peak = (sum > Peak) ? sum : Peak;
+    }
+  }
+}
+
+static void Attach(FSC_U8 i, FSC_U32 need, FSC_BOOL non_pd)
+{
+  Need[i] = need;
+  NonPd[i] = non_pd;
+  Ports[i].tc_state_ = AttachedSource;
+  Ports[i].src_current_ = utcc3p0A;
+  Ports[i].policy_has_contract_ = FALSE;
+  Ports[i].usb_pd_contract_.object = 0;
+  Ports[i].policy_state_ = PE_SRC_Send_Capabilities;
+  Ports[i].policy_subindex_ = 0;
+  Negotiate(&Ports[i]);
+}
+
+static void Detach(FSC_U8 i)
+{
+  Ports[i].tc_state_ = Unattached;
+  Ports[i].policy_has_contract_ = FALSE;
+  Ports[i].usb_pd_contract_.object = 0;
+  Ports[i].policy_state_ = PE_SRC_Disabled;
+  Queued[i] = FALSE;
+}
+
+static void Show(const char *step)
+{
+  struct Port *port = 0;
+  FSC_U8 i = 0;
+
+  printf("  %-8s", step);
+  for (i = 0; i < PORTS; ++i) {
+    port = &Ports[i];
+    printf(" | P%u %5lu/%5lu/%5lu%s", i + 1,
+           (unsigned long)port->budget_target_mw_,
+           (unsigned long)port->budget_offer_mw_,
+           (unsigned long)BudgetUsed(port),
+           (port->policy_has_contract_ &&
+            port->usb_pd_contract_.FVRDO.CapabilityMismatch) ? "*" : " ");
+  }
+  printf("\n");
+}
+
+static void Reset(FSC_BOOL give_back)
+{
+  FSC_U8 i = 0;
+
+  GiveBack = give_back;
+  Peak = 0;
+  for (i = 0; i < PORTS; ++i) {
+    Ports[i].port_id_ = i + 1;
+    Ports[i].caps_header_source_.NumDataObjects = 4;
+    Ports[i].caps_source_[0] = Fixed(5000, 3000);
+    Ports[i].caps_source_[1] = Fixed(9000, 3000);
+    Ports[i].caps_source_[2] = Fixed(15000, 3000);
+    Ports[i].caps_source_[3] = Fixed(20000, 3000);
+    Queued[i] = FALSE;
+    Detach(i);
+    BudgetInit(&Ports[i]);
+  }
+  BudgetSetSupply(60000);
+  BudgetClearStats();
+  Run(5);
+}
+
+static void Report(void)
+{
+  const struct BudgetStats *stats = BudgetGetStats();
+
+  printf("  peak %lu mW, rounds %lu, converged %lu, timeouts %lu, "
+         "GotoMin %lu, caps %lu, latency avg %lu us max %lu us\n\n",
+         (unsigned long)Peak, (unsigned long)stats->rounds_,
+         (unsigned long)stats->converged_, (unsigned long)stats->timeouts_,
+         (unsigned long)stats->goto_mins_,
+         (unsigned long)stats->readvertised_,
+         (unsigned long)(stats->converged_ ?
+                         stats->latency_ / stats->converged_ : 0),
+         (unsigned long)stats->max_latency_);
+}
+
+static void Sequence(FSC_BOOL give_back)
+{
+  printf("%s (target/offer/used mW)\n",
+         give_back ? "GotoMin-capable sinks" : "Re-advertising only");
+  Reset(give_back);
+  Attach(0, 45000, FALSE);
+  Run(300);
+  Show("A");
+  Attach(1, 45000, FALSE);
+  Run(300);
+  Show("A+B");
+  Attach(2, 18000, FALSE);
+  Run(300);
+  Show("A+B+C");
+  Detach(0);
+  Run(300);
+  Show("B+C");
+  Report();
+}
+
+/* A sink that never answers caps next to one that flags a mismatch */
+static void NonPdNeighbour(void)
+{
+  printf("Non-PD sink next to a mismatched one, 10s each\n");
+  Reset(FALSE);
+  Attach(0, 45000, TRUE);
+  Run(300);
+  Attach(1, 80000, FALSE);
+  Run(10000);
+  Show("A+B");
+  Report();
+
+  Reset(FALSE);
+  Attach(1, 80000, FALSE);
+  Run(300);
+  Attach(0, 45000, TRUE);
+  Run(10000);
+  Show("B+A");
+  Report();
+}
+
+int main(void)
+{
+  Sequence(FALSE);
+  Sequence(TRUE);
+  NonPdNeighbour();
+  return 0;
+}
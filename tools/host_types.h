@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * @file     host_types.h
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * host_types.h
+ *
+ * FSCTypes.h for 64-bit hosts, where long is 8 bytes - force-include it
+ * (-include tools/host_types.h) ahead of the core sources so the frame
+ * layouts port.c checks hold.  Keep in step with Fusb307b/Inc/FSCTypes.h.
+ */
+#ifndef _FSCTYPES_H_
+#define _FSCTYPES_H_
+
+#if !defined(__PACKED)
+    #define __PACKED
+#endif
+
+#ifndef FSC_NUMBER_OF_PORTS
+#ifdef FSC_HAVE_MULTIPORT
+#define FSC_NUMBER_OF_PORTS 3
+#else
+#define FSC_NUMBER_OF_PORTS 1
+#endif /* FSC_HAVE_MULTIPORT */
+#endif /* FSC_NUMBER_OF_PORTS */
+
+typedef enum _BOOL { FALSE = 0, TRUE } FSC_BOOL;
+
+typedef signed char         FSC_S8;
+typedef signed short int    FSC_S16;
+typedef signed int          FSC_S32;
+typedef signed long long    FSC_S64;
+
+typedef unsigned char       FSC_U8;
+typedef unsigned short int  FSC_U16;
+typedef unsigned int        FSC_U32;
+typedef unsigned long long  FSC_U64;
+
+#endif /* _FSCTYPES_H_ */
@@ -0,0 +1,170 @@
+/*******************************************************************************
+ * @file     pdcodec_bench.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * pdcodec_bench.c
+ *
+ * Host check and microbenchmark of the PD message codec (pdcodec.c):
+ *  - the VDM header accessors against the struct-returning converter they
+ *    replaced in vdm.c (getStructuredVdmHeader, kept below), on 1M words
+ *  - reading all six VDM header fields both ways, ns per header
+ *  - PdDecode of a 3-PDO Source_Capabilities, ns per message
+ *
+ * Build and run from the top of the tree:
+ *
+ *   gcc -std=gnu11 -O2 -DUSE_HAL_DRIVER -DPLATFORM_ARM -DSTM32L476xx \
+ *       -DFSC_HAVE_VDM -IDrivers/CMSIS/Include -ICore/Inc \
+ *       -IDrivers/CMSIS/Device/ST/STM32L4xx/Include \
+ *       -IDrivers/STM32L4xx_HAL_Driver/Inc -IFusb307b/Inc \
+ *       tools/pdcodec_bench.c Fusb307b/Src/pdcodec.c -o pdcodec_bench && \
+ *       ./pdcodec_bench
+ *
+ * Host times only - the target's come from the DWT cycle counter.
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "pdcodec.h"
+#include "vdm_types.h"
+
+#define RUNS                    (50000000)
+
+/* The converter as it was in vdm.c */
+__attribute__((noinline))
+static StructuredVdmHeader getStructuredVdmHeader(FSC_U32 in)
+{
+  StructuredVdmHeader ret;
+  ret.svid = (Svid)((in >> 16) & 0xFFFF);
+  ret.vdm_type = (VdmType)((in >> 15) & 0x1);
+  ret.svdm_version = (SvdmVersion)((in >> 13) & 0x3);
+  ret.obj_pos = (ObjPos)((in >> 8) & 0x7);
+  ret.cmd_type = (CmdType)((in >> 6) & 0x3);
+  ret.command = (Command)((in >> 0) & 0x1F);
+  return ret;
+}
+
+static double Now(void)
+{
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static int Compare(void)
+{
+  StructuredVdmHeader old;
+  FSC_U32 word = 0;
+  FSC_U32 i = 0;
+
+  for (i = 0; i < 1000000; ++i) {
+    word = i * 2654435761u;
+    old = getStructuredVdmHeader(word);
+    if (old.svid != PdVdmSvid(word) ||
+        old.vdm_type != PdVdmStructured(word) ||
+        old.svdm_version != PdVdmVersion(word) ||
+        old.obj_pos != PdVdmObjPos(word) ||
+        old.cmd_type != PdVdmCmdType(word) ||
+        old.command != PdVdmCommand(word)) {
+      printf("mismatch at 0x%08lx\n", (unsigned long)word);
+      return 1;
+    }
+  }
+
+  printf("accessors match the converter on 1M words\n");
+  return 0;
+}
+
+static void Headers(void)
+{
+  volatile FSC_U32 sink = 0;
+  StructuredVdmHeader old;
+  FSC_U32 word = 0x12345678;
+  double start = 0;
+  int i = 0;
+
+  start = Now();
+  for (i = 0; i < RUNS; ++i) {
+    word = word * 1664525 + 1013904223;
+    old = getStructuredVdmHeader(word);
+    sink = old.svid + old.vdm_type + old.svdm_version + old.obj_pos +
+           old.cmd_type + old.command;
+  }
+  printf("VDM header, converter: %.2f ns\n", (Now() - start) / RUNS);
+
+  start = Now();
+  for (i = 0; i < RUNS; ++i) {
+    word = word * 1664525 + 1013904223;
+    sink = PdVdmSvid(word) + PdVdmStructured(word) + PdVdmVersion(word) +
+           PdVdmObjPos(word) + PdVdmCmdType(word) + PdVdmCommand(word);
+  }
+  printf("VDM header, accessors: %.2f ns\n", (Now() - start) / RUNS);
+
+  (void)sink;
+}
+
+static int Decode(void)
+{
+  /* 5V 3A fixed DRP, 9V 3A fixed, PPS 3.3-11V 3A */
+  const FSC_U32 caps[3] = {
+    (1UL << 29) | (100UL << 10) | 300,
+    (180UL << 10) | 300,
+    (3UL << 30) | (110UL << 17) | (33UL << 8) | 60
+  };
+  volatile FSC_U32 sink = 0;
+  struct PdMessage msg;
+  FSC_U8 frame[2 + 3 * 4];
+  FSC_U16 header = DMTSourceCapabilities | (2 << 6) | (3 << 12);
+  double start = 0;
+  int i = 0;
+  int b = 0;
+
+  frame[0] = header & 0xFF;
+  frame[1] = header >> 8;
+  for (i = 0; i < 3; ++i) {
+    for (b = 0; b < 4; ++b) {
+      frame[2 + i * 4 + b] = (caps[i] >> (8 * b)) & 0xFF;
+    }
+  }
+
+  if (PdDecode(frame, sizeof(frame), &msg) != PdCodecOK ||
+      msg.objects_ != 3 || msg.pdo_[2].kind_ != PdPdoPps ||
+      PdDecode(frame, sizeof(frame) - 4, &msg) != PdCodecShort) {
+    printf("PdDecode got the Source_Capabilities wrong\n");
+    return 1;
+  }
+
+  start = Now();
+  for (i = 0; i < RUNS / 10; ++i) {
+    sink += PdDecode(frame, sizeof(frame), &msg) + msg.pdo_[0].max_ma_;
+  }
+  printf("PdDecode, 3-PDO Source_Capabilities: %.2f ns\n",
+         (Now() - start) / (RUNS / 10));
+
+  return 0;
+}
+
+int main(void)
+{
+  if (Compare() || Decode()) {
+    return 1;
+  }
+
+  Headers();
+  return 0;
+}
@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+r"""
+Regenerates the .ramfunc hot set in STM32L476MGYX_FLASH.ld from a profile.
+
+The profile is a gprof flat profile of PC samples taken on the target, e.g.
+with OpenOCD while the board runs a representative attach/negotiate cycle.
+Profile a --clear build so that every function is sampled in flash:
+
+    openocd ... -c "init; profile 30 gmon.out 0x08000000 0x08100000; exit"
+    arm-none-eabi-gprof -p -b Debug/FUSB307B.elf gmon.out > profile.txt
+
+Function sizes come from the link map (Debug/FUSB307B.map), which needs
+-ffunction-sections so that every function has its own .text.<name> input
+section.  Functions are taken hottest first until --coverage of the samples
+is reached or the next one no longer fits in --budget bytes of SRAM2.
+
+    tools/ramfunc_hotset.py profile.txt Debug/FUSB307B.map
+    tools/ramfunc_hotset.py --clear     (flash-only baseline build)
+
+Without a board, tools/ramfunc_profile.c profiles the state machines on the
+host against a simulated TCPC and source.  Leave its own functions out with
+--exclude; the remaining samples are taken as 100%.  gprof puts some of a
+hot function's samples on its neighbour, which shows on functions that ran
+once - --min-calls drops those.  Functions the map doesn't have yet (added
+since it was linked) can be sized from the host build with --host-sizes:
+nm -S sizes scaled by the median map/host ratio of the functions both
+have.  Those sizes are marked ~ in the block.
+
+    tools/ramfunc_hotset.py --exclude '^(Sim|platform_)' --min-calls 2 \
+        --host-sizes host_sizes.txt tools/ramfunc_profile.txt Debug/FUSB307B.map
+
+Compare TaskPassStats pass_cycles_/pass_count_ (UART "<port> st 04")
+between the two builds for the per-pass gain.
+"""
+
+import argparse
+import re
+import sys
+
+LINKER_SCRIPT = 'STM32L476MGYX_FLASH.ld'
+BEGIN = '/* BEGIN ramfunc hot set */'
+END = '/* END ramfunc hot set */'
+
+# Run before .ramfunc is copied, or must not depend on it
+EXCLUDE = {'Reset_Handler', 'SystemInit', 'main', 'Default_Handler'}
+
+SECTION_RE = re.compile(r'^\s*\.text\.(\S+)\s*$')
+SECTION_LINE_RE = re.compile(
+    r'^\s*\.text\.(\S+)\s+0x[0-9a-fA-F]+\s+0x([0-9a-fA-F]+)\s')
+ADDR_LINE_RE = re.compile(r'^\s+0x[0-9a-fA-F]+\s+0x([0-9a-fA-F]+)\s')
+
+
+def read_profile(path, min_calls=0):
+    """Returns [(function, percent)] from a gprof flat profile."""
+    samples = []
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) < 4:
+                continue
+            try:
+                percent = float(fields[0])
+            except ValueError:
+                continue
+            # -pg builds count calls - too few and the samples are spill
+            # from the function's neighbours
+            if len(fields) == 7 and int(fields[3]) < min_calls:
+                continue
+            samples.append((fields[-1], percent))
+    return samples
+
+
+def read_sizes(path):
+    """Returns {function: bytes} from the .text.<name> input sections."""
+    sizes = {}
+    pending = None
+    with open(path) as f:
+        for line in f:
+            m = SECTION_LINE_RE.match(line)
+            if m:
+                sizes[m.group(1)] = sizes.get(m.group(1), 0) + \
+                    int(m.group(2), 16)
+                pending = None
+                continue
+            m = SECTION_RE.match(line)
+            if m:
+                # Long names wrap the address and size onto the next line
+                pending = m.group(1)
+                continue
+            m = ADDR_LINE_RE.match(line)
+            if m and pending:
+                sizes[pending] = sizes.get(pending, 0) + int(m.group(1), 16)
+            pending = None
+    return sizes
+
+
+def read_host_sizes(path, sizes):
+    """Returns {function: bytes} from nm -S output for the functions sizes
+    doesn't have, scaled to the target by the median ratio of those it
+    does."""
+    host = {}
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) == 4 and fields[2] in 'tT':
+                host[fields[3]] = int(fields[1], 16)
+    ratios = sorted(sizes[n] / host[n] for n in host
+                    if n in sizes and host[n] > 0)
+    if not ratios:
+        sys.exit('%s: no functions in common with the map' % path)
+    ratio = ratios[len(ratios) // 2]
+    return {n: int(host[n] * ratio) for n in host if n not in sizes}, ratio
+
+
+def select(samples, sizes, coverage, budget):
+    chosen = []
+    covered = 0.0
+    used = 0
+    for name, percent in sorted(samples, key=lambda s: -s[1]):
+        if covered >= coverage:
+            break
+        if name in EXCLUDE or name not in sizes:
+            continue
+        size = (sizes[name] + 3) & ~3
+        if used + size > budget:
+            continue
+        chosen.append((name, percent, sizes[name]))
+        covered += percent
+        used += size
+    return chosen, covered, used
+
+
+def rewrite(script, lines):
+    with open(script, newline='') as f:
+        text = f.read()
+    start = text.find(BEGIN)
+    stop = text.find(END)
+    if start < 0 or stop < start:
+        sys.exit('%s: hot set markers not found' % script)
+
+    indent = text[text.rfind('\n', 0, start) + 1:start]
+    eol = '\r\n' if '\r\n' in text else '\n'
+    block = BEGIN + eol + ''.join(indent + l + eol for l in lines) + indent
+    with open(script, 'w', newline='') as f:
+        f.write(text[:start] + block + text[stop:])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('profile', nargs='?', help='gprof flat profile')
+    parser.add_argument('map', nargs='?', help='linker map file')
+    parser.add_argument('--script', default=LINKER_SCRIPT)
+    parser.add_argument('--coverage', type=float, default=90.0,
+                        help='percent of samples to cover (default 90)')
+    parser.add_argument('--budget', type=int, default=16 * 1024,
+                        help='SRAM2 bytes for the hot set (default 16K)')
+    parser.add_argument('--clear', action='store_true',
+                        help='empty the hot set')
+    parser.add_argument('--exclude', action='append', default=[],
+                        metavar='REGEX',
+                        help='leave matching functions out of the profile')
+    parser.add_argument('--min-calls', type=int, default=0, metavar='N',
+                        help='leave out functions called fewer times '
+                             '(profiles with call counts)')
+    parser.add_argument('--host-sizes', metavar='NM',
+                        help='nm -S output to size functions the map lacks')
+    args = parser.parse_args()
+
+    if args.clear:
+        rewrite(args.script, ['/* Empty - flash-only baseline */'])
+        return
+
+    if not args.profile or not args.map:
+        parser.error('profile and map are required')
+
+    samples = read_profile(args.profile, args.min_calls)
+    if args.exclude:
+        exclude = re.compile('|'.join(args.exclude))
+        samples = [s for s in samples if not exclude.search(s[0])]
+        total = sum(s[1] for s in samples)
+        if total > 0:
+            samples = [(n, p * 100.0 / total) for n, p in samples]
+
+    sizes = read_sizes(args.map)
+    estimated = {}
+    if args.host_sizes:
+        estimated, ratio = read_host_sizes(args.host_sizes, sizes)
+        print('host sizes scaled by %.2f' % ratio)
+    chosen, covered, used = select(samples, dict(estimated, **sizes),
+                                   args.coverage, args.budget)
+
+    lines = ['/* %.1f%% of samples, %d bytes */' % (covered, used)]
+    for name, percent, size in chosen:
+        lines.append(('*(.text.%s)' % name).ljust(40) +
+                     '/* %5.1f%% %s%5d */' %
+                     (percent, '~' if name in estimated else ' ', size))
+    rewrite(args.script, lines)
+
+    print('%d functions, %.1f%% of samples, %d bytes' %
+          (len(chosen), covered, used))
+
+
+if __name__ == '__main__':
+    main()
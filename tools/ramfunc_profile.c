@@ -0,0 +1,910 @@
+/*******************************************************************************
+ * @file     ramfunc_profile.c
+ * @author   USB PD Firmware Team
+ *
+ * Copyright 2018 ON Semiconductor. All rights reserved.
+ *
+ * This software and/or documentation is licensed by ON Semiconductor under
+ * limited terms and conditions. The terms and conditions pertaining to the
+ * software and/or documentation are available at
+ * http://www.onsemi.com/site/pdf/ONSEMI_T&C.pdf
+ * ("ON Semiconductor Standard Terms and Conditions of Sale,
+ *   Section 8 Software").
+ *
+ * DO NOT USE THIS SOFTWARE AND/OR DOCUMENTATION UNLESS YOU HAVE CAREFULLY
+ * READ AND YOU AGREE TO THE LIMITED TERMS AND CONDITIONS. BY USING THIS
+ * SOFTWARE AND/OR DOCUMENTATION, YOU AGREE TO THE LIMITED TERMS AND CONDITIONS.
+ ******************************************************************************/
+/*
+ * ramfunc_profile.c
+ *
+ * Host profile of the port state machines for tools/ramfunc_hotset.py, when
+ * there is no board to sample.  One sink port, built with the Debug
+ * configuration's features, runs the main loop's scheduler against a
+ * simulated FUSB307B and PD 3.0 source:
+ *  - attach, caps (5/9/15/20V and a PPS APDO), Request/Accept/PS_RDY
+ *  - the source's Discover Identity/SVIDs/Modes, DisplayPort Enter Mode,
+ *    Status Update and Configure
+ *  - every few seconds one of: new caps, Get_Sink_Cap, Get_Status, a Soft
+ *    Reset, or the application switching between a PPS and a fixed supply
+ *    (core_set_sink_pps)
+ *  - detach after SESSION_MS, attach again after DETACHED_MS
+ * Time is simulated - I2C transfers take their 400kHz bus time and a pass
+ * PASS_US, idle time is skipped over - so the profile is the CPU's.
+ *
+ * Build and run from the top of the tree:
+ *
+ *   gcc -std=gnu11 -O0 -pg -include tools/host_types.h \
+ *       -DUSE_HAL_DRIVER -DPLATFORM_ARM -DSTM32L476xx -DFSC_HAVE_SNK \
+ *       -DFSC_HAVE_VDM -DFSC_HAVE_DP -DFSC_HAVE_LOWPOWER -DFSC_HAVE_UART \
+ *       -IDrivers/CMSIS/Include -ICore/Inc \
+ *       -IDrivers/CMSIS/Device/ST/STM32L4xx/Include \
+ *       -IDrivers/STM32L4xx_HAL_Driver/Inc -IFusb307b/Inc \
+ *       tools/ramfunc_profile.c \
+ *       $(ls Fusb307b/Src/[a-z]*.c | grep -v -e hostcomm -e systempolicy) \
+ *       -o ramfunc_profile && ./ramfunc_profile 2000
+ *   gprof -p -b ramfunc_profile gmon.out > tools/ramfunc_profile.txt
+ *   nm -S --defined-only ramfunc_profile > host_sizes.txt
+ *
+ * The argument is the number of attach sessions.  It prints the
+ * scheduler's TaskPassStats at the end, in host cycles.  The simulation's
+ * own functions (Sim*) and the platform_* stand-ins are in the profile
+ * too - leave them out with ramfunc_hotset.py --exclude '^(Sim|platform_)'.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <x86intrin.h>
+
+#include "port.h"
+#include "core.h"
+#include "task.h"
+#include "deadline.h"
+#include "local_platform.h"
+
+#define SESSION_MS              (20000)
+#define DETACHED_MS             (2000)
+#define EXERCISE_MS             (2500)
+#define PASS_US                 (5)     /* Loop overhead per pass */
+#define I2C_US(bytes)           (50 + 23 * (bytes))
+#define TRANSITION_US           (30000) /* Source's tSrcTransition */
+#define CAPS_RETRY_US           (150000)
+
+/* PD message types the source uses */
+#define MSG_ACCEPT              (3)
+#define MSG_REJECT              (4)
+#define MSG_PS_RDY              (6)
+#define MSG_GET_SOURCE_CAP      (7)
+#define MSG_GET_SINK_CAP        (8)
+#define MSG_SOFT_RESET          (13)
+#define MSG_NOT_SUPPORTED       (16)
+#define MSG_GET_STATUS          (18)
+#define MSG_SOURCE_CAPS         (1)
+#define MSG_REQUEST             (2)
+#define MSG_SINK_CAPS           (4)
+#define MSG_VDM                 (15)
+
+typedef enum {
+  EvNone = 0,
+  EvAttach,
+  EvConnect,                    /* TCPC reports the connection */
+  EvVbus,                       /* arg - mV */
+  EvCaps,
+  EvRx,                         /* Source frame on the wire */
+  EvTxDone,                     /* Sink frame done (GoodCRC or not) */
+  EvHardResetDone,
+  EvPsRdy,
+  EvExercise,
+  EvDetach,
+} EventType;
+
+struct Event {
+  EventType type_;
+  FSC_U64 at_;
+  FSC_U32 arg_;
+};
+
+struct Frame {
+  FSC_U16 header_;
+  FSC_U32 obj_[7];
+};
+
+static struct Port Port;
+static struct PortTask Task;
+
+static FSC_U64 Now;                     /* us */
+static FSC_U8 Reg[256];
+static FSC_BOOL Line;
+
+static struct Event Events[32];
+static FSC_U64 NextAt;                  /* No event due before */
+
+/* Deadline timer and the WakeOnTimer compare */
+static FSC_BOOL DeadlineOn;
+static FSC_BOOL DeadlineIrq = TRUE;
+static FSC_U64 DeadlineAt;
+static FSC_BOOL WakeOn;
+static FSC_U64 WakeAt;
+
+/* Source side */
+static FSC_BOOL Attached;
+static FSC_U8 MsgId;
+static FSC_U32 Caps[7];
+static FSC_U8 NumCaps;
+static FSC_BOOL Busy;                   /* Waiting on the sink's answer */
+static FSC_U8 Vdm;                      /* Next step of the VDM script */
+static FSC_U8 Exercise;
+static FSC_U32 Vbus;                    /* mV */
+
+/* Frames from the source the TCPC hasn't handed over yet */
+static struct Frame RxQueue[4];
+static FSC_U8 RxHead;
+static FSC_U8 RxCount;
+static struct Frame Wire;               /* Source frame being sent */
+static FSC_BOOL WireBusy;
+static struct Frame SinkTx;             /* Sink frame being sent */
+static FSC_BOOL SinkTxBusy;
+static FSC_BOOL SinkTxDiscarded;
+
+static FSC_BOOL Verbose;
+
+static struct {
+  FSC_U32 sessions_;
+  FSC_U32 contracts_;
+  FSC_U32 requests_;
+  FSC_U32 hard_resets_;
+  FSC_U32 soft_resets_;
+  FSC_U32 vdms_;
+  FSC_U32 discards_;
+  FSC_U32 caps_retries_;
+} Count;
+
+static void SimSchedule(EventType type, FSC_U64 delay, FSC_U32 arg)
+{
+  FSC_U8 i = 0;
+
+  for (i = 0; i < sizeof(Events) / sizeof(Events[0]); ++i) {
+    if (Events[i].type_ == EvNone) {
+      Events[i].type_ = type;
+      Events[i].at_ = Now + delay;
+      Events[i].arg_ = arg;
+      if (Events[i].at_ < NextAt) {
+        NextAt = Events[i].at_;
+      }
+      return;
+    }
+  }
+
+  fprintf(stderr, "event list full\n");
+  exit(1);
+}
+
+static void SimCancel(EventType type)
+{
+  FSC_U8 i = 0;
+
+  for (i = 0; i < sizeof(Events) / sizeof(Events[0]); ++i) {
+    if (Events[i].type_ == type) {
+      Events[i].type_ = EvNone;
+    }
+  }
+}
+
+/* The ALERT line - any unmasked alert.  Edges go to the scheduler as the
+ * EXTI callback would send them. */
+static void SimUpdateLine(void)
+{
+  FSC_BOOL level = ((Reg[regALERTL] & Reg[regALERTMSKL]) ||
+                    (Reg[regALERTH] & Reg[regALERTMSKH])) ? TRUE : FALSE;
+
+  if (level && !Line) {
+    TaskAlert(1);
+  }
+  Line = level;
+}
+
+static void SimSetVbus(FSC_U32 mv)
+{
+  FSC_U32 disc = (Reg[regVBUS_SNK_DISCL] |
+                  ((FSC_U32)Reg[regVBUS_SNK_DISCH] << 8)) * 25;
+  FSC_U32 alarm = (Reg[regVALARMHCFGL] |
+                   ((FSC_U32)Reg[regVALARMHCFGH] << 8)) * 25;
+
+  if (mv < disc && Vbus >= disc) {
+    Reg[regALERTH] |= MSK_I_VBUS_SNK_DISC;
+  }
+  if (alarm > 0 && mv > alarm && Vbus <= alarm) {
+    Reg[regALERTL] |= MSK_I_VBUS_ALRM_HI;
+  }
+  if ((mv > 4000) != (Vbus > 4000)) {
+    Reg[regALERTL] |= MSK_I_PORT_PWR;
+  }
+
+  Vbus = mv;
+  Reg[regVBUS_VOLTAGE_L] = (mv / 25) & 0xFF;
+  Reg[regVBUS_VOLTAGE_H] = ((mv / 25) >> 8) & 0x03;
+  Reg[regPWRSTAT] = (Reg[regPWRSTAT] & ~0x04) | ((mv > 4000) ? 0x04 : 0);
+  SimUpdateLine();
+}
+
+/* Hand the TCPC's next received frame to the RX registers */
+static void SimLoadRx(void)
+{
+  struct Frame *frame = 0;
+  FSC_U8 objs = 0;
+  FSC_U8 i = 0;
+
+  if (RxCount == 0 || (Reg[regALERTL] & MSK_I_RXSTAT)) {
+    return;
+  }
+
+  frame = &RxQueue[RxHead];
+  RxHead = (RxHead + 1) % 4;
+  RxCount--;
+
+  objs = (frame->header_ >> 12) & 0x7;
+  Reg[regRXBYTECNT] = 3 + 4 * objs;
+  Reg[regRXSTAT] = 0;
+  Reg[regRXHEADL] = frame->header_ & 0xFF;
+  Reg[regRXHEADH] = frame->header_ >> 8;
+  for (i = 0; i < objs; ++i) {
+    memcpy(&Reg[regRXDATA_00 + 4 * i], &frame->obj_[i], 4);
+  }
+
+  Reg[regALERTL] |= MSK_I_RXSTAT;
+  SimUpdateLine();
+}
+
+/* Source side transmit - on the wire about a millisecond */
+static void SimSend(FSC_U8 type, FSC_U8 objs, const FSC_U32 *data)
+{
+  if (WireBusy) {
+    /* One at a time - the script never needs more */
+    return;
+  }
+
+  Wire.header_ = type | (1 << 5) | (2 << 6) | (1 << 8) |
+                 ((MsgId & 0x7) << 9) | ((objs & 0x7) << 12);
+  if (objs > 0) {
+    memcpy(Wire.obj_, data, 4 * objs);
+  }
+  WireBusy = TRUE;
+  SimSchedule(EvRx, 1000 + 100 * objs, 0);
+}
+
+static void SimSendCaps(FSC_BOOL all)
+{
+  /* Fixed 5V/3A (USB comms, unconstrained), 9V/3A, 15V/3A, 20V/2.25A and
+   * a 3.3-11V/3A PPS APDO - or without the 20V object */
+  Caps[0] = (1 << 26) | (1 << 27) | (100 << 10) | 300;
+  Caps[1] = (180 << 10) | 300;
+  Caps[2] = (300 << 10) | 300;
+  if (all) {
+    Caps[3] = (400 << 10) | 225;
+    Caps[4] = (3u << 30) | (110 << 17) | (33 << 8) | 60;
+    NumCaps = 5;
+  }
+  else {
+    Caps[3] = (3u << 30) | (110 << 17) | (33 << 8) | 60;
+    NumCaps = 4;
+  }
+  SimSend(MSG_SOURCE_CAPS, NumCaps, Caps);
+  Busy = TRUE;
+}
+
+static void SimSendVdm(FSC_U32 header, FSC_U32 data)
+{
+  FSC_U32 objs[2];
+
+  /* Structured, version 2.0, REQ */
+  objs[0] = header | (1 << 15) | (1 << 13);
+  objs[1] = data;
+  SimSend(MSG_VDM, data ? 2 : 1, objs);
+  Busy = TRUE;
+  Count.vdms_++;
+}
+
+/* The source's half of the DisplayPort discovery, one step per answer */
+static void SimNextVdm(void)
+{
+  switch (Vdm++) {
+    case 0: SimSendVdm(0xFF000000 | 1, 0); break;               /* Identity */
+    case 1: SimSendVdm(0xFF000000 | 2, 0); break;               /* SVIDs */
+    case 2: SimSendVdm(0xFF010000 | 3, 0); break;               /* Modes */
+    case 3: SimSendVdm(0xFF010000 | (1 << 8) | 4, 0); break;    /* Enter */
+    case 4: SimSendVdm(0xFF010000 | (1 << 8) | 16, 0x1); break; /* Status */
+    case 5: SimSendVdm(0xFF010000 | (1 << 8) | 17,              /* Configure */
+                    (0x04 << 8) | (1 << 2) | 0x1); break;
+    default: Vdm = 6; break;
+  }
+}
+
+/* What the source makes of a frame from the sink */
+static void SimReceive(const struct Frame *frame)
+{
+  FSC_U8 type = frame->header_ & 0x1F;
+  FSC_U8 objs = (frame->header_ >> 12) & 0x7;
+  FSC_U8 pos = 0;
+  FSC_U32 mv = 0;
+
+  if (frame->header_ & 0x8000) {
+    /* Status and the like - an answer, nothing more to do */
+    Busy = FALSE;
+    return;
+  }
+
+  if (objs > 0) {
+    switch (type) {
+      case MSG_REQUEST:
+        Count.requests_++;
+        pos = (frame->obj_[0] >> 28) & 0x7;
+        if (pos == 0 || pos > NumCaps) {
+          SimSend(MSG_REJECT, 0, 0);
+          Busy = FALSE;
+          break;
+        }
+        if ((Caps[pos - 1] >> 30) == 3) {
+          mv = ((frame->obj_[0] >> 9) & 0x7FF) * 20;
+        }
+        else {
+          mv = ((Caps[pos - 1] >> 10) & 0x3FF) * 50;
+        }
+        SimSend(MSG_ACCEPT, 0, 0);
+        Busy = TRUE;
+        SimSchedule(EvVbus, TRANSITION_US, mv);
+        SimSchedule(EvPsRdy, TRANSITION_US + 5000, 0);
+        break;
+      case MSG_SINK_CAPS:
+        Busy = FALSE;
+        break;
+      case MSG_VDM:
+        /* The sink's answer - on to the next step */
+        Busy = FALSE;
+        if (Vdm < 6) {
+          SimNextVdm();
+        }
+        break;
+      default:
+        /* Status, Alert and the like - nothing to answer */
+        Busy = FALSE;
+        break;
+    }
+    return;
+  }
+
+  switch (type) {
+    case MSG_GET_SOURCE_CAP:
+      SimSendCaps(NumCaps != 4);
+      break;
+    case MSG_SOFT_RESET:
+      MsgId = 0;
+      SimSend(MSG_ACCEPT, 0, 0);
+      SimSchedule(EvCaps, 20000, 0);
+      break;
+    case MSG_ACCEPT:
+      if ((Wire.header_ & 0x701F) == MSG_SOFT_RESET) {
+        /* Our Soft_Reset - caps follow */
+        SimSchedule(EvCaps, 5000, 0);
+      }
+      break;
+    case MSG_REJECT:
+    case MSG_NOT_SUPPORTED:
+    case MSG_PS_RDY:
+      Busy = FALSE;
+      if (Vdm < 6) {
+        SimNextVdm();
+      }
+      break;
+    case MSG_GET_SINK_CAP:
+    case 9:  /* DR_Swap */
+    case 10: /* PR_Swap */
+    case 11: /* VCONN_Swap */
+      SimSend(MSG_REJECT, 0, 0);
+      break;
+    default:
+      SimSend(MSG_NOT_SUPPORTED, 0, 0);
+      break;
+  }
+}
+
+/* A TRANSMIT (or enabled SINK_TRANSMIT) write */
+static void SimTransmit(FSC_U8 sop)
+{
+  FSC_U8 objs = 0;
+
+  if (sop == TRANSMIT_HARDRESET || sop == TRANSMIT_CABLERESET) {
+    SimSchedule(EvHardResetDone, 4000, sop);
+    return;
+  }
+
+  if (sop != 0) {
+    /* No cable marker - no GoodCRC after the retries */
+    SinkTxBusy = TRUE;
+    SinkTxDiscarded = FALSE;
+    SinkTx.header_ = 0;
+    SimSchedule(EvTxDone, 4000, 1);
+    return;
+  }
+
+  if ((Reg[regALERTL] & MSK_I_RXSTAT) || RxCount > 0 || WireBusy) {
+    /* The source got in first */
+    Reg[regALERTL] |= MSK_I_TXDISC;
+    Count.discards_++;
+    SimUpdateLine();
+    return;
+  }
+
+  SinkTx.header_ = Reg[regTXHEADL] | (Reg[regTXHEADH] << 8);
+  objs = (SinkTx.header_ >> 12) & 0x7;
+  memcpy(SinkTx.obj_, &Reg[regTXDATA_00], 4 * objs);
+  SinkTxBusy = TRUE;
+  SinkTxDiscarded = FALSE;
+  SimSchedule(EvTxDone, 1000 + 100 * objs, 0);
+}
+
+static void SimDetach(void)
+{
+  Attached = FALSE;
+  Busy = FALSE;
+  WireBusy = FALSE;
+  RxCount = 0;
+  SimCancel(EvCaps);
+  SimCancel(EvRx);
+  SimCancel(EvPsRdy);
+  SimCancel(EvExercise);
+  SimCancel(EvVbus);
+  Reg[regCCSTAT] &= 0x20;
+  Reg[regALERTL] |= MSK_I_CCSTAT;
+  SimUpdateLine();
+  SimSetVbus(0);
+}
+
+static void SimProcess(struct Event *ev)
+{
+  EventType type = ev->type_;
+  FSC_U32 arg = ev->arg_;
+
+  ev->type_ = EvNone;
+
+  switch (type) {
+    case EvAttach:
+      Attached = TRUE;
+      MsgId = 0;
+      Vdm = 0;
+      Count.sessions_++;
+      if (Reg[regCCSTAT] & 0x20) {
+        SimSchedule(EvConnect, 1000, 0);
+      }
+      SimSchedule(EvVbus, 120000, 5000);
+      SimSchedule(EvCaps, 300000, 0);
+      SimSchedule(EvExercise, 3000000, 0);
+      SimSchedule(EvDetach, SESSION_MS * 1000ULL, 0);
+      break;
+    case EvConnect:
+      if (Attached) {
+        /* Rp 3.0A on CC1, connected as a sink */
+        Reg[regCCSTAT] = 0x03 | 0x10;
+        Reg[regALERTL] |= MSK_I_CCSTAT;
+        SimUpdateLine();
+      }
+      break;
+    case EvVbus:
+      SimSetVbus(arg);
+      break;
+    case EvCaps:
+      SimSendCaps(Exercise % 2 == 0);
+      break;
+    case EvRx:
+      WireBusy = FALSE;
+      if (!Attached) {
+        break;
+      }
+      if (!(Reg[regRXDETECT] & 0x01)) {
+        /* Not listening - no GoodCRC */
+        Busy = FALSE;
+        if ((Wire.header_ & 0x701F) == (MSG_SOURCE_CAPS | (NumCaps << 12))) {
+          Count.caps_retries_++;
+          SimSchedule(EvCaps, CAPS_RETRY_US, 0);
+        }
+        break;
+      }
+      if (SinkTxBusy) {
+        SinkTxDiscarded = TRUE;
+      }
+      MsgId++;
+      if (RxCount < 4) {
+        RxQueue[(RxHead + RxCount) % 4] = Wire;
+        RxCount++;
+      }
+      SimLoadRx();
+      break;
+    case EvTxDone:
+      SinkTxBusy = FALSE;
+      if (arg) {
+        Reg[regALERTL] |= MSK_I_TXFAIL;
+      }
+      else if (SinkTxDiscarded) {
+        Reg[regALERTL] |= MSK_I_TXDISC;
+        Count.discards_++;
+      }
+      else {
+        Reg[regALERTL] |= MSK_I_TXSUCC;
+        SimReceive(&SinkTx);
+      }
+      SimUpdateLine();
+      break;
+    case EvHardResetDone:
+      Reg[regALERTL] |= MSK_I_TXSUCC | MSK_I_TXFAIL;
+      SimUpdateLine();
+      if (arg == TRANSMIT_HARDRESET && Attached) {
+        /* The source goes back to vSafe5V by way of vSafe0V */
+        Count.hard_resets_++;
+        MsgId = 0;
+        Busy = FALSE;
+        SimCancel(EvCaps);
+        SimCancel(EvPsRdy);
+        SimCancel(EvVbus);
+        SimSchedule(EvVbus, 25000, 0);
+        SimSchedule(EvVbus, 700000, 5000);
+        SimSchedule(EvCaps, 800000, 0);
+      }
+      break;
+    case EvPsRdy:
+      Count.contracts_++;
+      SimSend(MSG_PS_RDY, 0, 0);
+      Busy = FALSE;
+      break;
+    case EvExercise:
+      if (!Attached) {
+        break;
+      }
+      if (arg) {
+        /* Give up on an answer that didn't come */
+        Busy = FALSE;
+        break;
+      }
+      if (Busy || WireBusy || SinkTxBusy) {
+        SimSchedule(EvExercise, 100000, 0);
+        break;
+      }
+      if (Vdm < 6) {
+        SimNextVdm();
+        SimSchedule(EvExercise, EXERCISE_MS * 1000ULL, 0);
+      }
+      else {
+        switch (Exercise++ % 6) {
+          case 0: SimSendCaps(FALSE); break;
+          case 1: SimSend(MSG_GET_SINK_CAP, 0, 0); Busy = TRUE; break;
+          case 2: core_set_sink_pps(&Port, 9000, 2000); break;
+          case 3: SimSend(MSG_GET_STATUS, 0, 0); Busy = TRUE; break;
+          case 4: core_set_sink_pps(&Port, 0, 0); SimSendCaps(TRUE); break;
+          case 5:
+            Count.soft_resets_++;
+            MsgId = 0;
+            SimSend(MSG_SOFT_RESET, 0, 0);
+            Busy = TRUE;
+            break;
+        }
+        SimSchedule(EvExercise, EXERCISE_MS * 1000ULL, 0);
+      }
+      if (Busy) {
+        SimSchedule(EvExercise, 500000, 1);
+      }
+      break;
+    case EvDetach:
+      SimDetach();
+      SimSchedule(EvAttach, DETACHED_MS * 1000ULL, 0);
+      break;
+    default:
+      break;
+  }
+}
+
+static struct Event *SimNextEvent(void)
+{
+  struct Event *next = 0;
+  FSC_U8 i = 0;
+
+  for (i = 0; i < sizeof(Events) / sizeof(Events[0]); ++i) {
+    if (Events[i].type_ != EvNone && (next == 0 || Events[i].at_ < next->at_)) {
+      next = &Events[i];
+    }
+  }
+  return next;
+}
+
+/* Move time on, running whatever falls due - the interrupts included */
+static void SimAdvance(FSC_U64 us)
+{
+  struct Event *ev = 0;
+  FSC_U64 end = Now + us;
+
+  while (NextAt <= end) {
+    ev = SimNextEvent();
+    if (ev == 0 || ev->at_ > end) {
+      NextAt = ev ? ev->at_ : ~0ULL;
+      break;
+    }
+    if (ev->at_ > Now) {
+      Now = ev->at_;
+    }
+    SimProcess(ev);
+  }
+  Now = end;
+
+  if (DeadlineOn && DeadlineIrq && Now >= DeadlineAt) {
+    DeadlineOn = FALSE;
+    DeadlineService();
+  }
+  if (WakeOn && Now >= WakeAt) {
+    WakeOn = FALSE;
+    TaskWake(&Task);
+  }
+}
+
+/* Platform stand-ins */
+FSC_BOOL platform_i2c_write(FSC_U8 Bus, FSC_U8 SlaveAddress,
+                            FSC_U8 RegisterAddress, FSC_U8 DataLength,
+                            FSC_U8 *Data)
+{
+  FSC_U8 i = 0;
+  FSC_U8 reg = 0;
+  FSC_BOOL rx_cleared = FALSE;
+
+  SimAdvance(I2C_US(2 + DataLength));
+
+  for (i = 0; i < DataLength; ++i) {
+    reg = RegisterAddress + i;
+    switch (reg) {
+      case regALERTL:
+        rx_cleared = (Reg[reg] & Data[i] & MSK_I_RXSTAT) ? TRUE : FALSE;
+        Reg[reg] &= ~Data[i];
+        break;
+      case regALERTH:
+      case regFAULTSTAT:
+      case regALERT_VD:
+        Reg[reg] &= ~Data[i];
+        break;
+      case regCOMMAND:
+        if (Data[i] == Look4Con) {
+          Reg[regCCSTAT] = 0x20;
+          if (Attached) {
+            SimSchedule(EvConnect, 2000, 0);
+          }
+        }
+        break;
+      case regTRANSMIT:
+        SimTransmit(Data[i] & 0x07);
+        break;
+      case regSINK_TRANSMIT:
+        Reg[reg] = Data[i];
+        if (!(Data[i] & 0x40)) {
+          SimTransmit(Data[i] & 0x07);
+        }
+        break;
+      default:
+        Reg[reg] = Data[i];
+        break;
+    }
+  }
+
+  if (rx_cleared) {
+    SimLoadRx();
+  }
+  SimUpdateLine();
+  return TRUE;
+}
+
+FSC_BOOL platform_i2c_read(FSC_U8 Bus, FSC_U8 SlaveAddress,
+                           FSC_U8 RegisterAddress, FSC_U8 DataLength,
+                           FSC_U8 *Data)
+{
+  SimAdvance(I2C_US(3 + DataLength));
+  memcpy(Data, &Reg[RegisterAddress], DataLength);
+  return TRUE;
+}
+
+FSC_BOOL platform_i2c_block_read(FSC_U8 Bus, FSC_U8 SlaveAddress,
+                                 FSC_U8 RegisterAddress, FSC_U8 MaxLength,
+                                 FSC_U8 *Data)
+{
+  FSC_U8 length = Reg[RegisterAddress] + 1;
+
+  if (length > MaxLength) {
+    length = MaxLength;
+  }
+  SimAdvance(I2C_US(3 + length));
+  memcpy(Data, &Reg[RegisterAddress], length);
+  return TRUE;
+}
+
+FSC_BOOL platform_i2c_busy(FSC_U8 Bus)
+{
+  return FALSE;
+}
+
+FSC_BOOL platform_get_device_irq_state(FSC_U8 port)
+{
+  return Line;
+}
+
+FSC_U8 platform_get_alert_line(FSC_U8 port)
+{
+  return 1;
+}
+
+FSC_U32 platform_current_time(void)
+{
+  return (FSC_U32)Now;
+}
+
+FSC_U32 platform_cycle_count(void)
+{
+  return (FSC_U32)__rdtsc();
+}
+
+void platform_delay(FSC_U32 microseconds)
+{
+  SimAdvance(microseconds);
+}
+
+void platform_set_deadline_timer(FSC_U32 microseconds)
+{
+  DeadlineOn = TRUE;
+  DeadlineAt = Now + microseconds;
+}
+
+void platform_clear_deadline_timer(void)
+{
+  DeadlineOn = FALSE;
+}
+
+void platform_enable_deadline_irq(FSC_BOOL enable)
+{
+  DeadlineIrq = enable;
+}
+
+void platform_printf(FSC_U8 port, const char *str, FSC_S32 value)
+{
+  if (Verbose) {
+    printf("%10llu %s", (unsigned long long)Now, str);
+  }
+}
+
+void platform_setHVSwitch(FSC_BOOL enable)
+{
+}
+
+void platform_setPPSVoltage(FSC_U8 port, FSC_U32 mv)
+{
+}
+
+FSC_BOOL platform_dp_enable_pins(FSC_BOOL enable, FSC_U32 config)
+{
+  return TRUE;
+}
+
+void platform_dp_status_update(FSC_U32 status)
+{
+}
+
+const LowPowerStats_t *platform_GetLowPowerStats(void)
+{
+  static LowPowerStats_t stats;
+  return &stats;
+}
+
+ClockMode_t platform_GetClockMode(void)
+{
+  return ClockFull;
+}
+
+const ClockStats_t *platform_GetClockStats(void)
+{
+  static ClockStats_t stats;
+  return &stats;
+}
+
+/* main.c's WakeOnTimer, against the simulated compare */
+static void SimWakeOnTimer(void)
+{
+  FSC_U32 timeout = core_get_next_timeout(&Port);
+
+  if (timeout == 1) {
+    Port.idle_ = FALSE;
+  }
+  else if (timeout > 1) {
+    WakeOn = TRUE;
+    WakeAt = Now + timeout;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  FSC_U32 sessions = (argc > 1) ? (FSC_U32)atoi(argv[1]) : 200;
+  const struct TaskPassStats *stats = TaskGetPassStats();
+  FSC_U32 last_pass = 0;
+  FSC_U32 last_run = 0;
+  FSC_U64 pass_cycles = 0;
+  FSC_U64 run_cycles = 0;
+  struct Event *ev = 0;
+  FSC_U64 next = 0;
+  FSC_BOOL check_idle = FALSE;
+
+  Verbose = (argc > 2) ? TRUE : FALSE;
+
+  /* Reset values - all alerts masked in */
+  Reg[regALERTMSKL] = 0xFF;
+  Reg[regALERTMSKH] = 0x8F;
+  Reg[regCCSTAT] = 0x20;
+
+  InitializeVars(&Port, 1, 0, 0x50);
+  TaskInitialize(&Task, &Port);
+  SimSchedule(EvAttach, 1000000, 0);
+
+  while (Count.sessions_ <= sessions) {
+    TaskPassStart();
+    TaskScanAlerts();
+    if (TaskReady(&Task)) {
+      if (Task.state_ == TaskRunning) {
+        WakeOn = FALSE;
+      }
+      if (TaskRun(&Task)) {
+        check_idle = TRUE;
+      }
+    }
+    TaskPassEnd();
+
+    /* The 32-bit totals wrap on long runs */
+    pass_cycles += (FSC_U32)(stats->pass_cycles_ - last_pass);
+    last_pass = stats->pass_cycles_;
+    run_cycles += (FSC_U32)(Task.run_cycles_ - last_run);
+    last_run = Task.run_cycles_;
+
+    if (check_idle) {
+      SimWakeOnTimer();
+      check_idle = FALSE;
+    }
+
+    SimAdvance(PASS_US);
+
+    /* Tickless idle - on to the next event, alert or timer */
+    if (!TaskReady(&Task) && !Line) {
+      next = ~0ULL;
+      ev = SimNextEvent();
+      if (ev != 0) {
+        next = ev->at_;
+      }
+      if (WakeOn && WakeAt < next) {
+        next = WakeAt;
+      }
+      if (DeadlineOn && DeadlineAt < next) {
+        next = DeadlineAt;
+      }
+      if (next != ~0ULL && next > Now) {
+        SimAdvance(next - Now);
+      }
+    }
+  }
+
+  printf("%lu sessions, %lu s simulated\n",
+         (unsigned long)Count.sessions_ - 1, (unsigned long)(Now / 1000000));
+  printf("source: %lu requests, %lu contracts, %lu VDMs, %lu soft resets, "
+         "%lu hard resets, %lu caps retries, %lu discarded\n",
+         (unsigned long)Count.requests_, (unsigned long)Count.contracts_,
+         (unsigned long)Count.vdms_, (unsigned long)Count.soft_resets_,
+         (unsigned long)Count.hard_resets_,
+         (unsigned long)Count.caps_retries_, (unsigned long)Count.discards_);
+  printf("passes: %lu, %lu cycles/pass, max %lu\n",
+         (unsigned long)stats->pass_count_,
+         (unsigned long)(pass_cycles / stats->pass_count_),
+         (unsigned long)stats->max_pass_cycles_);
+  printf("state machine: %lu runs, %lu cycles/run, max %lu\n",
+         (unsigned long)Task.run_count_,
+         (unsigned long)(run_cycles /
+                         (Task.run_count_ ? Task.run_count_ : 1)),
+         (unsigned long)Task.max_run_cycles_);
+
+  return 0;
+}